@@ -134,7 +134,11 @@ typedef enum {
     /* Note: if you're hunting for a flag, some day in the future when we
      * have used them all, this one is easy enough to eliminate by having the
      * tiny number of objects marked this way in a remembered set. */
-    MVM_CF_NEVER_REPOSSESS = 2048
+    MVM_CF_NEVER_REPOSSESS = 2048,
+
+    /* Is in the gen2 aggregates list because of card marking, so only the
+     * dirty cards of it need to be scanned. */
+    MVM_CF_DIRTY_CARDS = 4096
 } MVMCollectableFlags;
 
 #ifdef MVM_USE_OVERFLOW_SERIALIZATION_INDEX
@@ -353,6 +357,18 @@ struct MVMSTable {
     /* If this STable is currently in the process of being repossessed. Used
      * to trigger clearup of memory pre-repossession. */
     MVMuint8 being_repossessed;
+
+    /* Survival feedback for pretenuring (see gc/allocation.h): how many
+     * objects of this type were allocated in the nursery and how many were
+     * promoted since the GC run with the sequence number sample_gc, and
+     * how many more may be allocated directly in gen2 before sampling again.
+     * Threads update the counts without synchronization, so they are only
+     * approximate; the allocations left are counted down atomically, so the
+     * count can't wrap around and only one thread starts the next sample. */
+    MVMuint32 pretenure_allocs;
+    MVMuint32 pretenure_promotions;
+    MVMuint32 pretenure_sample_gc;
+    AO_t      pretenure_left;
 };
 
 /* The representation operations table. Note that representations are not
@@ -632,6 +648,13 @@ struct MVMREPROps {
     /* Optional API to describe references to other Collectables either by
      * index or by name, i.E. names of attributes or lexicals. */
     void (*describe_refs) (MVMThreadContext *tc, MVMHeapSnapshotState *ss, MVMSTable *st, void *data);
+
+    /* Optional API for representations that use card marking (see gc/wb.h),
+     * called instead of gc_mark on objects that are inter-generational
+     * roots. Adds the things referenced from the slots of dirty cards to the
+     * worklist, or from all slots if all is set, and leaves dirty just the
+     * cards that still reference nursery objects. */
+    void (*gc_mark_cards) (MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorklist *worklist, MVMuint32 all);
 };
 
 /* Various handy macros for getting at important stuff. */
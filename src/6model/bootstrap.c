@@ -578,6 +578,7 @@ static void string_consts(MVMThreadContext *tc) {
     string_creator(kind, "kind");
     string_creator(instrumented, "instrumented");
     string_creator(heap, "heap");
+    string_creator(cpu, "cpu");
     string_creator(translate_newlines, "translate_newlines");
 }
 
@@ -701,4 +702,6 @@ void MVM_6model_bootstrap(MVMThreadContext *tc) {
     MVM_6model_containers_setup(tc);
 
     MVM_intcache_for(tc, tc->instance->boot_types.BOOTInt);
+    MVM_intcache_for_num(tc, tc->instance->boot_types.BOOTNum);
+    MVM_intcache_for_str(tc, tc->instance->boot_types.BOOTStr);
 }
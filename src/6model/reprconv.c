@@ -576,17 +576,24 @@ MVMObject * MVM_repr_box_int(MVMThreadContext *tc, MVMObject *type, MVMint64 val
 }
 
 MVMObject * MVM_repr_box_num(MVMThreadContext *tc, MVMObject *type, MVMnum64 val) {
-    MVMObject *res = MVM_repr_alloc_init(tc, type);
-    MVM_repr_set_num(tc, res, val);
+    MVMObject *res;
+    res = MVM_intcache_get_num(tc, type, val);
+    if (res == 0) {
+        res = MVM_repr_alloc_init(tc, type);
+        MVM_repr_set_num(tc, res, val);
+    }
     return res;
 }
 
 MVMObject * MVM_repr_box_str(MVMThreadContext *tc, MVMObject *type, MVMString *val) {
     MVMObject *res;
-    MVMROOT(tc, val, {
-        res = MVM_repr_alloc_init(tc, type);
-        MVM_repr_set_str(tc, res, val);
-    });
+    res = MVM_intcache_get_str(tc, type, val);
+    if (res == 0) {
+        MVMROOT(tc, val, {
+            res = MVM_repr_alloc_init(tc, type);
+            MVM_repr_set_str(tc, res, val);
+        });
+    }
     return res;
 }
 
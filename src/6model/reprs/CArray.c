@@ -484,4 +484,5 @@ static const MVMREPROps CArray_this_repr = {
     MVM_REPR_ID_MVMCArray,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
@@ -113,4 +113,5 @@ static const MVMREPROps CStr_this_repr = {
     MVM_REPR_ID_MVMCStr,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
@@ -825,4 +825,5 @@ static const MVMREPROps CStruct_this_repr = {
     MVM_REPR_ID_MVMCStruct,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
@@ -269,6 +269,7 @@ static const MVMREPROps ConcBlockingQueue_this_repr = {
     MVM_REPR_ID_ConcBlockingQueue,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
 
 /* Polls a queue for a value, returning NULL if none is available. */
@@ -97,6 +97,7 @@ static const MVMREPROps ConditionVariable_this_repr = {
     MVM_REPR_ID_ConditionVariable,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
 
 /* Given a reentrant mutex, produces an associated condition variable. */
@@ -91,6 +91,7 @@ static const MVMREPROps Decoder_this_repr = {
     MVM_REPR_ID_Decoder,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
 
 /* Assert that the passed object really is a decoder; throw if not. */
@@ -163,4 +163,5 @@ static const MVMREPROps HashAttrStore_this_repr = {
     MVM_REPR_ID_HashAttrStore,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
@@ -115,4 +115,5 @@ static const MVMREPROps Lexotic_this_repr = {
     MVM_REPR_ID_Lexotic,
     NULL, /* unmanaged_size */
     describe_refs,
+    NULL, /* gc_mark_cards */
 };
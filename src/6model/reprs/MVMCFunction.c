@@ -87,4 +87,5 @@ static const MVMREPROps MVMCFunction_this_repr = {
     MVM_REPR_ID_MVMCFunction,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
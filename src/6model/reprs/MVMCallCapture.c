@@ -145,6 +145,7 @@ static const MVMREPROps MVMCallCapture_this_repr = {
     MVM_REPR_ID_MVMCallCapture,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
 
 /* This function was only introduced for the benefit of the JIT. */
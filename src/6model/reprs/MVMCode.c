@@ -124,6 +124,7 @@ static const MVMREPROps MVMCode_this_repr = {
     MVM_REPR_ID_MVMCode,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
 
 MVM_PUBLIC MVMObject * MVM_code_location(MVMThreadContext *tc, MVMObject *code) {
@@ -246,4 +246,5 @@ static const MVMREPROps MVMCompUnit_this_repr = {
     MVM_REPR_ID_MVMCompUnit,
     unmanaged_size,
     describe_refs,
+    NULL, /* gc_mark_cards */
 };
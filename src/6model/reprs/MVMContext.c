@@ -195,4 +195,5 @@ static const MVMREPROps MVMContext_this_repr = {
     MVM_REPR_ID_MVMContext,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
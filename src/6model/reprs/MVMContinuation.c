@@ -109,4 +109,5 @@ static const MVMREPROps MVMContinuation_this_repr = {
     MVM_REPR_ID_MVMContinuation,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
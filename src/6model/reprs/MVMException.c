@@ -83,4 +83,5 @@ static const MVMREPROps MVMException_this_repr = {
     MVM_REPR_ID_MVMException,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
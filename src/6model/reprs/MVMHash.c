@@ -41,6 +41,34 @@ static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *d
     }
 }
 
+/* Makes sure the card table of a hash has a card for every range of its
+ * buckets, returning it, or NULL if there are too few buckets for cards.
+ * Adding entries may increase the number of buckets, moving entries into
+ * other buckets, so all cards are dirty when that happens. */
+static MVMuint8 * update_cards(MVMThreadContext *tc, MVMHashBody *body) {
+    MVMuint32 num_buckets = body->hash_head ? body->hash_head->hash_handle.tbl->num_buckets : 0;
+    MVMuint32 num_cards   = num_buckets >= MVM_GC_CARDS_MIN_SLOTS ? MVM_GC_NUM_CARDS(num_buckets) : 0;
+    if (num_cards != body->num_cards) {
+        if (num_cards) {
+            body->cards = MVM_realloc(body->cards, num_cards);
+            memset(body->cards, 1, num_cards);
+        }
+        else {
+            MVM_free(body->cards);
+            body->cards = NULL;
+        }
+        body->num_cards = num_cards;
+    }
+    return body->cards;
+}
+
+/* Gets the bucket of an entry, which is the slot used for card marking. */
+MVM_STATIC_INLINE MVMuint32 bucket_of(MVMHashEntry *entry) {
+    MVMuint32 bucket;
+    HASH_TO_BKT(entry->hash_handle.hashv, entry->hash_handle.tbl->num_buckets, bucket);
+    return bucket;
+}
+
 /* Adds held objects to the GC worklist. */
 static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorklist *worklist) {
     MVMHashBody *body = (MVMHashBody *)data;
@@ -53,6 +81,44 @@ static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorkli
     }
 }
 
+/* Adds the objects held in the buckets of dirty cards (or of all cards) to
+ * the GC worklist, and works out which cards are still dirty. */
+static void gc_mark_cards(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorklist *worklist, MVMuint32 all) {
+    MVMHashBody   *body = (MVMHashBody *)data;
+    MVMuint8      *cards;
+    UT_hash_table *tbl;
+    MVMuint32      card;
+
+    if (!body->hash_head)
+        return;
+    cards = update_cards(tc, body);
+    if (!cards) {
+        gc_mark(tc, st, data, worklist);
+        return;
+    }
+
+    tbl = body->hash_head->hash_handle.tbl;
+    for (card = 0; card < body->num_cards; card++) {
+        MVMuint32 items_before_mark, bucket, card_end;
+        if (!all && !cards[card])
+            continue;
+        items_before_mark = worklist->items;
+        bucket   = card << MVM_GC_CARD_BITS;
+        card_end = bucket + (1 << MVM_GC_CARD_BITS);
+        if (card_end > tbl->num_buckets)
+            card_end = tbl->num_buckets;
+        for (; bucket < card_end; bucket++) {
+            UT_hash_handle *hh;
+            for (hh = tbl->buckets[bucket].hh_head; hh; hh = hh->hh_next) {
+                MVMHashEntry *current = (MVMHashEntry *)ELMT_FROM_HH(tbl, hh);
+                MVM_gc_worklist_add(tc, worklist, &current->hash_handle.key);
+                MVM_gc_worklist_add(tc, worklist, &current->value);
+            }
+        }
+        cards[card] = worklist->items != items_before_mark;
+    }
+}
+
 /* Called by the VM in order to free memory associated with this object. */
 static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     MVMHash *h = (MVMHash *)obj;
@@ -66,6 +132,7 @@ static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     HASH_CLEAR(hash_handle, h->body.hash_head);
     if (tmp)
         MVM_fixed_size_free(tc, tc->instance->fsa, sizeof(MVMHashEntry), tmp);
+    MVM_free(h->body.cards);
 }
 
 static void at_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMObject *key_obj, MVMRegister *result, MVMuint16 kind) {
@@ -89,17 +156,23 @@ static void bind_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void
         MVM_exception_throw_adhoc(tc,
             "MVMHash representation does not support native type storage");
 
-    /* first check whether we can must update the old entry. */
+    /* first check whether we can must update the old entry. The write
+     * barriers are applied once the entry is in the hash, so that we know
+     * which bucket (and so which card) it is in. */
     MVM_HASH_GET(tc, body->hash_head, key, entry);
     if (!entry) {
+        MVMuint8 *cards;
         entry = MVM_fixed_size_alloc(tc, tc->instance->fsa,
             sizeof(MVMHashEntry));
-        MVM_ASSIGN_REF(tc, &(root->header), entry->value, value.o);
+        entry->value = NULL;
         MVM_HASH_BIND(tc, body->hash_head, key, entry);
-        MVM_gc_write_barrier(tc, &(root->header), &(key->common.header));
+        cards = update_cards(tc, body);
+        MVM_ASSIGN_REF_CARD(tc, &(root->header), cards, bucket_of(entry), entry->value, value.o);
+        MVM_gc_write_barrier_card(tc, &(root->header), cards, bucket_of(entry), &(key->common.header));
     }
     else {
-        MVM_ASSIGN_REF(tc, &(root->header), entry->value, value.o);
+        MVMuint8 *cards = update_cards(tc, body);
+        MVM_ASSIGN_REF_CARD(tc, &(root->header), cards, bucket_of(entry), entry->value, value.o);
     }
 }
 
@@ -213,7 +286,8 @@ static void spesh(MVMThreadContext *tc, MVMSTable *st, MVMSpeshGraph *g, MVMSpes
 static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data) {
     MVMHashBody *body = (MVMHashBody *)data;
 
-    return sizeof(MVMHashEntry) * HASH_CNT(hash_handle, body->hash_head);
+    return sizeof(MVMHashEntry) * HASH_CNT(hash_handle, body->hash_head)
+        + body->num_cards;
 }
 
 /* Initializes the representation. */
@@ -255,4 +329,5 @@ static const MVMREPROps MVMHash_this_repr = {
     MVM_REPR_ID_MVMHash,
     unmanaged_size, /* unmanaged_size */
     NULL, /* describe_refs */
+    gc_mark_cards,
 };
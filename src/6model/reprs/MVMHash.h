@@ -11,6 +11,11 @@ struct MVMHashEntry {
 struct MVMHashBody {
     /* uthash updates this pointer directly. */
     MVMHashEntry *hash_head;
+
+    /* Card table, with a card per range of buckets, once there are enough
+     * buckets to do card marking (see gc/wb.h); NULL otherwise. */
+    MVMuint8     *cards;
+    MVMuint32     num_cards;
 };
 struct MVMHash {
     MVMObject common;
@@ -191,6 +191,7 @@ static const MVMREPROps MVMIter_this_repr = {
     MVM_REPR_ID_MVMIter,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
 
 MVMObject * MVM_iter(MVMThreadContext *tc, MVMObject *target) {
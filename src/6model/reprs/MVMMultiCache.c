@@ -100,6 +100,7 @@ static const MVMREPROps MVMMultiCache_this_repr = {
     MVM_REPR_ID_MVMMultiCache,
     unmanaged_size, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
 
 /* Filters for various parts of action.arg_match. */
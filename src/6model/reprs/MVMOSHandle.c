@@ -106,4 +106,5 @@ static const MVMREPROps MVMOSHandle_this_repr = {
     MVM_REPR_ID_MVMOSHandle,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
@@ -150,19 +150,29 @@ static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorkli
     if (body->num_spesh_candidates) {
         MVMint32 i, j;
         for (i = 0; i < body->num_spesh_candidates; i++) {
-            for (j = 0; j < body->spesh_candidates[i].num_guards; j++)
-                MVM_gc_worklist_add(tc, worklist, &body->spesh_candidates[i].guards[j].match);
-            for (j = 0; j < body->spesh_candidates[i].num_spesh_slots; j++)
-                MVM_gc_worklist_add(tc, worklist, &body->spesh_candidates[i].spesh_slots[j]);
-            if (body->spesh_candidates[i].log_slots)
-                for (j = 0; j < body->spesh_candidates[i].num_log_slots * MVM_SPESH_LOG_RUNS; j++)
-                    MVM_gc_worklist_add(tc, worklist, &body->spesh_candidates[i].log_slots[j]);
-            for (j = 0; j < body->spesh_candidates[i].num_inlines; j++)
-                MVM_gc_worklist_add(tc, worklist, &body->spesh_candidates[i].inlines[j].code);
-            if (body->spesh_candidates[i].sg)
-                MVM_spesh_graph_mark(tc, body->spesh_candidates[i].sg, worklist);
+            for (j = 0; j < body->spesh_candidates[i]->num_guards; j++)
+                MVM_gc_worklist_add(tc, worklist, &body->spesh_candidates[i]->guards[j].match);
+            for (j = 0; j < body->spesh_candidates[i]->num_spesh_slots; j++)
+                MVM_gc_worklist_add(tc, worklist, &body->spesh_candidates[i]->spesh_slots[j]);
+            if (body->spesh_candidates[i]->log_slots)
+                for (j = 0; j < body->spesh_candidates[i]->num_log_slots * MVM_SPESH_LOG_RUNS; j++)
+                    MVM_gc_worklist_add(tc, worklist, &body->spesh_candidates[i]->log_slots[j]);
+            for (j = 0; j < body->spesh_candidates[i]->num_inlines; j++)
+                MVM_gc_worklist_add(tc, worklist, &body->spesh_candidates[i]->inlines[j].code);
+            if (body->spesh_candidates[i]->sg)
+                MVM_spesh_graph_mark(tc, body->spesh_candidates[i]->sg, worklist);
         }
+
+        /* The world is stopped, so it's a good time to age candidates and
+         * make room for new ones if the frame is short of them. */
+        MVM_spesh_candidate_age(tc, body);
+        if (body->spesh_guard_tree)
+            MVM_spesh_guard_tree_gc_mark(tc, body->spesh_guard_tree, worklist);
     }
+
+    /* Spesh statistics. */
+    if (body->spesh_stats)
+        MVM_spesh_stats_gc_mark(tc, body->spesh_stats, worklist);
 }
 
 /* Called by the VM in order to free memory associated with this object. */
@@ -188,9 +198,18 @@ static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     MVM_free(body->lexical_names_list);
     MVM_HASH_DESTROY(hash_handle, MVMLexicalRegistry, body->lexical_names);
 
-    for (i = 0; i < body->num_spesh_candidates; i++)
-        MVM_spesh_candidate_destroy(tc, &body->spesh_candidates[i]);
-    MVM_free(body->spesh_candidates);
+    for (i = 0; i < body->num_spesh_candidates; i++) {
+        MVM_spesh_candidate_destroy(tc, body->spesh_candidates[i]);
+        MVM_free(body->spesh_candidates[i]);
+    }
+    if (body->spesh_guard_tree)
+        MVM_spesh_guard_tree_destroy(tc, body->spesh_guard_tree);
+    if (body->spesh_candidates)
+        MVM_fixed_size_free(tc, tc->instance->fsa,
+            body->alloc_spesh_candidates * sizeof(MVMSpeshCandidate *),
+            body->spesh_candidates);
+    if (body->spesh_stats)
+        MVM_spesh_stats_destroy(tc, body->spesh_stats);
 }
 
 static const MVMStorageSpec storage_spec = {
@@ -243,7 +262,7 @@ static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data)
         size += body->num_lexicals; /* static_env_flags */
 
         for (spesh_idx = 0; spesh_idx < body->num_spesh_candidates; spesh_idx++) {
-            MVMSpeshCandidate *cand = &body->spesh_candidates[spesh_idx];
+            MVMSpeshCandidate *cand = body->spesh_candidates[spesh_idx];
             size += sizeof(MVMSpeshGuard) * cand->num_guards;
 
             size += cand->bytecode_size;
@@ -283,6 +302,10 @@ static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data)
             }
         }
 
+        if (body->spesh_guard_tree)
+            size += sizeof(MVMSpeshGuardTree) +
+                sizeof(MVMSpeshGuardTreeNode) * body->spesh_guard_tree->num_nodes;
+
         if (body->instrumentation) {
             size += body->instrumentation->uninstrumented_bytecode_size;
             size += body->instrumentation->instrumented_bytecode_size;
@@ -337,26 +360,26 @@ static void describe_refs(MVMThreadContext *tc, MVMHeapSnapshotState *ss, MVMSTa
     if (body->num_spesh_candidates) {
         MVMint32 i, j;
         for (i = 0; i < body->num_spesh_candidates; i++) {
-            for (j = 0; j < body->spesh_candidates[i].num_guards; j++)
+            for (j = 0; j < body->spesh_candidates[i]->num_guards; j++)
                 MVM_profile_heap_add_collectable_rel_const_cstr(tc, ss,
-                    (MVMCollectable *)body->spesh_candidates[i].guards[j].match,
+                    (MVMCollectable *)body->spesh_candidates[i]->guards[j].match,
                     "Spesh guard match");
-            for (j = 0; j < body->spesh_candidates[i].num_spesh_slots; j++)
+            for (j = 0; j < body->spesh_candidates[i]->num_spesh_slots; j++)
                 MVM_profile_heap_add_collectable_rel_const_cstr(tc, ss,
-                    (MVMCollectable *)body->spesh_candidates[i].spesh_slots[j],
+                    (MVMCollectable *)body->spesh_candidates[i]->spesh_slots[j],
                     "Spesh slot entry");
-            if (body->spesh_candidates[i].log_slots)
-                for (j = 0; j < body->spesh_candidates[i].num_log_slots * MVM_SPESH_LOG_RUNS; j++)
+            if (body->spesh_candidates[i]->log_slots)
+                for (j = 0; j < body->spesh_candidates[i]->num_log_slots * MVM_SPESH_LOG_RUNS; j++)
                 MVM_profile_heap_add_collectable_rel_const_cstr(tc, ss,
-                    (MVMCollectable *)body->spesh_candidates[i].log_slots[j],
+                    (MVMCollectable *)body->spesh_candidates[i]->log_slots[j],
                     "Spesh log slots");
-            for (j = 0; j < body->spesh_candidates[i].num_inlines; j++)
+            for (j = 0; j < body->spesh_candidates[i]->num_inlines; j++)
                 MVM_profile_heap_add_collectable_rel_const_cstr(tc, ss,
-                    (MVMCollectable *)body->spesh_candidates[i].inlines[j].code,
+                    (MVMCollectable *)body->spesh_candidates[i]->inlines[j].code,
                     "Spesh inlined code object");
-            if (body->spesh_candidates[i].sg) {
+            if (body->spesh_candidates[i]->sg) {
                 MVMCollectable **c_ptr;
-                MVM_spesh_graph_mark(tc, body->spesh_candidates[i].sg, ss->gcwl);
+                MVM_spesh_graph_mark(tc, body->spesh_candidates[i]->sg, ss->gcwl);
                 while (( c_ptr = MVM_gc_worklist_get(tc, ss->gcwl) )) {
                     MVMCollectable *c = *c_ptr;
                     MVM_profile_heap_add_collectable_rel_const_cstr(tc, ss, c,
@@ -365,6 +388,12 @@ static void describe_refs(MVMThreadContext *tc, MVMHeapSnapshotState *ss, MVMSTa
             }
         }
     }
+
+    /* Spesh guard tree and statistics. */
+    if (body->spesh_guard_tree)
+        MVM_spesh_guard_tree_gc_describe(tc, ss, body->spesh_guard_tree);
+    if (body->spesh_stats)
+        MVM_spesh_stats_gc_describe(tc, ss, body->spesh_stats);
 }
 
 /* Initializes the representation. */
@@ -400,4 +429,5 @@ static const MVMREPROps MVMStaticFrame_this_repr = {
     MVM_REPR_ID_MVMStaticFrame,
     unmanaged_size, /* unmanaged_size */
     describe_refs,
+    NULL, /* gc_mark_cards */
 };
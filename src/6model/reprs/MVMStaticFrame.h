@@ -39,9 +39,37 @@ struct MVMStaticFrameBody {
     /* Number of times we should invoke before spesh applies. */
     MVMuint32 spesh_threshold;
 
-    /* Specializations array, if there are any. */
-    MVMSpeshCandidate *spesh_candidates;
-    MVMuint32          num_spesh_candidates;
+    /* Specializations array, if there are any, and its allocated size.
+     * Evicted candidates are marked as discarded, and only freed by the GC
+     * once no frame refers to them; the array is then closed up. Also one
+     * more than the highest index a candidate has ever had. */
+    MVMSpeshCandidate **spesh_candidates;
+    MVMuint32           num_spesh_candidates;
+    MVMuint32           alloc_spesh_candidates;
+    MVMuint32           spesh_cand_high_water;
+
+    /* Guard tree used to pick a candidate for a call; rebuilt whenever the
+     * set of candidates changes. */
+    MVMSpeshGuardTree *spesh_guard_tree;
+
+    /* Number of candidates that are not discarded, and how many of those
+     * we currently allow (0 means MVM_SPESH_LIMIT). The limit is adapted
+     * at GC time based on the hit and miss counts. */
+    MVMuint32 num_live_spesh_candidates;
+    MVMuint32 spesh_cand_limit;
+
+    /* Rough counts of calls past the spesh threshold that did (hits) or did
+     * not (misses) find a finished specialization to run. The totals are
+     * kept for diagnostics; the recent counts are reset each time the GC
+     * ages the candidates. */
+    MVMuint32 spesh_hits;
+    MVMuint32 spesh_misses;
+    MVMuint32 spesh_recent_hits;
+    MVMuint32 spesh_recent_misses;
+
+    /* Statistics about calls and logged types, used to decide what to
+     * specialize on; created when first needed. */
+    MVMSpeshStats *spesh_stats;
 
     /* The size in bytes to allocate for the lexical environment. */
     MVMuint32 env_size;
@@ -1,12 +1,17 @@
 /* Representation used by VM-level strings.
  *
- * Strings come in one of 3 forms today, with 1 expected future form:
+ * Strings come in one of 4 forms:
  *   - 32-bit buffer of graphemes (Unicode codepoints or synthetic codepoints)
  *   - 8-bit buffer of codepoints that all fall in the ASCII range
+ *   - 8-bit buffer of codepoints with negatives as synthetics (we draw out a
+ *     distinction with the ASCII range buffer because we can do some I/O
+ *     simplifications when we know all is in the ASCII range)
  *   - Buffer of strands
- *   - (LATER) 8-bit buffer of codepoints with negatives as synthetics (we
- *     draw out a distinction with the ASCII range buffer because we can do
- *     some I/O simplifications when we know all is in the ASCII range).
+ *
+ * Since the 8-bit buffer is signed, it holds ASCII text along with the first
+ * 128 synthetics (such as \r\n); the decoders, chr, substr, join and NFG
+ * re-normalization produce it whenever a string fits, and otherwise fall
+ * back to the 32-bit buffer.
  *
  * A buffer of strands represents a string made up of other non-strand
  * strings. That is, there's no recursive strands. This simplifies the
@@ -18,7 +23,7 @@
 /* Kinds of grapheme we may hold in a string. */
 typedef MVMint32 MVMGrapheme32;
 typedef MVMint8  MVMGraphemeASCII;
-typedef MVMint8  MVMGrapheme8;       /* Future use */
+typedef MVMint8  MVMGrapheme8;
 
 /* What kind of data is a string storing? */
 #define MVM_STRING_GRAPHEME_32      0
@@ -800,4 +800,5 @@ static const MVMREPROps MultiDimArray_this_repr = {
     MVM_REPR_ID_MultiDimArray,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
@@ -274,6 +274,7 @@ static const MVMREPROps NFA_this_repr = {
     MVM_REPR_ID_NFA,
     unmanaged_size,
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
 
 /* We may be provided a grapheme as a codepoint for non-synthetics, or as a
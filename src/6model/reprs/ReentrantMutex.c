@@ -113,6 +113,7 @@ static const MVMREPROps ReentrantMutex_this_repr = {
     MVM_REPR_ID_ReentrantMutex,
     NULL, /* unmanaged_size */
     NULL, /* describe_refs */
+    NULL, /* gc_mark_cards */
 };
 
 /* Locks the mutex. */
@@ -228,4 +228,5 @@ static const MVMREPROps SCRef_this_repr = {
     MVM_REPR_ID_SCRef,
     unmanaged_size,
     describe_refs,
+    NULL, /* gc_mark_cards */
 };
@@ -38,6 +38,53 @@ static MVMObject * type_object_for(MVMThreadContext *tc, MVMObject *HOW) {
     return st->WHAT;
 }
 
+/* Makes the card table of an array of objects or strings that has grown to
+ * have enough slots for card marking cover all of its slots. The cards for
+ * the new slots are clean, as the slots are empty; a new card table is all
+ * dirty, as we don't know what the slots reference. */
+static void resize_cards(MVMThreadContext *tc, MVMArrayBody *body, MVMuint64 old_ssize, MVMArrayREPRData *repr_data) {
+    MVMuint64 num_cards, old_num_cards;
+    if (repr_data->slot_type != MVM_ARRAY_OBJ && repr_data->slot_type != MVM_ARRAY_STR)
+        return;
+    if (body->ssize < MVM_GC_CARDS_MIN_SLOTS)
+        return;
+    num_cards = MVM_GC_NUM_CARDS(body->ssize);
+    if (body->cards) {
+        old_num_cards = MVM_GC_NUM_CARDS(old_ssize);
+        body->cards = MVM_realloc(body->cards, num_cards);
+        memset(body->cards + old_num_cards, 0, num_cards - old_num_cards);
+    }
+    else {
+        body->cards = MVM_malloc(num_cards);
+        memset(body->cards, 1, num_cards);
+    }
+}
+
+/* Allocates or resizes the slot array to the given size in bytes. Big ones
+ * go in the large object space; a slot array from malloc (perhaps handed
+ * to us from elsewhere) is moved there once it grows big enough. */
+static void * resize_slots(MVMThreadContext *tc, MVMArrayBody *body, size_t old_size, size_t size) {
+    void *slots = body->slots.any;
+    if (body->slots_in_los)
+        return MVM_gc_los_realloc(tc->instance, slots, old_size, size);
+    if (size >= MVM_LOS_MIN_SIZE) {
+        void *new_slots = MVM_gc_los_alloc(tc->instance, size);
+        if (slots) {
+            memcpy(new_slots, slots, old_size);
+            MVM_free(slots);
+        }
+        body->slots_in_los = 1;
+        return new_slots;
+    }
+    return slots ? MVM_realloc(slots, size) : MVM_malloc(size);
+}
+
+/* Dirties all the cards of an array, after its elements were moved. */
+static void dirty_cards(MVMArrayBody *body) {
+    if (body->cards)
+        memset(body->cards, 1, MVM_GC_NUM_CARDS(body->ssize));
+}
+
 /* Copies the body of one object to another. The result has the space
  * needed for the current number of elements, which may not be the
  * entire allocated slot size. */
@@ -52,8 +99,9 @@ static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *d
         size_t  mem_size     = dest_body->ssize * repr_data->elem_size;
         size_t  start_pos    = src_body->start * repr_data->elem_size;
         char   *copy_start   = ((char *)src_body->slots.any) + start_pos;
-        dest_body->slots.any = MVM_malloc(mem_size);
+        dest_body->slots.any = resize_slots(tc, dest_body, 0, mem_size);
         memcpy(dest_body->slots.any, copy_start, mem_size);
+        resize_cards(tc, dest_body, 0, repr_data);
     }
     else {
         dest_body->slots.any = NULL;
@@ -89,10 +137,76 @@ static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorkli
     }
 }
 
+/* Adds the things held in the slots of dirty cards (or of all cards) to
+ * the GC worklist, and works out which cards are still dirty. */
+static void gc_mark_cards(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorklist *worklist, MVMuint32 all) {
+    MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
+    MVMArrayBody     *body      = (MVMArrayBody *)data;
+    MVMuint64         start     = body->start;
+    MVMuint64         end       = body->start + body->elems;
+    MVMuint64         num_cards, card;
+
+    if (repr_data->slot_type != MVM_ARRAY_OBJ && repr_data->slot_type != MVM_ARRAY_STR)
+        return;
+    if (!body->cards) {
+        gc_mark(tc, st, data, worklist);
+        return;
+    }
+
+    num_cards = MVM_GC_NUM_CARDS(body->ssize);
+    for (card = 0; card < num_cards; card++) {
+        MVMuint64 items_before_mark, i, card_end;
+        if (!all && !body->cards[card])
+            continue;
+        items_before_mark = worklist->items;
+        i        = card << MVM_GC_CARD_BITS;
+        card_end = i + (1 << MVM_GC_CARD_BITS);
+        if (i < start)
+            i = start;
+        if (card_end > end)
+            card_end = end;
+        while (i < card_end) {
+            /* Objects and strings are both pointers in the same place. */
+            MVM_gc_worklist_add(tc, worklist, &body->slots.o[i]);
+            i++;
+        }
+        body->cards[card] = worklist->items != items_before_mark;
+    }
+}
+
+/* Frees the slot array, from wherever it was allocated. */
+static void free_slots(MVMThreadContext *tc, MVMSTable *st, MVMArrayBody *body) {
+    if (body->slots_in_los) {
+        MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
+        MVM_gc_los_free(tc->instance, body->slots.any, body->ssize * repr_data->elem_size);
+        body->slots_in_los = 0;
+    }
+    else {
+        MVM_free(body->slots.any);
+    }
+    body->slots.any = NULL;
+}
+
 /* Called by the VM in order to free memory associated with this object. */
 static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     MVMArray *arr = (MVMArray *)obj;
-    MVM_free(arr->body.slots.any);
+    free_slots(tc, STABLE(obj), &arr->body);
+    MVM_free(arr->body.cards);
+}
+
+/* Replaces the slot array of an array of native values with one allocated
+ * by MVM_malloc, with room for ssize elements and holding elems of them,
+ * and frees the one it had. Code outside of the REPR that builds up slot
+ * storage itself must hand it over this way, since the old slot array may
+ * be in the large object space. */
+void MVM_array_set_malloced_slots(MVMThreadContext *tc, MVMObject *arr, void *slots,
+        MVMuint64 elems, MVMuint64 ssize) {
+    MVMArrayBody *body = &((MVMArray *)arr)->body;
+    free_slots(tc, STABLE(arr), body);
+    body->slots.any = slots;
+    body->start     = 0;
+    body->elems     = elems;
+    body->ssize     = ssize;
 }
 
 /* Marks the representation data in an STable.*/
@@ -299,10 +413,11 @@ static MVMuint64 zero_slots(MVMThreadContext *tc, MVMArrayBody *body,
 }
 
 static void set_size_internal(MVMThreadContext *tc, MVMArrayBody *body, MVMuint64 n, MVMArrayREPRData *repr_data) {
-    MVMuint64   elems = body->elems;
-    MVMuint64   start = body->start;
-    MVMuint64   ssize = body->ssize;
-    void       *slots = body->slots.any;
+    MVMuint64   elems     = body->elems;
+    MVMuint64   start     = body->start;
+    MVMuint64   ssize     = body->ssize;
+    MVMuint64   old_ssize = ssize;
+    void       *slots     = body->slots.any;
 
     if (n < 0)
         MVM_exception_throw_adhoc(tc,
@@ -321,6 +436,7 @@ static void set_size_internal(MVMThreadContext *tc, MVMArrayBody *body, MVMuint6
         body->start = 0;
         /* fill out any unused slots with NULL pointers or zero values */
         elems = zero_slots(tc, body, elems, ssize, repr_data->slot_type);
+        dirty_cards(body);
     }
 
     body->elems = n;
@@ -347,15 +463,15 @@ static void set_size_internal(MVMThreadContext *tc, MVMArrayBody *body, MVMuint6
             ssize);
 
     /* now allocate the new slot buffer */
-    slots = (slots)
-            ? MVM_realloc(slots, ssize * repr_data->elem_size)
-            : MVM_malloc(ssize * repr_data->elem_size);
+    slots = resize_slots(tc, body, old_ssize * repr_data->elem_size,
+        ssize * repr_data->elem_size);
 
     /* fill out any unused slots with NULL pointers or zero values */
     body->slots.any = slots;
     zero_slots(tc, body, elems, ssize, repr_data->slot_type);
 
     body->ssize = ssize;
+    resize_cards(tc, body, old_ssize, repr_data);
 }
 
 static void bind_pos(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMint64 index, MVMRegister value, MVMuint16 kind) {
@@ -377,12 +493,14 @@ static void bind_pos(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void
         case MVM_ARRAY_OBJ:
             if (kind != MVM_reg_obj)
                 MVM_exception_throw_adhoc(tc, "MVMArray: bindpos expected object register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.o[body->start + index], value.o);
+            MVM_ASSIGN_REF_CARD(tc, &(root->header), body->cards, body->start + index,
+                body->slots.o[body->start + index], value.o);
             break;
         case MVM_ARRAY_STR:
             if (kind != MVM_reg_str)
                 MVM_exception_throw_adhoc(tc, "MVMArray: bindpos expected string register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.s[body->start + index], value.s);
+            MVM_ASSIGN_REF_CARD(tc, &(root->header), body->cards, body->start + index,
+                body->slots.s[body->start + index], value.s);
             break;
         case MVM_ARRAY_I64:
             if (kind != MVM_reg_int64)
@@ -462,12 +580,14 @@ static void push(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *dat
         case MVM_ARRAY_OBJ:
             if (kind != MVM_reg_obj)
                 MVM_exception_throw_adhoc(tc, "MVMArray: push expected object register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.o[body->start + body->elems - 1], value.o);
+            MVM_ASSIGN_REF_CARD(tc, &(root->header), body->cards, body->start + body->elems - 1,
+                body->slots.o[body->start + body->elems - 1], value.o);
             break;
         case MVM_ARRAY_STR:
             if (kind != MVM_reg_str)
                 MVM_exception_throw_adhoc(tc, "MVMArray: push expected string register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.s[body->start + body->elems - 1], value.s);
+            MVM_ASSIGN_REF_CARD(tc, &(root->header), body->cards, body->start + body->elems - 1,
+                body->slots.s[body->start + body->elems - 1], value.s);
             break;
         case MVM_ARRAY_I64:
             if (kind != MVM_reg_int64)
@@ -628,6 +748,7 @@ static void unshift(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *
 
         /* clear out beginning elements */
         zero_slots(tc, body, 0, n, repr_data->slot_type);
+        dirty_cards(body);
     }
 
     /* Now do the unshift */
@@ -636,12 +757,14 @@ static void unshift(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *
         case MVM_ARRAY_OBJ:
             if (kind != MVM_reg_obj)
                 MVM_exception_throw_adhoc(tc, "MVMArray: unshift expected object register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.o[body->start], value.o);
+            MVM_ASSIGN_REF_CARD(tc, &(root->header), body->cards, body->start,
+                body->slots.o[body->start], value.o);
             break;
         case MVM_ARRAY_STR:
             if (kind != MVM_reg_str)
                 MVM_exception_throw_adhoc(tc, "MVMArray: unshift expected string register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.s[body->start], value.s);
+            MVM_ASSIGN_REF_CARD(tc, &(root->header), body->cards, body->start,
+                body->slots.s[body->start], value.s);
             break;
         case MVM_ARRAY_I64:
             if (kind != MVM_reg_int64)
@@ -843,6 +966,7 @@ static void asplice(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *
             (char *)body->slots.any + (start + offset + elems1) * repr_data->elem_size,
             (char *)body->slots.any + (start + offset + count) * repr_data->elem_size,
             tail * repr_data->elem_size);
+        dirty_cards(body);
     }
 
     /* now resize the array */
@@ -855,6 +979,7 @@ static void asplice(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *
             (char *)body->slots.any + (start + offset + elems1) * repr_data->elem_size,
             (char *)body->slots.any + (start + offset + count) * repr_data->elem_size,
             tail * repr_data->elem_size);
+        dirty_cards(body);
     }
     exit_single_user(tc, body);
 
@@ -1116,7 +1241,8 @@ static void deserialize(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, vo
     body->elems = MVM_serialization_read_int(tc, reader);
     body->ssize = body->elems;
     if (body->ssize)
-        body->slots.any = MVM_malloc(body->ssize * repr_data->elem_size);
+        body->slots.any = resize_slots(tc, body, 0, body->ssize * repr_data->elem_size);
+    resize_cards(tc, body, 0, repr_data);
 
     for (i = 0; i < body->elems; i++) {
         switch (repr_data->slot_type) {
@@ -1235,7 +1361,8 @@ static void spesh(MVMThreadContext *tc, MVMSTable *st, MVMSpeshGraph *g, MVMSpes
 static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data) {
     MVMArrayREPRData *repr_data = (MVMArrayREPRData *) st->REPR_data;
     MVMArrayBody     *body      = (MVMArrayBody *)data;
-    return body->ssize * repr_data->elem_size;
+    return body->ssize * repr_data->elem_size
+        + (body->cards ? MVM_GC_NUM_CARDS(body->ssize) : 0);
 }
 
 static void describe_refs (MVMThreadContext *tc, MVMHeapSnapshotState *ss, MVMSTable *st, void *data) {
@@ -1316,4 +1443,5 @@ static const MVMREPROps VMArray_this_repr = {
     MVM_REPR_ID_VMArray,
     unmanaged_size,
     describe_refs,
+    gc_mark_cards,
 };
@@ -32,6 +32,14 @@ struct MVMArrayBody {
         void       *any;
     } slots;
 
+    /* card table, for arrays of objects or strings with enough slots to
+     * do card marking (see gc/wb.h); NULL otherwise */
+    MVMuint8   *cards;
+
+    /* whether the slot array is in the large object space (see gc/los.h),
+     * rather than from malloc */
+    MVMuint8    slots_in_los;
+
 #if MVM_ARRAY_CONC_DEBUG
     AO_t in_use;
 #endif 
@@ -64,6 +72,9 @@ struct MVMArray {
 /* Function for REPR setup. */
 const MVMREPROps * MVMArray_initialize(MVMThreadContext *tc);
 
+void MVM_array_set_malloced_slots(MVMThreadContext *tc, MVMObject *arr, void *slots,
+    MVMuint64 elems, MVMuint64 ssize);
+
 /* Array REPR data specifies the type of array elements we have. */
 struct MVMArrayREPRData {
     /* The size of each element. */
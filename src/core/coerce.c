@@ -438,18 +438,25 @@ void MVM_box_int(MVMThreadContext *tc, MVMint64 value, MVMObject *type,
 
 void MVM_box_num(MVMThreadContext *tc, MVMnum64 value, MVMObject *type,
                  MVMRegister * dst) {
-    MVMObject *box = REPR(type)->allocate(tc, STABLE(type));
-    if (REPR(box)->initialize)
-        REPR(box)->initialize(tc, STABLE(box), box, OBJECT_BODY(box));
-    REPR(box)->box_funcs.set_num(tc, STABLE(box), box,
-                                 OBJECT_BODY(box), value);
+    MVMObject *box = MVM_intcache_get_num(tc, type, value);
+    if (box == 0) {
+        box = REPR(type)->allocate(tc, STABLE(type));
+        if (REPR(box)->initialize)
+            REPR(box)->initialize(tc, STABLE(box), box, OBJECT_BODY(box));
+        REPR(box)->box_funcs.set_num(tc, STABLE(box), box,
+                                     OBJECT_BODY(box), value);
+    }
     dst->o = box;
 
 }
 
 void MVM_box_str(MVMThreadContext *tc, MVMString *value, MVMObject *type,
                  MVMRegister * dst) {
-    MVMObject *box;
+    MVMObject *box = MVM_intcache_get_str(tc, type, value);
+    if (box) {
+        dst->o = box;
+        return;
+    }
     MVMROOT(tc, value, {
             box = REPR(type)->allocate(tc, STABLE(type));
             if (REPR(box)->initialize)
@@ -1,4 +1,5 @@
 #include "moar.h"
+#include "platform/mmap.h"
 
 #include "memdebug.h"
 
@@ -65,6 +66,10 @@ void MVM_fixed_size_destroy(MVMFixedSizeAlloc *al) {
             MVM_free(al->size_classes[bin_no].pages[page_no]);
         }
         MVM_free(al->size_classes[bin_no].pages);
+        for (page_no = 0; page_no < al->size_classes[bin_no].num_spare_pages; page_no++) {
+            MVM_free(al->size_classes[bin_no].spare_pages[page_no]);
+        }
+        MVM_free(al->size_classes[bin_no].spare_pages);
     }
     uv_mutex_destroy(&(al->complex_alloc_mutex));
 
@@ -82,15 +87,27 @@ static MVMuint32 bin_for(size_t bytes) {
     return bin;
 }
 
+/* The size of the pages of a bin. */
+static MVMuint32 page_size_for(MVMuint32 bin) {
+    return MVM_FSA_PAGE_ITEMS * ((bin + 1) << MVM_FSA_BIN_BITS) + MVM_FSA_REDZONE_BYTES * 2 * MVM_FSA_PAGE_ITEMS;
+}
+
+/* Gets memory for a new page, using a spare one if there is one. */
+static char * new_page(MVMFixedSizeAllocSizeClass *bin_ptr, MVMuint32 page_size) {
+    return bin_ptr->num_spare_pages
+        ? bin_ptr->spare_pages[--bin_ptr->num_spare_pages]
+        : MVM_malloc(page_size);
+}
+
 /* Sets up a size class bin in the second generation. */
 static void setup_bin(MVMFixedSizeAlloc *al, MVMuint32 bin) {
     /* Work out page size we want. */
-    MVMuint32 page_size = MVM_FSA_PAGE_ITEMS * ((bin + 1) << MVM_FSA_BIN_BITS) + MVM_FSA_REDZONE_BYTES * 2 * MVM_FSA_PAGE_ITEMS;
+    MVMuint32 page_size = page_size_for(bin);
 
     /* We'll just allocate a single page to start off with. */
     al->size_classes[bin].num_pages = 1;
     al->size_classes[bin].pages     = MVM_malloc(sizeof(void *) * al->size_classes[bin].num_pages);
-    al->size_classes[bin].pages[0]  = MVM_malloc(page_size);
+    al->size_classes[bin].pages[0]  = new_page(&al->size_classes[bin], page_size);
 
     /* Set up allocation position and limit. */
     al->size_classes[bin].alloc_pos = al->size_classes[bin].pages[0];
@@ -100,14 +117,14 @@ static void setup_bin(MVMFixedSizeAlloc *al, MVMuint32 bin) {
 /* Adds a new page to a size class bin. */
 static void add_page(MVMFixedSizeAlloc *al, MVMuint32 bin) {
     /* Work out page size. */
-    MVMuint32 page_size = MVM_FSA_PAGE_ITEMS * ((bin + 1) << MVM_FSA_BIN_BITS) + MVM_FSA_REDZONE_BYTES * 2 * MVM_FSA_PAGE_ITEMS;
+    MVMuint32 page_size = page_size_for(bin);
 
     /* Add the extra page. */
     MVMuint32 cur_page = al->size_classes[bin].num_pages;
     al->size_classes[bin].num_pages++;
     al->size_classes[bin].pages = MVM_realloc(al->size_classes[bin].pages,
         sizeof(void *) * al->size_classes[bin].num_pages);
-    al->size_classes[bin].pages[cur_page] = MVM_malloc(page_size);
+    al->size_classes[bin].pages[cur_page] = new_page(&al->size_classes[bin], page_size);
 
     /* Set up allocation position and limit. */
     al->size_classes[bin].alloc_pos = al->size_classes[bin].pages[cur_page];
@@ -363,6 +380,145 @@ void MVM_fixed_size_safepoint(MVMThreadContext *tc, MVMFixedSizeAlloc *al) {
     al->free_at_next_safepoint_overflows = NULL;
 }
 
+/* A page of a bin, along with how many free list entries are in it, for
+ * finding the empty pages. */
+typedef struct {
+    char      *start;
+    MVMuint32  num_free;
+} PageCount;
+static int compare_page_start(const void *a, const void *b) {
+    const char *x = ((const PageCount *)a)->start;
+    const char *y = ((const PageCount *)b)->start;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+/* Finds the page (sorted by start) that a free list entry is in, if any. */
+static PageCount * page_of(PageCount *pages, MVMuint32 num_pages, MVMuint32 page_size, void *entry) {
+    MVMuint32 lo = 0, hi = num_pages;
+    while (lo < hi) {
+        MVMuint32 mid = (lo + hi) / 2;
+        if ((char *)entry < pages[mid].start)
+            hi = mid;
+        else if ((char *)entry >= pages[mid].start + page_size)
+            lo = mid + 1;
+        else
+            return &pages[mid];
+    }
+    return NULL;
+}
+
+/* Removes the entries in empty pages from a free list, returning the number
+ * removed. */
+static MVMuint32 unlink_empty(MVMFixedSizeAllocFreeListEntry **list, PageCount *pages,
+        MVMuint32 num_pages, MVMuint32 page_size) {
+    MVMuint32 removed = 0;
+    while (*list) {
+        PageCount *page = page_of(pages, num_pages, page_size, *list);
+        if (page && page->num_free == MVM_FSA_PAGE_ITEMS) {
+            *list = (*list)->next;
+            removed++;
+        }
+        else {
+            list = (MVMFixedSizeAllocFreeListEntry **)&(*list)->next;
+        }
+    }
+    return removed;
+}
+
+/* Releases the pages of a bin that every item in is on a free list, either
+ * the global one or those of threads, giving their memory back to the OS. */
+static void release_empty_pages_in_bin(MVMThreadContext *tc, MVMFixedSizeAlloc *al, MVMuint32 bin) {
+    MVMFixedSizeAllocSizeClass     *bin_ptr   = &(al->size_classes[bin]);
+    MVMuint32                       page_size = page_size_for(bin);
+    MVMuint32                       num_full  = bin_ptr->num_pages - 1;
+    MVMuint32                       i, kept, num_empty = 0;
+    MVMFixedSizeAllocFreeListEntry *fle;
+    MVMThread                      *thread;
+    PageCount                      *pages;
+
+    /* The last page is the one we're allocating in, so it's not considered. */
+    if (num_full == 0)
+        return;
+    pages = MVM_malloc(num_full * sizeof(PageCount));
+    for (i = 0; i < num_full; i++) {
+        pages[i].start    = bin_ptr->pages[i];
+        pages[i].num_free = 0;
+    }
+    qsort(pages, num_full, sizeof(PageCount), compare_page_start);
+
+    /* Count the free list entries in each page. */
+    for (fle = bin_ptr->free_list; fle; fle = fle->next) {
+        PageCount *page = page_of(pages, num_full, page_size, fle);
+        if (page && ++page->num_free == MVM_FSA_PAGE_ITEMS)
+            num_empty++;
+    }
+    for (thread = (MVMThread *)MVM_load(&tc->instance->threads); thread; thread = thread->body.next) {
+        if (!thread->body.tc || !thread->body.tc->thread_fsa)
+            continue;
+        fle = thread->body.tc->thread_fsa->size_classes[bin].free_list;
+        for (; fle; fle = fle->next) {
+            PageCount *page = page_of(pages, num_full, page_size, fle);
+            if (page && ++page->num_free == MVM_FSA_PAGE_ITEMS)
+                num_empty++;
+        }
+    }
+
+    /* If any are empty, take their entries off the free lists, and then
+     * release them. */
+    if (num_empty) {
+        unlink_empty(&bin_ptr->free_list, pages, num_full, page_size);
+        for (thread = (MVMThread *)MVM_load(&tc->instance->threads); thread; thread = thread->body.next) {
+            MVMFixedSizeAllocThreadSizeClass *thread_bin;
+            if (!thread->body.tc || !thread->body.tc->thread_fsa)
+                continue;
+            thread_bin = &(thread->body.tc->thread_fsa->size_classes[bin]);
+            thread_bin->items -= unlink_empty(&thread_bin->free_list, pages, num_full, page_size);
+        }
+        for (i = 0, kept = 0; i < bin_ptr->num_pages; i++) {
+            char      *start = bin_ptr->pages[i];
+            PageCount *page  = i < num_full ? page_of(pages, num_full, page_size, start) : NULL;
+            if (page && page->num_free == MVM_FSA_PAGE_ITEMS) {
+                size_t discarded = MVM_platform_discard_pages(start, page_size);
+                if (discarded) {
+                    if (bin_ptr->num_spare_pages == bin_ptr->alloc_spare_pages) {
+                        bin_ptr->alloc_spare_pages = bin_ptr->alloc_spare_pages
+                            ? 2 * bin_ptr->alloc_spare_pages
+                            : 8;
+                        bin_ptr->spare_pages = MVM_realloc(bin_ptr->spare_pages,
+                            bin_ptr->alloc_spare_pages * sizeof(char *));
+                    }
+                    bin_ptr->spare_pages[bin_ptr->num_spare_pages++] = start;
+                    MVM_add(&tc->instance->released_page_bytes, discarded);
+                }
+                else {
+                    MVM_free(start);
+                }
+            }
+            else {
+                bin_ptr->pages[kept++] = start;
+            }
+        }
+        bin_ptr->num_pages = kept;
+        bin_ptr->cur_page  = kept - 1;
+    }
+    MVM_free(pages);
+}
+
+/* Called at a safepoint, after MVM_fixed_size_safepoint, to find the pages
+ * of each bin with nothing allocated in them any more, and give them back
+ * to the OS. Since it needs to look through all of the free lists, it's
+ * only worth doing now and then (we do it at full collections). Assumes
+ * that it is only called on one thread at a time, while the world is
+ * stopped. */
+void MVM_fixed_size_release_empty_pages(MVMThreadContext *tc, MVMFixedSizeAlloc *al) {
+#if !FSA_SIZE_DEBUG
+    MVMuint32 bin;
+    for (bin = 0; bin < MVM_FSA_BINS; bin++)
+        if (al->size_classes[bin].pages)
+            release_empty_pages_in_bin(tc, al, bin);
+#endif
+}
+
 /* Destroys per-thread fixed size allocator state. All freelists will be
  * contributed back to the global freelists for the bin size. */
 void MVM_fixed_size_destroy_thread(MVMThreadContext *tc) {
@@ -52,6 +52,12 @@ struct MVMFixedSizeAllocSizeClass {
 
     /* Head of the "free at next safepoint" list. */
     MVMFixedSizeAllocSafepointFreeListEntry *free_at_next_safepoint_list;
+
+    /* Pages that were released when they became empty, whose memory was
+     * given back to the OS, kept to be used again before allocating more. */
+    char      **spare_pages;
+    MVMuint32   num_spare_pages;
+    MVMuint32   alloc_spare_pages;
 };
 
 /* The per-thread data structure for the fixed size allocator, hung off the
@@ -104,3 +110,4 @@ void MVM_fixed_size_destroy_thread(MVMThreadContext *tc);
 void MVM_fixed_size_free(MVMThreadContext *tc, MVMFixedSizeAlloc *fsa, size_t bytes, void *free);
 void MVM_fixed_size_free_at_safepoint(MVMThreadContext *tc, MVMFixedSizeAlloc *fsa, size_t bytes, void *free);
 void MVM_fixed_size_safepoint(MVMThreadContext *tc, MVMFixedSizeAlloc *al);
+void MVM_fixed_size_release_empty_pages(MVMThreadContext *tc, MVMFixedSizeAlloc *al);
@@ -409,11 +409,17 @@ void MVM_frame_invoke(MVMThreadContext *tc, MVMStaticFrame *static_frame,
         }
     }
 
-    /* See if any specializations apply. */
+    /* See if any specializations apply. A candidate picked by index may
+     * since have been discarded, or be another one than the index was
+     * picked for, if discarded ones were freed. */
     found_spesh = 0;
     if (spesh_cand >= 0 && spesh_cand < static_frame->body.num_spesh_candidates) {
-        MVMSpeshCandidate *chosen_cand = &static_frame->body.spesh_candidates[spesh_cand];
-        if (!chosen_cand->sg) {
+        MVMSpeshCandidate *chosen_cand = static_frame->body.spesh_candidates[spesh_cand];
+        if (!chosen_cand->sg && !chosen_cand->discarded && (!chosen_cand->check_guards ||
+                MVM_spesh_candidate_guards_pass(tc, chosen_cand, callsite, args))) {
+            chosen_cand->recent_hits++;
+            static_frame->body.spesh_hits++;
+            static_frame->body.spesh_recent_hits++;
             frame = allocate_frame(tc, static_frame, chosen_cand);
             frame->effective_bytecode    = chosen_cand->bytecode;
             frame->effective_handlers    = chosen_cand->handlers;
@@ -425,82 +431,33 @@ void MVM_frame_invoke(MVMThreadContext *tc, MVMStaticFrame *static_frame,
     }
     if (!found_spesh && ++static_frame->body.invocations >= static_frame->body.spesh_threshold && callsite->is_interned) {
         /* Look for specialized bytecode. */
-        MVMint32 num_spesh = static_frame->body.num_spesh_candidates;
-        MVMSpeshCandidate *chosen_cand = NULL;
-        MVMint32 i, j;
-        for (i = 0; i < num_spesh; i++) {
-            MVMSpeshCandidate *cand = &static_frame->body.spesh_candidates[i];
-            if (cand->cs == callsite) {
-                MVMint32 match = 1;
-                for (j = 0; j < cand->num_guards; j++) {
-                    MVMint32   pos = cand->guards[j].slot;
-                    MVMSTable *st  = (MVMSTable *)cand->guards[j].match;
-                    MVMObject *arg = args[pos].o;
-                    if (!arg) {
-                        match = 0;
-                        break;
-                    }
-                    switch (cand->guards[j].kind) {
-                    case MVM_SPESH_GUARD_CONC:
-                        if (!IS_CONCRETE(arg) || STABLE(arg) != st)
-                            match = 0;
-                        break;
-                    case MVM_SPESH_GUARD_TYPE:
-                        if (IS_CONCRETE(arg) || STABLE(arg) != st)
-                            match = 0;
-                        break;
-                    case MVM_SPESH_GUARD_DC_CONC: {
-                        MVMRegister dc;
-                        STABLE(arg)->container_spec->fetch(tc, arg, &dc);
-                        if (!dc.o || !IS_CONCRETE(dc.o) || STABLE(dc.o) != st)
-                            match = 0;
-                        break;
-                    }
-                    case MVM_SPESH_GUARD_DC_TYPE: {
-                        MVMRegister dc;
-                        STABLE(arg)->container_spec->fetch(tc, arg, &dc);
-                        if (!dc.o || IS_CONCRETE(dc.o) || STABLE(dc.o) != st)
-                            match = 0;
-                        break;
-                    }
-                    case MVM_SPESH_GUARD_DC_CONC_RW: {
-                        if (STABLE(arg)->container_spec->can_store(tc, arg)) {
-                            MVMRegister dc;
-                            STABLE(arg)->container_spec->fetch(tc, arg, &dc);
-                            if (!dc.o || !IS_CONCRETE(dc.o) || STABLE(dc.o) != st)
-                                match = 0;
-                        }
-                        else {
-                            match = 0;
-                        }
-                        break;
-                    }
-                    case MVM_SPESH_GUARD_DC_TYPE_RW: {
-                        if (STABLE(arg)->container_spec->can_store(tc, arg)) {
-                            MVMRegister dc;
-                            STABLE(arg)->container_spec->fetch(tc, arg, &dc);
-                            if (!dc.o || IS_CONCRETE(dc.o) || STABLE(dc.o) != st)
-                                match = 0;
-                        }
-                        else {
-                            match = 0;
-                        }
-                        break;
-                    }
-                    }
-                    if (!match)
-                        break;
-                }
-                if (match) {
-                    chosen_cand = cand;
-                    break;
-                }
-            }
+        MVMSpeshCandidate *chosen_cand = MVM_spesh_candidate_find(tc,
+            static_frame, callsite, args);
+        MVMint32 sample_stats;
+
+        /* Unless there's a candidate for the call already, record one in so
+         * many calls in the statistics, which decide what is worth
+         * specializing; doing every call would contend on their lock. */
+        sample_stats = !chosen_cand && tc->instance->spesh_enabled &&
+            static_frame->body.invocations % MVM_SPESH_STATS_SAMPLE_INTERVAL == 0;
+        if (sample_stats)
+            MVM_spesh_stats_record(tc, static_frame, callsite, args);
+
+        /* Count calls that had no candidate to use; frames that keep
+         * missing get more room for candidates when the GC ages them. */
+        if (!chosen_cand) {
+            static_frame->body.spesh_misses++;
+            static_frame->body.spesh_recent_misses++;
         }
 
         /* If we didn't find any, and we're below the limit, can set up a
-         * specialization. */
-        if (!chosen_cand && num_spesh < MVM_SPESH_LIMIT && tc->instance->spesh_enabled)
+         * specialization if the statistics say these argument types are
+         * common enough. They are only consulted on the calls that were
+         * recorded in them, since that takes their lock too. */
+        if (!chosen_cand && tc->instance->spesh_enabled &&
+                (sample_stats || tc->instance->spesh_nodelay) &&
+                MVM_spesh_candidate_has_room(tc, static_frame) &&
+                MVM_spesh_stats_worth_specializing(tc, static_frame, callsite, args))
             chosen_cand = MVM_spesh_candidate_setup(tc, static_frame,
                 callsite, args, 0);
 
@@ -527,6 +484,9 @@ void MVM_frame_invoke(MVMThreadContext *tc, MVMStaticFrame *static_frame,
             }
             else {
                 /* In the post-specialize phase; can safely used the code. */
+                chosen_cand->recent_hits++;
+                static_frame->body.spesh_hits++;
+                static_frame->body.spesh_recent_hits++;
                 frame = allocate_frame(tc, static_frame, chosen_cand);
                 if (chosen_cand->jitcode) {
                     frame->effective_bytecode = chosen_cand->jitcode->bytecode;
@@ -751,21 +711,28 @@ static MVMuint64 remove_one_frame(MVMThreadContext *tc, MVMuint8 unwind) {
     MVMFrame *caller   = returner->caller;
 
     /* See if we were in a logging spesh frame, and need to complete the
-     * specialization. */
+     * specialization. The work itself is handed off to the spesh worker. */
     if (returner->spesh_cand && returner->spesh_log_idx >= 0) {
-        if (returner->spesh_cand->osr_logging) {
+        MVMSpeshCandidate *cand = returner->spesh_cand;
+        if (cand->osr_logging) {
             /* Didn't achieve enough log entries to complete the OSR, but
              * clearly hot, so specialize anyway. This also avoids races
              * when the candidate is called again later and still has
-             * sp_osrfinalize instructions in it. */
-            returner->spesh_cand->osr_logging = 0;
-            MVM_spesh_candidate_specialize(tc, returner->static_info,
-                returner->spesh_cand);
+             * sp_osrfinalize instructions in it; we also make sure that
+             * nobody else starts a logging run of it meanwhile. */
+            MVM_store(&(cand->log_enter_idx), MVM_SPESH_LOG_RUNS);
+            cand->osr_logging = 0;
+            MVM_store(&(cand->logging_done), 1);
+            MVM_spesh_worker_enqueue(tc, returner->static_info);
         }
-        else if (MVM_decr(&(returner->spesh_cand->log_exits_remaining)) == 1) {
-            MVM_spesh_candidate_specialize(tc, returner->static_info,
-                returner->spesh_cand);
+        else if (MVM_decr(&(cand->log_exits_remaining)) == 1) {
+            MVM_store(&(cand->logging_done), 1);
+            MVM_spesh_worker_enqueue(tc, returner->static_info);
         }
+
+        /* Handing off may have triggered GC, so refresh our frame pointers. */
+        returner = tc->cur_frame;
+        caller   = returner->caller;
     }
 
     /* Clear up any continuation tags. */
@@ -47,6 +47,7 @@ MVMHLLConfig *MVM_hll_get_config_for(MVMThreadContext *tc, MVMString *name) {
         MVM_gc_root_add_permanent_desc(tc, (MVMCollectable **)&entry->null_value, "HLL null_value");
         MVM_gc_root_add_permanent_desc(tc, (MVMCollectable **)&entry->exit_handler, "HLL exit_handler");
         MVM_gc_root_add_permanent_desc(tc, (MVMCollectable **)&entry->finalize_handler, "HLL finalize_handler");
+        MVM_gc_root_add_permanent_desc(tc, (MVMCollectable **)&entry->gc_handler, "HLL gc_handler");
         MVM_gc_root_add_permanent_desc(tc, (MVMCollectable **)&entry->bind_error, "HLL bind_error");
         MVM_gc_root_add_permanent_desc(tc, (MVMCollectable **)&entry->method_not_found_error, "HLL method_not_found_error");
         MVM_gc_root_add_permanent_desc(tc, (MVMCollectable **)&entry->lexical_handler_not_found_error, "HLL lexical_handler_not_found_error");
@@ -113,6 +114,7 @@ MVMObject * MVM_hll_set_config(MVMThreadContext *tc, MVMString *name, MVMObject
             check_config_key(tc, config_hash, "null_value", null_value, config);
             check_config_key(tc, config_hash, "exit_handler", exit_handler, config);
             check_config_key(tc, config_hash, "finalize_handler", finalize_handler, config);
+            check_config_key(tc, config_hash, "gc_handler", gc_handler, config);
             check_config_key(tc, config_hash, "bind_error", bind_error, config);
             check_config_key(tc, config_hash, "method_not_found_error", method_not_found_error, config);
             check_config_key(tc, config_hash, "lexical_handler_not_found_error", lexical_handler_not_found_error, config);
@@ -143,6 +145,8 @@ MVMObject * MVM_hll_set_config(MVMThreadContext *tc, MVMString *name, MVMObject
         });
 
     MVM_intcache_for(tc, config->int_box_type);
+    MVM_intcache_for_num(tc, config->num_box_type);
+    MVM_intcache_for_str(tc, config->str_box_type);
 
     return config_hash;
 }
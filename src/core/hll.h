@@ -38,6 +38,10 @@ struct MVMHLLConfig {
      * which need to have a finalizer run. */
     MVMObject *finalize_handler;
 
+    /* Language's handler to run after each GC run, which is passed the GC
+     * statistics. */
+    MVMObject *gc_handler;
+
     /* Language's handler for various errors, if needed. */
     MVMObject *bind_error;
     MVMObject *method_not_found_error;
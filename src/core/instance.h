@@ -79,6 +79,7 @@ struct MVMStringConsts {
     MVMString *kind;
     MVMString *instrumented;
     MVMString *heap;
+    MVMString *cpu;
     MVMString *translate_newlines;
 };
 
@@ -94,20 +95,6 @@ struct MVMReprRegistry {
     UT_hash_handle hash_handle;
 };
 
-/* An entry in the persistent object IDs hash, used to give still-movable
- * objects a lifetime-unique ID. */
-struct MVMObjectId {
-    /* The current object address. */
-    MVMObject *current;
-
-    /* Then gen2 address that forms the persistent ID, and where we'll move
-     * the object to if it lives long enough. */
-    MVMCollectable *gen2_addr;
-
-    /* Hash handle. */
-    UT_hash_handle hash_handle;
-};
-
 /* Represents a MoarVM instance. */
 struct MVMInstance {
     /* The main thread. */
@@ -168,6 +155,10 @@ struct MVMInstance {
     /* int -> str cache */
     MVMString **int_to_str_cache;
 
+    /* Key for string hashing, chosen at random for each process so that
+     * hash collisions can't be planned in advance. */
+    MVMuint64 string_hash_key[2];
+
     /* Multi-dispatch cache and specialization installation mutexes
      * (global, as the additions are quite low contention, so no
      * real motivation to have it more fine-grained at present). */
@@ -187,6 +178,16 @@ struct MVMInstance {
     MVMint8 spesh_osr_enabled;
     MVMint8 spesh_nodelay;
 
+    /* Flag for if specialization should be done by the thread that finishes
+     * the logging, rather than by the background worker thread. */
+    MVMint8 spesh_blocking;
+
+    /* The spesh worker thread, a mutex to avoid start-races, and the queue
+     * of static frames that have candidates ready for specialization. */
+    MVMThreadContext *spesh_worker_thread;
+    uv_mutex_t        mutex_spesh_worker_start;
+    MVMObject        *spesh_queue;
+
     /* Number of specializations produced, and limit on number of
      * specializations (zero if no limit). */
     MVMint32 spesh_produced;
@@ -247,15 +248,71 @@ struct MVMInstance {
     MVMSTable *stables_to_free;
     /* Whether the current GC run is a full collection. */
     MVMuint32 gc_full_collect;
+    /* The number of threads taking part in the current GC run. */
+    MVMuint32 gc_participants;
+
+    /* Chunks of gen2 marking work that threads doing a full collection have
+     * shared, for idle threads to take. Only ever taken as a whole. */
+    MVMGCPassedWork *gc_shared_work;
+
+    /* Partitions of the gen2 heaps to be swept in parallel at the end of a
+     * full collection, along with the index of the next one to be claimed
+     * and the number still being swept. */
+    MVMGCSweepPartition *gc_sweep_partitions;
+    MVMuint32            gc_num_sweep_partitions;
+    MVMuint32            gc_alloc_sweep_partitions;
+    AO_t                 gc_sweep_next;
+    AO_t                 gc_sweep_remaining;
 
     /* How many bytes of data have we promoted from the nursery to gen2
-     * since we last did a full collection? */
+     * since we last did a full collection? And in total? */
     AO_t gc_promoted_bytes_since_last_full;
-
-    /* Persistent object ID hash, used to give nursery objects a lifetime
-     * unique ID. Plus a lock to protect it. */
-    MVMObjectId *object_ids;
-    uv_mutex_t    mutex_object_ids;
+    AO_t gc_promoted_bytes_total;
+
+    /* The number of bytes of memory of empty gen2 and fixed size allocator
+     * pages that have been given back to the OS. */
+    AO_t released_page_bytes;
+
+    /* The number of blocks in the large object space, and the bytes of
+     * memory mapped for them. */
+    AO_t los_blocks;
+    AO_t los_bytes;
+
+    /* The size the main thread's nursery starts at, and the limits thread
+     * nurseries are resized within. */
+    size_t nursery_size_initial;
+    size_t nursery_size_min;
+    size_t nursery_size_max;
+
+    /* Whether gen2 is marked incrementally, the state of the current marking
+     * cycle, if any, and how many slices it has done so far. */
+    MVMuint32 gc_incremental;
+    MVMuint32 gc_marking;
+    MVMuint32 gc_marking_slices;
+
+    /* The number of full collections completed, each of which marks all
+     * that is alive (ending a marking cycle, when marking incrementally). */
+    MVMuint32 gc_full_cycles;
+
+    /* Marked gen2 collectables whose references have yet to be marked by
+     * the incremental marking; only touched while the world is stopped. */
+    MVMCollectable **gc_mark_stack;
+    MVMuint32        gc_num_mark_stack;
+    MVMuint32        gc_alloc_mark_stack;
+
+    /* Statistics on how long GC runs kept the world stopped, by kind of
+     * run, and a file to report them to at exit, if any. Also the kind of
+     * the last run and how long it took, for the GC handler of a language. */
+    MVMGCPauseStats gc_pauses[MVM_GC_PAUSE_KINDS];
+    FILE           *gc_pause_log_fh;
+    MVMuint32       gc_last_pause_kind;
+    MVMuint64       gc_last_pause;
+
+    /* Persistent object ID tables, used to give nursery objects a lifetime
+     * unique ID, sharded by object address. And whether the types of
+     * objects asked for an ID should have their objects pretenured. */
+    MVMObjectIdShard *object_ids;
+    MVMuint32         object_id_pretenure;
 
     /* MVMThreads completed starting, running, and/or exited. */
     /* note: used atomically */
@@ -282,8 +339,8 @@ struct MVMInstance {
     MVMint64      hll_compilee_depth;
     uv_mutex_t    mutex_hllconfigs;
 
-    /* By far the most common integers are between 0 and 8, but we cache up to 15
-     * so that it lines up properly. */
+    /* Cache of boxed constants: small integers, 0e0 and 1e0, and empty and
+     * one-character strings. */
     MVMIntConstCache    *int_const_cache;
     uv_mutex_t mutex_int_const_cache;
 
@@ -370,6 +427,28 @@ struct MVMInstance {
     /* Log file for coverage logging. */
     FILE *coverage_log_fh;
 
+    /* Allocation sampling: the average bytes allocated between samples (or
+     * zero if not sampling), the log file, and the samples taken so far. */
+    MVMuint64       alloc_sample_bytes;
+    FILE           *alloc_sample_log_fh;
+    MVMAllocSample *alloc_samples;
+    MVMuint32       num_alloc_samples;
+    MVMuint32       alloc_alloc_samples;
+    uv_mutex_t      mutex_alloc_samples;
+
+    /* CPU sampling: the thread contexts the timer thread signals to take
+     * samples, whether we're sampling, the interval between samples in
+     * nanoseconds, the timer thread, the call tree of samples so far, and
+     * the log file if any. The mutex protects the thread contexts and the
+     * call tree. */
+    MVMThreadContext *cpu_sample_threads;
+    AO_t              cpu_sampling;
+    MVMuint64         cpu_sample_interval;
+    uv_thread_t       cpu_sample_thread;
+    MVMCpuSampleNode *cpu_samples;
+    uv_mutex_t        mutex_cpu_samples;
+    FILE             *cpu_sample_log_fh;
+
     /* Cached backend config hash. */
     MVMObject *cached_backend_config;
 };
@@ -1,53 +1,200 @@
 #include "moar.h"
 
+/* Reads a limit on the cache from the environment. */
+static MVMint64 limit_from_env(const char *name, MVMint64 def) {
+    char *value = getenv(name);
+    if (value && strlen(value))
+        return (MVMint64)strtoll(value, NULL, 10);
+    return def;
+}
+
+/* Sets up the cache, sized as configured. */
+void MVM_intcache_init(MVMInstance *instance) {
+    MVMIntConstCache *cache = MVM_calloc(1, sizeof(MVMIntConstCache));
+    MVMint64 max_types;
+    cache->min = limit_from_env("MVM_INT_CACHE_MIN", MVM_INTCACHE_MIN_DEFAULT);
+    cache->max = limit_from_env("MVM_INT_CACHE_MAX", MVM_INTCACHE_MAX_DEFAULT);
+    if (cache->max < cache->min || cache->max - cache->min >= MVM_INTCACHE_RANGE_LIMIT) {
+        cache->min = MVM_INTCACHE_MIN_DEFAULT;
+        cache->max = MVM_INTCACHE_MAX_DEFAULT;
+    }
+    max_types = limit_from_env("MVM_INT_CACHE_TYPES", MVM_INTCACHE_TYPES_DEFAULT);
+    cache->max_types = max_types > 0 && max_types <= 64
+        ? (MVMuint32)max_types
+        : MVM_INTCACHE_TYPES_DEFAULT;
+    cache->int_types = MVM_calloc(cache->max_types, sizeof(MVMObject *));
+    cache->int_cache = MVM_calloc(cache->max_types, sizeof(MVMObject **));
+    cache->num_types = MVM_calloc(cache->max_types, sizeof(MVMObject *));
+    cache->num_cache = MVM_calloc(cache->max_types, sizeof(MVMObject **));
+    cache->str_types = MVM_calloc(cache->max_types, sizeof(MVMObject *));
+    cache->str_cache = MVM_calloc(cache->max_types, sizeof(MVMObject **));
+    instance->int_const_cache = cache;
+}
+
+/* Finds the slot of a type among those cached for a kind of constant, or
+ * -1 if it isn't cached. Types are filled in from the start, so we can stop
+ * at the first empty slot. */
+static MVMint32 find_type(MVMIntConstCache *cache, MVMObject **types, MVMObject *type) {
+    MVMuint32 i;
+    for (i = 0; i < cache->max_types && types[i]; i++)
+        if (types[i] == type)
+            return i;
+    return -1;
+}
+
+/* Finds a free slot for a type to cache a kind of constant for, or -1 if it
+ * is cached already or there's no room. Must hold the lock. */
+static MVMint32 free_slot(MVMIntConstCache *cache, MVMObject **types, MVMObject *type) {
+    MVMuint32 i;
+    for (i = 0; i < cache->max_types; i++) {
+        if (types[i] == NULL)
+            return i;
+        if (types[i] == type)
+            return -1;
+    }
+    return -1;
+}
+
+/* Installs the boxes for a type, then the type, so that lookups that find
+ * the type also find its boxes. */
+static void install(MVMObject **types, MVMObject ***caches, MVMint32 slot,
+                    MVMObject *type, MVMObject **boxes) {
+    caches[slot] = boxes;
+    MVM_barrier();
+    types[slot] = type;
+}
+
 void MVM_intcache_for(MVMThreadContext *tc, MVMObject *type) {
-    int type_index;
-    int right_slot = -1;
+    MVMIntConstCache *cache = tc->instance->int_const_cache;
+    MVMint32 slot;
     uv_mutex_lock(&tc->instance->mutex_int_const_cache);
-    for (type_index = 0; type_index < 4; type_index++) {
-        if (tc->instance->int_const_cache->types[type_index] == NULL) {
-            right_slot = type_index;
-            break;
+    if ((slot = free_slot(cache, cache->int_types, type)) >= 0) {
+        MVMObject **boxes = MVM_malloc((cache->max - cache->min + 1) * sizeof(MVMObject *));
+        MVMint64 val;
+        /* Allocating in gen2 means no GC run can happen before the boxes
+         * are installed and so marked. */
+        MVM_gc_allocate_gen2_default_set(tc);
+        for (val = cache->min; val <= cache->max; val++) {
+            MVMObject *obj = MVM_repr_alloc_init(tc, type);
+            MVM_repr_set_int(tc, obj, val);
+            boxes[val - cache->min] = obj;
         }
-        else if (tc->instance->int_const_cache->types[type_index] == type) {
-            uv_mutex_unlock(&tc->instance->mutex_int_const_cache);
-            return;
+        MVM_gc_allocate_gen2_default_clear(tc);
+        install(cache->int_types, cache->int_cache, slot, type, boxes);
+    }
+    uv_mutex_unlock(&tc->instance->mutex_int_const_cache);
+}
+
+void MVM_intcache_for_num(MVMThreadContext *tc, MVMObject *type) {
+    MVMIntConstCache *cache = tc->instance->int_const_cache;
+    MVMint32 slot;
+    uv_mutex_lock(&tc->instance->mutex_int_const_cache);
+    if ((slot = free_slot(cache, cache->num_types, type)) >= 0) {
+        MVMObject **boxes = MVM_malloc(MVM_INTCACHE_NUMS * sizeof(MVMObject *));
+        MVMint32 i;
+        MVM_gc_allocate_gen2_default_set(tc);
+        for (i = 0; i < MVM_INTCACHE_NUMS; i++) {
+            MVMObject *obj = MVM_repr_alloc_init(tc, type);
+            MVM_repr_set_num(tc, obj, (MVMnum64)i);
+            boxes[i] = obj;
         }
+        MVM_gc_allocate_gen2_default_clear(tc);
+        install(cache->num_types, cache->num_cache, slot, type, boxes);
     }
-    if (right_slot != -1) {
-        int val;
-        for (val = -1; val < 15; val++) {
-            MVMObject *obj;
-            obj = MVM_repr_alloc_init(tc, type);
-            MVM_repr_set_int(tc, obj, val);
-            tc->instance->int_const_cache->cache[type_index][val + 1] = obj;
-            MVM_gc_root_add_permanent_desc(tc,
-                (MVMCollectable **)&tc->instance->int_const_cache->cache[type_index][val + 1],
-                "Boxed integer cache entry");
+    uv_mutex_unlock(&tc->instance->mutex_int_const_cache);
+}
+
+void MVM_intcache_for_str(MVMThreadContext *tc, MVMObject *type) {
+    MVMIntConstCache *cache = tc->instance->int_const_cache;
+    MVMint32 slot;
+    uv_mutex_lock(&tc->instance->mutex_int_const_cache);
+    if ((slot = free_slot(cache, cache->str_types, type)) >= 0) {
+        MVMObject **boxes = MVM_malloc(MVM_INTCACHE_STRS * sizeof(MVMObject *));
+        MVMint32 i;
+        MVM_gc_allocate_gen2_default_set(tc);
+        for (i = 0; i < MVM_INTCACHE_STRS; i++) {
+            MVMObject *obj = MVM_repr_alloc_init(tc, type);
+            MVM_repr_set_str(tc, obj, i == 0
+                ? tc->instance->str_consts.empty
+                : MVM_string_chr(tc, i - 1));
+            boxes[i] = obj;
         }
-        tc->instance->int_const_cache->types[type_index] = type;
-        MVM_gc_root_add_permanent_desc(tc,
-            (MVMCollectable **)&tc->instance->int_const_cache->types[type_index],
-            "Boxed integer cache type");
+        MVM_gc_allocate_gen2_default_clear(tc);
+        install(cache->str_types, cache->str_cache, slot, type, boxes);
     }
     uv_mutex_unlock(&tc->instance->mutex_int_const_cache);
 }
 
 MVMObject *MVM_intcache_get(MVMThreadContext *tc, MVMObject *type, MVMint64 value) {
-    int type_index;
-    int right_slot = -1;
+    MVMIntConstCache *cache = tc->instance->int_const_cache;
+    MVMint32 slot;
 
-    if (value < -1 || value >= 15)
+    if (value < cache->min || value > cache->max)
         return NULL;
 
-    for (type_index = 0; type_index < 4; type_index++) {
-        if (tc->instance->int_const_cache->types[type_index] == type) {
-            right_slot = type_index;
-            break;
-        }
+    slot = find_type(cache, cache->int_types, type);
+    if (slot != -1)
+        return cache->int_cache[slot][value - cache->min];
+    return NULL;
+}
+
+MVMObject *MVM_intcache_get_num(MVMThreadContext *tc, MVMObject *type, MVMnum64 value) {
+    MVMIntConstCache *cache = tc->instance->int_const_cache;
+    MVMnum64 zero = 0.0;
+    MVMint32 index, slot;
+
+    /* Compare the bits, so -0e0 is not taken for 0e0. */
+    if (memcmp(&value, &zero, sizeof(MVMnum64)) == 0)
+        index = 0;
+    else if (value == 1.0)
+        index = 1;
+    else
+        return NULL;
+
+    slot = find_type(cache, cache->num_types, type);
+    if (slot != -1)
+        return cache->num_cache[slot][index];
+    return NULL;
+}
+
+MVMObject *MVM_intcache_get_str(MVMThreadContext *tc, MVMObject *type, MVMString *value) {
+    MVMIntConstCache *cache = tc->instance->int_const_cache;
+    MVMint32 index, slot;
+
+    if (!value)
+        return NULL;
+    if (value->body.num_graphs == 0) {
+        index = 0;
+    }
+    else if (value->body.num_graphs == 1) {
+        MVMGrapheme32 g = MVM_string_get_grapheme_at_nocheck(tc, value, 0);
+        if (g < 0 || g >= MVM_INTCACHE_STRS - 1)
+            return NULL;
+        index = g + 1;
     }
-    if (right_slot != -1) {
-        return tc->instance->int_const_cache->cache[right_slot][value + 1];
+    else {
+        return NULL;
     }
+
+    slot = find_type(cache, cache->str_types, type);
+    if (slot != -1)
+        return cache->str_cache[slot][index];
     return NULL;
 }
+
+void MVM_intcache_destroy(MVMInstance *instance) {
+    MVMIntConstCache *cache = instance->int_const_cache;
+    MVMuint32 i;
+    for (i = 0; i < cache->max_types; i++) {
+        MVM_free(cache->int_cache[i]);
+        MVM_free(cache->num_cache[i]);
+        MVM_free(cache->str_cache[i]);
+    }
+    MVM_free(cache->int_types);
+    MVM_free(cache->int_cache);
+    MVM_free(cache->num_types);
+    MVM_free(cache->num_cache);
+    MVM_free(cache->str_types);
+    MVM_free(cache->str_cache);
+    MVM_free(cache);
+}
@@ -1,7 +1,51 @@
+/* Cache of boxed constants: small integers, the nums 0e0 and 1e0, and the
+ * empty and one-character (ASCII) strings, for each of a number of box
+ * types (typically those of the HLLs in use). The cached objects are
+ * allocated in gen2 and marked as instance roots. The range of integers and
+ * the number of types are set at startup, by MVM_INT_CACHE_MIN,
+ * MVM_INT_CACHE_MAX and MVM_INT_CACHE_TYPES. */
+
+/* Default range of integers cached, inclusive. */
+#define MVM_INTCACHE_MIN_DEFAULT    -128
+#define MVM_INTCACHE_MAX_DEFAULT    1023
+
+/* Default number of types for which we cache each kind of constant. */
+#define MVM_INTCACHE_TYPES_DEFAULT  4
+
+/* Limit on the number of integers cached per type. */
+#define MVM_INTCACHE_RANGE_LIMIT    65536
+
+/* Number of nums cached per type (0e0 and 1e0). */
+#define MVM_INTCACHE_NUMS           2
+
+/* Number of strings cached per type: the empty one, then one for each of
+ * the ASCII characters. */
+#define MVM_INTCACHE_STRS           129
+
 struct MVMIntConstCache {
-    MVMObject *types[4];
-    MVMObject *cache[4][16];
+    /* The range of integers cached, inclusive. */
+    MVMint64 min;
+    MVMint64 max;
+
+    /* The number of types we can cache each kind of constant for. */
+    MVMuint32 max_types;
+
+    /* The types of each kind, and for each type its cached boxes. A type
+     * is only set once its boxes are all in place, so they can be looked
+     * up without taking the lock. */
+    MVMObject  **int_types;
+    MVMObject ***int_cache;
+    MVMObject  **num_types;
+    MVMObject ***num_cache;
+    MVMObject  **str_types;
+    MVMObject ***str_cache;
 };
 
+void MVM_intcache_init(MVMInstance *instance);
 void MVM_intcache_for(MVMThreadContext *tc, MVMObject *type);
+void MVM_intcache_for_num(MVMThreadContext *tc, MVMObject *type);
+void MVM_intcache_for_str(MVMThreadContext *tc, MVMObject *type);
 MVMObject *MVM_intcache_get(MVMThreadContext *tc, MVMObject *type, MVMint64 value);
+MVMObject *MVM_intcache_get_num(MVMThreadContext *tc, MVMObject *type, MVMnum64 value);
+MVMObject *MVM_intcache_get_str(MVMThreadContext *tc, MVMObject *type, MVMString *value);
+void MVM_intcache_destroy(MVMInstance *instance);
@@ -4396,6 +4396,10 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
             OP(force_gc):
                 MVM_gc_enter_from_allocator(tc);
                 goto NEXT;
+            OP(gcstats):
+                GET_REG(cur_op, 0).o = MVM_gc_stats(tc);
+                cur_op += 2;
+                goto NEXT;
             OP(nativecallglobal):
                 GET_REG(cur_op, 0).o = MVM_nativecall_global(tc, GET_REG(cur_op, 2).s,
                     GET_REG(cur_op, 4).s, GET_REG(cur_op, 6).o, GET_REG(cur_op, 8).o);
@@ -5352,14 +5356,10 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 goto NEXT;
             }
             OP(sp_fastcreate): {
-                /* Assume we're in normal code, so doing a nursery allocation.
-                 * Also, that there is no initialize. */
-                MVMuint16 size       = GET_UI16(cur_op, 2);
-                MVMObject *obj       = MVM_gc_allocate_zeroed(tc, size);
-                obj->st              = (MVMSTable *)tc->cur_frame->effective_spesh_slots[GET_UI16(cur_op, 4)];
-                obj->header.size     = size;
-                obj->header.owner    = tc->thread_id;
-                GET_REG(cur_op, 0).o = obj;
+                /* Assume there is no initialize. */
+                GET_REG(cur_op, 0).o = MVM_gc_allocate_fastcreate(tc,
+                    (MVMSTable *)tc->cur_frame->effective_spesh_slots[GET_UI16(cur_op, 4)],
+                    GET_UI16(cur_op, 2));
                 cur_op += 6;
                 goto NEXT;
             }
@@ -5639,6 +5639,15 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 cur_op += 20;
                 goto NEXT;
             }
+            OP(sp_guardobj): {
+                MVMObject *check = GET_REG(cur_op, 0).o;
+                MVMObject *want  = (MVMObject *)tc->cur_frame
+                    ->effective_spesh_slots[GET_UI16(cur_op, 2)];
+                cur_op += 4;
+                if (check != want)
+                    MVM_spesh_deopt_one(tc);
+                goto NEXT;
+            }
 #if MVM_CGOTO
             OP_CALL_EXTOP: {
                 /* Bounds checking? Never heard of that. */
@@ -762,6 +762,7 @@ static const void * const LABELS[] = {
     &&OP_setdispatcherfor,
     &&OP_getstrfromname,
     &&OP_indexic_s,
+    &&OP_gcstats,
     &&OP_sp_log,
     &&OP_sp_osrfinalize,
     &&OP_sp_guardconc,
@@ -823,8 +824,7 @@ static const void * const LABELS[] = {
     &&OP_prof_allocated,
     &&OP_ctw_check,
     &&OP_coverage_log,
-    NULL,
-    NULL,
+    &&OP_sp_guardobj,
     NULL,
     NULL,
     NULL,
@@ -2755,7 +2755,7 @@ static const MVMOpInfo MVM_op_infos[] = {
         "  ",
         3,
         1,
-        0,
+        1,
         0,
         1,
         { MVM_operand_write_reg | MVM_operand_obj, MVM_operand_read_reg | MVM_operand_obj, MVM_operand_str }
@@ -2766,7 +2766,7 @@ static const MVMOpInfo MVM_op_infos[] = {
         "  ",
         3,
         1,
-        0,
+        1,
         0,
         1,
         { MVM_operand_write_reg | MVM_operand_obj, MVM_operand_read_reg | MVM_operand_obj, MVM_operand_read_reg | MVM_operand_str }
@@ -8364,6 +8364,17 @@ static const MVMOpInfo MVM_op_infos[] = {
         0,
         { MVM_operand_write_reg | MVM_operand_int64, MVM_operand_read_reg | MVM_operand_str, MVM_operand_read_reg | MVM_operand_str, MVM_operand_read_reg | MVM_operand_int64 }
     },
+    {
+        MVM_OP_gcstats,
+        "gcstats",
+        "  ",
+        1,
+        0,
+        0,
+        0,
+        0,
+        { MVM_operand_write_reg | MVM_operand_obj }
+    },
     {
         MVM_OP_sp_log,
         "sp_log",
@@ -9031,9 +9042,20 @@ static const MVMOpInfo MVM_op_infos[] = {
         0,
         { MVM_operand_str, MVM_operand_int32, MVM_operand_int32, MVM_operand_int64 }
     },
+    {
+        MVM_OP_sp_guardobj,
+        "sp_guardobj",
+        ".s",
+        2,
+        0,
+        0,
+        0,
+        0,
+        { MVM_operand_read_reg | MVM_operand_obj, MVM_operand_spesh_slot }
+    },
 };
 
-static const unsigned short MVM_op_counts = 822;
+static const unsigned short MVM_op_counts = 824;
 
 MVM_PUBLIC const MVMOpInfo * MVM_op_get_op(unsigned short op) {
     if (op >= MVM_op_counts)
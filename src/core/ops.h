@@ -762,67 +762,69 @@
 #define MVM_OP_setdispatcherfor 758
 #define MVM_OP_getstrfromname 759
 #define MVM_OP_indexic_s 760
-#define MVM_OP_sp_log 761
-#define MVM_OP_sp_osrfinalize 762
-#define MVM_OP_sp_guardconc 763
-#define MVM_OP_sp_guardtype 764
-#define MVM_OP_sp_guardcontconc 765
-#define MVM_OP_sp_guardconttype 766
-#define MVM_OP_sp_guardrwconc 767
-#define MVM_OP_sp_guardrwtype 768
-#define MVM_OP_sp_getarg_o 769
-#define MVM_OP_sp_getarg_i 770
-#define MVM_OP_sp_getarg_n 771
-#define MVM_OP_sp_getarg_s 772
-#define MVM_OP_sp_fastinvoke_v 773
-#define MVM_OP_sp_fastinvoke_i 774
-#define MVM_OP_sp_fastinvoke_n 775
-#define MVM_OP_sp_fastinvoke_s 776
-#define MVM_OP_sp_fastinvoke_o 777
-#define MVM_OP_sp_namedarg_used 778
-#define MVM_OP_sp_getspeshslot 779
-#define MVM_OP_sp_findmeth 780
-#define MVM_OP_sp_fastcreate 781
-#define MVM_OP_sp_get_o 782
-#define MVM_OP_sp_get_i64 783
-#define MVM_OP_sp_get_i32 784
-#define MVM_OP_sp_get_i16 785
-#define MVM_OP_sp_get_i8 786
-#define MVM_OP_sp_get_n 787
-#define MVM_OP_sp_get_s 788
-#define MVM_OP_sp_bind_o 789
-#define MVM_OP_sp_bind_i64 790
-#define MVM_OP_sp_bind_i32 791
-#define MVM_OP_sp_bind_i16 792
-#define MVM_OP_sp_bind_i8 793
-#define MVM_OP_sp_bind_n 794
-#define MVM_OP_sp_bind_s 795
-#define MVM_OP_sp_p6oget_o 796
-#define MVM_OP_sp_p6ogetvt_o 797
-#define MVM_OP_sp_p6ogetvc_o 798
-#define MVM_OP_sp_p6oget_i 799
-#define MVM_OP_sp_p6oget_n 800
-#define MVM_OP_sp_p6oget_s 801
-#define MVM_OP_sp_p6obind_o 802
-#define MVM_OP_sp_p6obind_i 803
-#define MVM_OP_sp_p6obind_n 804
-#define MVM_OP_sp_p6obind_s 805
-#define MVM_OP_sp_deref_get_i64 806
-#define MVM_OP_sp_deref_get_n 807
-#define MVM_OP_sp_deref_bind_i64 808
-#define MVM_OP_sp_deref_bind_n 809
-#define MVM_OP_sp_jit_enter 810
-#define MVM_OP_sp_boolify_iter 811
-#define MVM_OP_sp_boolify_iter_arr 812
-#define MVM_OP_sp_boolify_iter_hash 813
-#define MVM_OP_prof_enter 814
-#define MVM_OP_prof_enterspesh 815
-#define MVM_OP_prof_enterinline 816
-#define MVM_OP_prof_enternative 817
-#define MVM_OP_prof_exit 818
-#define MVM_OP_prof_allocated 819
-#define MVM_OP_ctw_check 820
-#define MVM_OP_coverage_log 821
+#define MVM_OP_gcstats 761
+#define MVM_OP_sp_log 762
+#define MVM_OP_sp_osrfinalize 763
+#define MVM_OP_sp_guardconc 764
+#define MVM_OP_sp_guardtype 765
+#define MVM_OP_sp_guardcontconc 766
+#define MVM_OP_sp_guardconttype 767
+#define MVM_OP_sp_guardrwconc 768
+#define MVM_OP_sp_guardrwtype 769
+#define MVM_OP_sp_getarg_o 770
+#define MVM_OP_sp_getarg_i 771
+#define MVM_OP_sp_getarg_n 772
+#define MVM_OP_sp_getarg_s 773
+#define MVM_OP_sp_fastinvoke_v 774
+#define MVM_OP_sp_fastinvoke_i 775
+#define MVM_OP_sp_fastinvoke_n 776
+#define MVM_OP_sp_fastinvoke_s 777
+#define MVM_OP_sp_fastinvoke_o 778
+#define MVM_OP_sp_namedarg_used 779
+#define MVM_OP_sp_getspeshslot 780
+#define MVM_OP_sp_findmeth 781
+#define MVM_OP_sp_fastcreate 782
+#define MVM_OP_sp_get_o 783
+#define MVM_OP_sp_get_i64 784
+#define MVM_OP_sp_get_i32 785
+#define MVM_OP_sp_get_i16 786
+#define MVM_OP_sp_get_i8 787
+#define MVM_OP_sp_get_n 788
+#define MVM_OP_sp_get_s 789
+#define MVM_OP_sp_bind_o 790
+#define MVM_OP_sp_bind_i64 791
+#define MVM_OP_sp_bind_i32 792
+#define MVM_OP_sp_bind_i16 793
+#define MVM_OP_sp_bind_i8 794
+#define MVM_OP_sp_bind_n 795
+#define MVM_OP_sp_bind_s 796
+#define MVM_OP_sp_p6oget_o 797
+#define MVM_OP_sp_p6ogetvt_o 798
+#define MVM_OP_sp_p6ogetvc_o 799
+#define MVM_OP_sp_p6oget_i 800
+#define MVM_OP_sp_p6oget_n 801
+#define MVM_OP_sp_p6oget_s 802
+#define MVM_OP_sp_p6obind_o 803
+#define MVM_OP_sp_p6obind_i 804
+#define MVM_OP_sp_p6obind_n 805
+#define MVM_OP_sp_p6obind_s 806
+#define MVM_OP_sp_deref_get_i64 807
+#define MVM_OP_sp_deref_get_n 808
+#define MVM_OP_sp_deref_bind_i64 809
+#define MVM_OP_sp_deref_bind_n 810
+#define MVM_OP_sp_jit_enter 811
+#define MVM_OP_sp_boolify_iter 812
+#define MVM_OP_sp_boolify_iter_arr 813
+#define MVM_OP_sp_boolify_iter_hash 814
+#define MVM_OP_prof_enter 815
+#define MVM_OP_prof_enterspesh 816
+#define MVM_OP_prof_enterinline 817
+#define MVM_OP_prof_enternative 818
+#define MVM_OP_prof_exit 819
+#define MVM_OP_prof_allocated 820
+#define MVM_OP_ctw_check 821
+#define MVM_OP_coverage_log 822
+#define MVM_OP_sp_guardobj 823
 
 #define MVM_OP_EXT_BASE 1024
 #define MVM_OP_EXT_CU_LIMIT 1024
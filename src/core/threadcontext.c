@@ -26,10 +26,16 @@ MVMThreadContext * MVM_tc_create(MVMThreadContext *parent, MVMInstance *instance
     }
 
     /* Set up GC nursery. We only allocate tospace initially, and allocate
-     * fromspace the first time this thread GCs, provided it ever does. */
-    tc->nursery_tospace     = MVM_calloc(1, MVM_NURSERY_SIZE);
+     * fromspace the first time this thread GCs, provided it ever does. The
+     * main thread starts with the initial size, others with the minimum,
+     * and grow if they turn out to allocate a lot. */
+    tc->nursery_size        = instance->main_thread
+        ? instance->nursery_size_min
+        : instance->nursery_size_initial;
+    tc->nursery_tospace     = MVM_calloc(1, tc->nursery_size);
     tc->nursery_alloc       = tc->nursery_tospace;
-    tc->nursery_alloc_limit = (char *)tc->nursery_alloc + MVM_NURSERY_SIZE;
+    tc->nursery_alloc_limit = (char *)tc->nursery_alloc + tc->nursery_size;
+    tc->nursery_last_gc     = uv_hrtime();
 
     /* Set up temporary root handling. */
     tc->num_temproots   = 0;
@@ -61,6 +67,9 @@ MVMThreadContext * MVM_tc_create(MVMThreadContext *parent, MVMInstance *instance
      * need to check. */
     tc->last_payload = instance->VMNull;
 
+    /* Let the CPU sampler signal this thread. */
+    MVM_profile_cpu_add_thread(tc);
+
     return tc;
 }
 
@@ -70,6 +79,9 @@ MVMThreadContext * MVM_tc_create(MVMThreadContext *parent, MVMInstance *instance
  * objects from this nursery to the second generation. Only after
  * that is true should this be called. */
 void MVM_tc_destroy(MVMThreadContext *tc) {
+    /* Make sure the CPU sampler won't signal this thread any more. */
+    MVM_profile_cpu_remove_thread(tc);
+
     /* We run once again (non-blocking) to eventually close filehandles. */
     uv_run(tc->loop, UV_RUN_NOWAIT);
 
@@ -91,6 +103,7 @@ void MVM_tc_destroy(MVMThreadContext *tc) {
     MVM_free(tc->gc_work);
     MVM_free(tc->temproots);
     MVM_free(tc->gen2roots);
+    MVM_free(tc->gc_grey);
     MVM_free(tc->finalize);
 
     /* Free any memory allocated for NFAs and multi-dim indices. */
@@ -19,7 +19,12 @@ typedef enum {
      * run was triggered and the scanning work was stolen. A thread
      * that becomes unblocked upon seeing this will wait for the GC
      * run to be done. */
-    MVMGCStatus_STOLEN = 3
+    MVMGCStatus_STOLEN = 3,
+
+    /* Set by the CPU sampler's timer thread on a thread that is executing,
+     * to ask it to sample its call stack at its next safe point. If a GC
+     * run is triggered first, it is turned into an interrupt. */
+    MVMGCStatus_SAMPLE = 4
 } MVMGCStatus;
 
 /* Information associated with an executing thread. */
@@ -31,9 +36,19 @@ struct MVMThreadContext {
     /* The end of the space we're allowed to allocate to. */
     void *nursery_alloc_limit;
 
+    /* Bytes left to allocate in the nursery before the next allocation
+     * sample is taken; out of reach if we're not sampling. */
+    MVMint64 alloc_sample_countdown;
+
     /* This thread's GC status. */
     AO_t gc_status;
 
+    /* The next thread context the CPU sampler's timer thread signals, and
+     * where JIT compiled code last stopped at a GC sync point, to find the
+     * active inlines if it was for a sample. */
+    MVMThreadContext *cpu_sample_next;
+    void             *cpu_sample_jit_label;
+
     /* Non-zero is we should allocate in gen2; incremented/decremented as we
      * enter/leave a region wanting gen2 allocation. */
     MVMuint32 allocate_in_gen2;
@@ -107,12 +122,28 @@ struct MVMThreadContext {
      * allocate new ones. */
     void *nursery_tospace;
 
+    /* The sizes of tospace and fromspace, which differ for one collection
+     * after the nursery is resized. */
+    size_t nursery_size;
+    size_t nursery_fromspace_size;
+
+    /* What survived in the nursery at the last collection, when it was, and
+     * how many collections in a row found the nursery little used; these
+     * decide the nursery size. */
+    size_t    nursery_survived;
+    MVMuint64 nursery_last_gc;
+    MVMuint32 nursery_idle_runs;
+
     /* The second GC generation allocator. */
     MVMGen2Allocator *gen2;
 
     /* Number of bytes promoted to gen2 in current GC run. */
     MVMuint32 gc_promoted_bytes;
 
+    /* Number of bytes allocated directly in gen2 by pretenuring since the
+     * last GC run. */
+    MVMuint32 gc_pretenured_bytes;
+
     /* Memory buffer pointing to the last thing we serialized, intended to go
      * into the next compilation unit we write. Also the serialized string
      * heap, which will be used to seed the compilation unit string heap. */
@@ -137,6 +168,12 @@ struct MVMThreadContext {
     MVMuint32             alloc_gen2roots;
     MVMCollectable      **gen2roots;
 
+    /* Gen2 collectables marked during an incremental marking cycle whose
+     * references have yet to be marked. */
+    MVMuint32             num_gc_grey;
+    MVMuint32             alloc_gc_grey;
+    MVMCollectable      **gc_grey;
+
     /* Finalize queue objects, which need to have a finalizer invoked once
      * they are no longer referenced from anywhere except this queue. */
     MVMuint32             num_finalize;
@@ -206,6 +243,13 @@ struct MVMThreadContext {
     /* Profiling data collected for this thread, if profiling is on. */
     MVMProfileThreadData *prof_data;
 
+    /* The allocation sample waiting for its object's header to be filled
+     * in, the static frame that made the allocation, and the state of the
+     * generator of intervals between samples. */
+    MVMCollectable *alloc_sample_obj;
+    MVMStaticFrame *alloc_sample_sf;
+    MVMuint64       alloc_sample_rand;
+
     /* Frame sequence numbers in order to cheaply identify the place of a frame
      * in the call stack */
     MVMint32 current_frame_nr;
@@ -27,7 +27,7 @@ void * MVM_gc_allocate_nursery(MVMThreadContext *tc, size_t size) {
          * second generation. Note that this circumstance is exceptionally
          * unlikely in any non-contrived situation. */
         while ((char *)tc->nursery_alloc + size >= (char *)tc->nursery_alloc_limit) {
-            if (size > MVM_NURSERY_SIZE)
+            if (size > tc->nursery_size)
                 MVM_panic(MVM_exitcode_gcalloc, "Attempt to allocate more than the maximum nursery size");
             MVM_gc_enter_from_allocator(tc);
         }
@@ -35,6 +35,11 @@ void * MVM_gc_allocate_nursery(MVMThreadContext *tc, size_t size) {
         /* Allocate (just bump the pointer). */
         allocated = tc->nursery_alloc;
         tc->nursery_alloc = (char *)tc->nursery_alloc + size;
+
+        /* Sample the allocation if we've allocated enough since the last
+         * sample (never, unless sampling is on). */
+        if ((tc->alloc_sample_countdown -= size) <= 0)
+            MVM_profile_alloc_sample(tc, allocated);
     }
     else {
         MVM_panic(MVM_exitcode_gcalloc, "Cannot allocate 0 bytes of memory in the nursery");
@@ -80,9 +85,32 @@ MVMObject * MVM_gc_allocate_type_object(MVMThreadContext *tc, MVMSTable *st) {
     return obj;
 }
 
+/* Starts a new survival sample for a type. */
+static void start_sample(MVMThreadContext *tc, MVMSTable *st) {
+    st->pretenure_allocs     = 0;
+    st->pretenure_promotions = 0;
+    st->pretenure_sample_gc  = (MVMuint32)MVM_load(&tc->instance->gc_seq_number);
+}
+
+/* Counts an allocation of an object of a type in the nursery, and once the
+ * sample is over, decides whether to pretenure the type's objects. */
+static void sample_allocation(MVMThreadContext *tc, MVMSTable *st) {
+    if (++st->pretenure_allocs >= MVM_GC_PRETENURE_SAMPLE
+            && (MVMuint32)MVM_load(&tc->instance->gc_seq_number) - st->pretenure_sample_gc
+                >= MVM_GC_PRETENURE_SAMPLE_GCS) {
+        if ((MVMuint64)st->pretenure_promotions * 100
+                >= (MVMuint64)st->pretenure_allocs * MVM_GC_PRETENURE_SURVIVAL)
+            MVM_store(&st->pretenure_left, MVM_GC_PRETENURE_ALLOCS);
+        else
+            start_sample(tc, st);
+    }
+}
+
 /* Allocates a new object, and points it at the specified STable. */
 MVMObject * MVM_gc_allocate_object(MVMThreadContext *tc, MVMSTable *st) {
     MVMObject *obj;
+    if (!tc->allocate_in_gen2)
+        sample_allocation(tc, st);
     MVMROOT(tc, st, {
         obj               = MVM_gc_allocate_zeroed(tc, st->size);
         obj->header.size  = (MVMuint16)st->size;
@@ -94,6 +122,49 @@ MVMObject * MVM_gc_allocate_object(MVMThreadContext *tc, MVMSTable *st) {
     return obj;
 }
 
+/* Allocates an object for sp_fastcreate, which spesh only uses for types
+ * with no initialize and that need no finalization. If the type's objects
+ * are being pretenured, it is allocated in gen2. The write barrier applies
+ * to it from then on as to any gen2 object; for the STable it is applied
+ * here. While gen2 is being marked incrementally, it is allocated marked,
+ * like objects promoted then. */
+MVMObject * MVM_gc_allocate_fastcreate(MVMThreadContext *tc, MVMSTable *st, MVMuint16 size) {
+    MVMObject *obj;
+    AO_t       left = tc->allocate_in_gen2 ? 0 : MVM_load(&st->pretenure_left);
+
+    /* Claim one of the allocations left in gen2, if there are any; other
+     * threads may be doing the same. */
+    while (left) {
+        AO_t seen = MVM_cas(&st->pretenure_left, left, left - 1);
+        if (seen == left)
+            break;
+        left = seen;
+    }
+
+    if (left) {
+        if (left == 1)
+            start_sample(tc, st);
+        obj = MVM_gc_gen2_allocate_zeroed(tc->gen2, size);
+        if (tc->instance->gc_marking)
+            obj->header.flags |= MVM_CF_GEN2_LIVE;
+        obj->header.size  = size;
+        obj->header.owner = tc->thread_id;
+        MVM_ASSIGN_REF(tc, &(obj->header), obj->st, st);
+        tc->gc_pretenured_bytes += size;
+    }
+    else {
+        if (!tc->allocate_in_gen2)
+            sample_allocation(tc, st);
+        MVMROOT(tc, st, {
+            obj = MVM_gc_allocate_zeroed(tc, size);
+        });
+        obj->header.size  = size;
+        obj->header.owner = tc->thread_id;
+        MVM_ASSIGN_REF(tc, &(obj->header), obj->st, st);
+    }
+    return obj;
+}
+
 /* Allocates a new heap frame. */
 MVMFrame * MVM_gc_allocate_frame(MVMThreadContext *tc) {
     MVMFrame *f = MVM_gc_allocate_zeroed(tc, sizeof(MVMFrame));
@@ -3,6 +3,7 @@ void * MVM_gc_allocate_zeroed(MVMThreadContext *tc, size_t size);
 MVMSTable * MVM_gc_allocate_stable(MVMThreadContext *tc, const MVMREPROps *repr, MVMObject *how);
 MVMObject * MVM_gc_allocate_type_object(MVMThreadContext *tc, MVMSTable *st);
 MVMObject * MVM_gc_allocate_object(MVMThreadContext *tc, MVMSTable *st);
+MVMObject * MVM_gc_allocate_fastcreate(MVMThreadContext *tc, MVMSTable *st, MVMuint16 size);
 MVMFrame * MVM_gc_allocate_frame(MVMThreadContext *tc);
 void MVM_gc_allocate_gen2_default_set(MVMThreadContext *tc);
 void MVM_gc_allocate_gen2_default_clear(MVMThreadContext *tc);
@@ -12,3 +13,15 @@ MVM_STATIC_INLINE void * MVM_gc_allocate(MVMThreadContext *tc, size_t size) {
         ? MVM_gc_gen2_allocate_zeroed(tc->gen2, size)
         : MVM_gc_allocate_nursery(tc, size);
 }
+
+/* Pretenuring. Each type samples how many of the objects allocated for it
+ * in the nursery go on to be promoted to gen2. If nearly all of them do,
+ * the sp_fastcreate instructions for it allocate their objects directly in
+ * gen2 for a while, rather than copying them twice first, until the type
+ * is sampled again. A sample runs for at least MVM_GC_PRETENURE_SAMPLE
+ * allocations and MVM_GC_PRETENURE_SAMPLE_GCS GC runs, so the objects
+ * allocated in it have had the chance to be promoted. */
+#define MVM_GC_PRETENURE_SAMPLE         1024
+#define MVM_GC_PRETENURE_SAMPLE_GCS     3
+#define MVM_GC_PRETENURE_SURVIVAL       90      /* Percent promoted. */
+#define MVM_GC_PRETENURE_ALLOCS         65536   /* Before sampling again. */
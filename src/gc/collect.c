@@ -17,7 +17,48 @@ typedef struct {
 static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, WorkToPass *wtp, MVMuint8 gen);
 static void pass_work_item(MVMThreadContext *tc, WorkToPass *wtp, MVMCollectable **item_ptr);
 static void pass_leftover_work(MVMThreadContext *tc, WorkToPass *wtp);
-static void add_in_tray_to_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist);
+static void add_in_tray_to_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist,
+    MVMGCPassedWork * volatile *in_tray);
+
+/* Decides the size of a thread's nursery after a collection, going on the
+ * state of the nursery being collected. One that fills up quickly is being
+ * used by a thread doing a lot of allocation, which a bigger nursery will
+ * have to collect less often; likewise, one where a lot survived the last
+ * collection gives objects more time to die if it is bigger. One that is
+ * little used collection after collection belongs to a mostly idle thread,
+ * and is shrunk; it never shrinks to less than what survivors may need. */
+static size_t next_nursery_size(MVMThreadContext *tc) {
+    MVMInstance *instance = tc->instance;
+    size_t       size     = tc->nursery_size;
+    size_t       used     = (char *)tc->nursery_alloc - (char *)tc->nursery_tospace;
+    MVMuint64    now      = uv_hrtime();
+    MVMuint64    interval = now - tc->nursery_last_gc;
+    tc->nursery_last_gc = now;
+
+    /* If it's (nearly) full and we didn't lower the limit to get an earlier
+     * collection, consider growing it. */
+    if ((char *)tc->nursery_alloc_limit == (char *)tc->nursery_tospace + size
+            && used >= size - size / 8) {
+        tc->nursery_idle_runs = 0;
+        if (size < instance->nursery_size_max && (interval < MVM_NURSERY_GROW_INTERVAL
+                || tc->nursery_survived > size / 4))
+            return size * 2 < instance->nursery_size_max ? size * 2 : instance->nursery_size_max;
+    }
+
+    /* If little was allocated in it, consider shrinking it. */
+    else if (used - tc->nursery_survived < size / 4) {
+        if (++tc->nursery_idle_runs >= MVM_NURSERY_SHRINK_RUNS && size > instance->nursery_size_min) {
+            size_t smaller = size / 2 > instance->nursery_size_min ? size / 2 : instance->nursery_size_min;
+            tc->nursery_idle_runs = 0;
+            if (used < smaller)
+                return smaller;
+        }
+    }
+    else {
+        tc->nursery_idle_runs = 0;
+    }
+    return size;
+}
 
 /* Does a garbage collection run. Exactly what it does is configured by the
  * couple of arguments that it takes.
@@ -37,11 +78,19 @@ static void add_in_tray_to_worklist(MVMThreadContext *tc, MVMGCWorklist *worklis
  * fragmentation that makes finding a right-sized gap problematic will not
  * happen.
  *
+ * Nursery objects can only be copied by the thread that owns them, so work
+ * on those is passed to the owner. Marking an object in the second
+ * generation moves nothing, though, so in a full collection it is done by
+ * whichever thread reaches the object first, and a thread with plenty of
+ * gen2 work queued up shares some of it for idle threads to take.
+ *
  * Note that it adds the roots and processes them in phases, to try to avoid
  * building up a huge worklist. */
 void MVM_gc_collect(MVMThreadContext *tc, MVMuint8 what_to_do, MVMuint8 gen) {
-    /* Create a GC worklist. */
-    MVMGCWorklist *worklist = MVM_gc_worklist_create(tc, gen != MVMGCGenerations_Nursery);
+    /* Create a GC worklist. A nursery collection starting an incremental
+     * marking cycle also includes gen2 objects, so it can grey them. */
+    MVMGCWorklist *worklist = MVM_gc_worklist_create(tc, gen != MVMGCGenerations_Nursery
+        || tc->instance->gc_marking == MVM_GC_MARKING_STARTING);
 
     /* Initialize work passing data structure. */
     WorkToPass wtp;
@@ -51,10 +100,16 @@ void MVM_gc_collect(MVMThreadContext *tc, MVMuint8 what_to_do, MVMuint8 gen) {
     /* See what we need to work on this time. */
     if (what_to_do == MVMGCWhatToDo_InTray) {
         /* We just need to process anything in the in-tray. */
-        add_in_tray_to_worklist(tc, worklist);
+        add_in_tray_to_worklist(tc, worklist, &tc->gc_in_tray);
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : processing %d items from in tray \n", worklist->items);
         process_worklist(tc, worklist, &wtp, gen);
     }
+    else if (what_to_do == MVMGCWhatToDo_Shared) {
+        /* Take gen2 marking work that other threads have shared. */
+        add_in_tray_to_worklist(tc, worklist, &tc->instance->gc_shared_work);
+        GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : processing %d items of shared work \n", worklist->items);
+        process_worklist(tc, worklist, &wtp, gen);
+    }
     else if (what_to_do == MVMGCWhatToDo_Finalizing) {
         /* Need to process the finalizing queue. */
         MVMuint32 i;
@@ -66,17 +121,25 @@ void MVM_gc_collect(MVMThreadContext *tc, MVMuint8 what_to_do, MVMuint8 gen) {
     else {
         /* Main collection run. Swap fromspace and tospace, allocating the
          * new tospace if that didn't yet happen (we don't allocate it at
-         * startup, to cut memory use for threads that quit before a GC). */
-        void *fromspace = tc->nursery_tospace;
-        void *tospace   = tc->nursery_fromspace;
+         * startup, to cut memory use for threads that quit before a GC), or
+         * if the nursery is being resized. */
+        size_t  size      = next_nursery_size(tc);
+        void   *fromspace = tc->nursery_tospace;
+        void   *tospace   = tc->nursery_fromspace;
+        if (tospace && tc->nursery_fromspace_size != size) {
+            MVM_free(tospace);
+            tospace = NULL;
+        }
         if (!tospace)
-            tospace = MVM_calloc(1, MVM_NURSERY_SIZE);
-        tc->nursery_fromspace = fromspace;
-        tc->nursery_tospace   = tospace;
+            tospace = MVM_calloc(1, size);
+        tc->nursery_fromspace      = fromspace;
+        tc->nursery_fromspace_size = tc->nursery_size;
+        tc->nursery_tospace        = tospace;
+        tc->nursery_size           = size;
 
         /* Reset nursery allocation pointers to the new tospace. */
         tc->nursery_alloc       = tospace;
-        tc->nursery_alloc_limit = (char *)tc->nursery_alloc + MVM_NURSERY_SIZE;
+        tc->nursery_alloc_limit = (char *)tc->nursery_alloc + size;
 
         /* Add permanent roots and process them; only one thread will do
         * this, since they are instance-wide. */
@@ -124,13 +187,24 @@ void MVM_gc_collect(MVMThreadContext *tc, MVMuint8 what_to_do, MVMuint8 gen) {
         * collection anyway (in fact, we must not for correctness, otherwise
         * the gen2 rooting keeps them alive forever). */
         if (gen == MVMGCGenerations_Nursery) {
+            MVMuint8 include_gen2 = worklist->include_gen2;
+            worklist->include_gen2 = 0;
             MVM_gc_root_add_gen2s_to_worklist(tc, worklist);
+            worklist->include_gen2 = include_gen2;
             GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : processing %d items from gen2 \n", worklist->items);
             process_worklist(tc, worklist, &wtp, gen);
         }
 
+        /* If this full collection is the remark of an incremental marking
+         * cycle, also consider what objects marked by the cycle reference. */
+        else if (tc->instance->gc_marking == MVM_GC_MARKING_REMARK) {
+            MVM_gc_incremental_add_to_worklist(tc, worklist, what_to_do != MVMGCWhatToDo_NoInstance);
+            GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : processing %d items from incremental marking\n", worklist->items);
+            process_worklist(tc, worklist, &wtp, gen);
+        }
+
         /* Process anything in the in-tray. */
-        add_in_tray_to_worklist(tc, worklist);
+        add_in_tray_to_worklist(tc, worklist, &tc->gc_in_tray);
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : processing %d items from in tray \n", worklist->items);
         process_worklist(tc, worklist, &wtp, gen);
 
@@ -151,12 +225,52 @@ void MVM_gc_collect(MVMThreadContext *tc, MVMuint8 what_to_do, MVMuint8 gen) {
     }
 }
 
+/* Moves some gen2 marking work from the bottom of a worklist (where the
+ * oldest, and so most likely to lead to a large subgraph, entries are) to
+ * the instance-wide pool of shared work, for idle threads to take. */
+static void share_work(MVMThreadContext *tc, MVMGCWorklist *worklist) {
+    MVMGCPassedWork * volatile *pool = &tc->instance->gc_shared_work;
+    MVMGCPassedWork *work  = NULL;
+    MVMuint32        limit = worklist->items / 2;
+    MVMuint32        scan  = 0;
+    MVMuint32        keep  = 0;
+
+    while (scan < limit) {
+        MVMCollectable **item_ptr = worklist->list[scan++];
+        MVMCollectable  *item     = *item_ptr;
+        if (item && (item->flags & MVM_CF_SECOND_GEN) && !(item->flags & MVM_CF_GEN2_LIVE)) {
+            if (!work)
+                work = MVM_calloc(1, sizeof(MVMGCPassedWork));
+            work->items[work->num_items++] = item_ptr;
+            if (work->num_items == MVM_GC_PASS_WORK_SIZE)
+                break;
+        }
+        else {
+            worklist->list[keep++] = item_ptr;
+        }
+    }
+    if (!work)
+        return;
+    memmove(worklist->list + keep, worklist->list + scan,
+        (worklist->items - scan) * sizeof(MVMCollectable **));
+    worklist->items -= scan - keep;
+
+    GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : sharing %d items of gen2 work\n", work->num_items);
+    while (1) {
+        MVMGCPassedWork *orig = *pool;
+        work->next = orig;
+        if (MVM_casptr(pool, orig, work) == orig)
+            return;
+    }
+}
+
 /* Processes the current worklist. */
 static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, WorkToPass *wtp, MVMuint8 gen) {
     MVMGen2Allocator  *gen2;
     MVMCollectable   **item_ptr;
     MVMCollectable    *new_addr;
     MVMuint32          gen2count;
+    MVMuint32          share_countdown = MVM_GC_PASS_WORK_SIZE;
 
     /* Grab the second generation allocator; we may move items into the
      * old generation. */
@@ -173,12 +287,26 @@ static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, Work
         if (item == NULL)
             continue;
 
+        /* If we've a lot of work queued up in a full collection, every so
+         * often see if there are other threads in need of some. */
+        if (gen == MVMGCGenerations_Both && worklist->items > MVM_GC_SHARE_THRESHOLD
+                && --share_countdown == 0) {
+            share_countdown = MVM_GC_PASS_WORK_SIZE;
+            if (tc->instance->gc_participants > 1 && !MVM_load(&tc->instance->gc_shared_work))
+                share_work(tc, worklist);
+        }
+
         /* If it's in the second generation and we're only doing a nursery,
          * collection, we have nothing to do. */
         item_gen2 = item->flags & MVM_CF_SECOND_GEN;
         if (item_gen2) {
-            if (gen == MVMGCGenerations_Nursery)
+            if (gen == MVMGCGenerations_Nursery) {
+                /* Unless we're starting an incremental marking cycle, in
+                 * which case we grey it. */
+                if (worklist->include_gen2 && MVM_gc_claim_gen2_mark(item))
+                    MVM_gc_incremental_grey(tc, item);
                 continue;
+            }
             if (item->flags & MVM_CF_GEN2_LIVE) {
                 /* gen2 and marked as live. */
                 continue;
@@ -206,9 +334,9 @@ static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, Work
             }
         }
 
-        /* If it's owned by a different thread, we need to pass it over to
-         * the owning thread. */
-        if (item->owner != tc->thread_id) {
+        /* If it's in the nursery of a different thread, we need to pass it
+         * over to the owning thread. Any thread may mark gen2 objects. */
+        if (!item_gen2 && item->owner != tc->thread_id) {
             GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : sending a handle %p to object %p to thread %d\n", item_ptr, item, item->owner);
             pass_work_item(tc, wtp, item_ptr);
             continue;
@@ -223,12 +351,14 @@ static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, Work
          * need to take some action. Go on the generation... */
         if (item_gen2) {
             assert(!(item->flags & MVM_CF_FORWARDER_VALID));
-            /* It's in the second generation. We'll just mark it. */
+            /* It's in the second generation. We'll just mark it, unless
+             * another thread beat us to it. */
             new_addr = item;
             if (MVM_GC_DEBUG_ENABLED(MVM_GC_DEBUG_COLLECT)) {
                 GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : handle %p was already %p\n", item_ptr, new_addr);
             }
-            item->flags |= MVM_CF_GEN2_LIVE;
+            if (!MVM_gc_claim_gen2_mark(item))
+                continue;
             assert(*item_ptr == new_addr);
         } else {
             /* Catch NULL stable (always sign of trouble) in debug mode. */
@@ -268,15 +398,22 @@ static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, Work
                 }
                 else if (!(new_addr->flags & (MVM_CF_TYPE_OBJECT | MVM_CF_STABLE))) {
                     MVMObject *new_obj_addr = (MVMObject *)new_addr;
+                    STABLE(new_obj_addr)->pretenure_promotions++;
                     if (REPR(new_obj_addr)->unmanaged_size)
                         tc->gc_promoted_bytes += REPR(new_obj_addr)->unmanaged_size(tc,
                             STABLE(new_obj_addr), OBJECT_BODY(new_obj_addr));
                 }
 
                 /* If we're going to sweep the second generation, also need
-                 * to mark it as live. */
-                if (gen == MVMGCGenerations_Both)
+                 * to mark it as live. If we're in the middle of incremental
+                 * marking, it is marked and greyed. */
+                if (gen == MVMGCGenerations_Both) {
                     new_addr->flags |= MVM_CF_GEN2_LIVE;
+                }
+                else if (tc->instance->gc_marking) {
+                    new_addr->flags |= MVM_CF_GEN2_LIVE;
+                    MVM_gc_incremental_grey(tc, new_addr);
+                }
             }
             else {
                 /* No, so it will live in the nursery for another GC
@@ -485,9 +622,10 @@ static void pass_leftover_work(MVMThreadContext *tc, WorkToPass *wtp) {
                 wtp->target_work[j].work);
 }
 
-/* Takes work in a thread's in-tray, if any, and adds it to the worklist. */
-static void add_in_tray_to_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist) {
-    MVMGCPassedWork * volatile *in_tray = &tc->gc_in_tray;
+/* Takes work in an in-tray (either a thread's own, or the pool of shared
+ * work), if any, and adds it to the worklist. */
+static void add_in_tray_to_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist,
+        MVMGCPassedWork * volatile *in_tray) {
     MVMGCPassedWork *head;
 
     /* Get work to process. */
@@ -603,123 +741,264 @@ void MVM_gc_collect_free_stables(MVMThreadContext *tc) {
     tc->instance->stables_to_free = NULL;
 }
 
-/* Goes through the unmarked objects in the second generation heap and builds
- * free lists out of them. Also does any required finalization. */
-void MVM_gc_collect_free_gen2_unmarked(MVMThreadContext *tc, MVMint32 global_destruction) {
-    /* Visit each of the size class bins. */
-    MVMGen2Allocator *gen2 = tc->gen2;
-    MVMuint32 bin, obj_size, page, i;
-    char ***freelist_insert_pos;
-    for (bin = 0; bin < MVM_GEN2_BINS; bin++) {
-        /* If we've nothing allocated in this size class, skip it. */
-        if (gen2->size_classes[bin].pages == NULL)
-            continue;
-
-        /* Calculate object size for this bin. */
-        obj_size = (bin + 1) << MVM_GEN2_BIN_BITS;
-
-        /* freelist_insert_pos is a pointer to a memory location that
-         * stores the address of the last traversed free list node (char **). */
-        /* Initialize freelist insertion position to free list head. */
-        freelist_insert_pos = &gen2->size_classes[bin].free_list;
-
-        /* Visit each page. */
-        for (page = 0; page < gen2->size_classes[bin].num_pages; page++) {
-            /* Visit all the objects, looking for dead ones and reset the
-             * mark for each of them. */
-            char *cur_ptr = gen2->size_classes[bin].pages[page];
-            char *end_ptr = page + 1 == gen2->size_classes[bin].num_pages
-                ? gen2->size_classes[bin].alloc_pos
-                : cur_ptr + obj_size * MVM_GEN2_PAGE_ITEMS;
-            while (cur_ptr < end_ptr) {
-                MVMCollectable *col = (MVMCollectable *)cur_ptr;
-
-                /* Is this already a free list slot? If so, it becomes the
-                 * new free list insert position. */
-                if (*freelist_insert_pos == (char **)cur_ptr) {
-                    freelist_insert_pos = (char ***)cur_ptr;
-                }
-
-                /* Otherwise, it must be a collectable of some kind. Is it
-                 * live? */
-                else if (col->flags & MVM_CF_GEN2_LIVE) {
-                    /* Yes; clear the mark. */
-                    col->flags &= ~MVM_CF_GEN2_LIVE;
-                }
-                else {
-                    GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : collecting an object %p in the gen2\n", col);
-                    /* No, it's dead. Do any cleanup. */
-                    if (col->flags & MVM_CF_TYPE_OBJECT) {
+/* Cleans up a dead collectable in the second generation. Returns non-zero
+ * if its slot can go on the free list, and zero if it must stay as it is
+ * for now (which is the case for STables that only just died). */
+static MVMint32 free_gen2_dead(MVMThreadContext *tc, MVMCollectable *col, MVMint32 global_destruction) {
+    GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : collecting an object %p in the gen2\n", col);
+    if (col->flags & MVM_CF_TYPE_OBJECT) {
 #ifdef MVM_USE_OVERFLOW_SERIALIZATION_INDEX
-                        if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED)
-                            MVM_free(col->sc_forward_u.sci);
+        if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED)
+            MVM_free(col->sc_forward_u.sci);
 #endif
-                    }
-                    else if (col->flags & MVM_CF_STABLE) {
-                        if (
+    }
+    else if (col->flags & MVM_CF_STABLE) {
+        if (
 #ifdef MVM_USE_OVERFLOW_SERIALIZATION_INDEX
-                            !(col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED) &&
+            !(col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED) &&
 #endif
-                            col->sc_forward_u.sc.sc_idx == 0
-                            && col->sc_forward_u.sc.idx == MVM_DIRECT_SC_IDX_SENTINEL) {
-                            /* We marked it dead last time, kill it. */
-                            MVM_6model_stable_gc_free(tc, (MVMSTable *)col);
-                        }
-                        else {
+            col->sc_forward_u.sc.sc_idx == 0
+            && col->sc_forward_u.sc.idx == MVM_DIRECT_SC_IDX_SENTINEL) {
+            /* We marked it dead last time, kill it. */
+            MVM_6model_stable_gc_free(tc, (MVMSTable *)col);
+        }
+        else {
 #ifdef MVM_USE_OVERFLOW_SERIALIZATION_INDEX
-                            if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED) {
-                                /* Whatever happens next, we can free this
-                                   memory immediately, because no-one will be
-                                   serializing a dead STable. */
-                                assert(!(col->sc_forward_u.sci->sc_idx == 0
-                                         && col->sc_forward_u.sci->idx
-                                         == MVM_DIRECT_SC_IDX_SENTINEL));
-                                MVM_free(col->sc_forward_u.sci);
-                                col->flags &= ~MVM_CF_SERIALZATION_INDEX_ALLOCATED;
-                            }
+            if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED) {
+                /* Whatever happens next, we can free this
+                   memory immediately, because no-one will be
+                   serializing a dead STable. */
+                assert(!(col->sc_forward_u.sci->sc_idx == 0
+                         && col->sc_forward_u.sci->idx
+                         == MVM_DIRECT_SC_IDX_SENTINEL));
+                MVM_free(col->sc_forward_u.sci);
+                col->flags &= ~MVM_CF_SERIALZATION_INDEX_ALLOCATED;
+            }
 #endif
-                            if (global_destruction) {
-                                /* We're in global destruction, so enqueue to the end
-                                 * like we do in the nursery */
-                                MVM_gc_collect_enqueue_stable_for_deletion(tc, (MVMSTable *)col);
-                            } else {
-                                /* There will definitely be another gc run, so mark it as "died last time". */
-                                col->sc_forward_u.sc.sc_idx = 0;
-                                col->sc_forward_u.sc.idx = MVM_DIRECT_SC_IDX_SENTINEL;
-                            }
-                            /* Skip the freelist updating. */
-                            cur_ptr += obj_size;
-                            continue;
-                        }
-                    }
-                    else if (col->flags & MVM_CF_FRAME) {
-                        MVM_frame_destroy(tc, (MVMFrame *)col);
-                    }
-                    else {
-                        /* Object instance; call gc_free if needed. */
-                        MVMObject *obj = (MVMObject *)col;
-                        if (STABLE(obj) && REPR(obj)->gc_free)
-                            REPR(obj)->gc_free(tc, obj);
+            if (global_destruction) {
+                /* We're in global destruction, so enqueue to the end
+                 * like we do in the nursery */
+                MVM_gc_collect_enqueue_stable_for_deletion(tc, (MVMSTable *)col);
+            } else {
+                /* There will definitely be another gc run, so mark it as "died last time". */
+                col->sc_forward_u.sc.sc_idx = 0;
+                col->sc_forward_u.sc.idx = MVM_DIRECT_SC_IDX_SENTINEL;
+            }
+            /* Skip the freelist updating. */
+            return 0;
+        }
+    }
+    else if (col->flags & MVM_CF_FRAME) {
+        MVM_frame_destroy(tc, (MVMFrame *)col);
+    }
+    else {
+        /* Object instance; call gc_free if needed. */
+        MVMObject *obj = (MVMObject *)col;
+        if (STABLE(obj) && REPR(obj)->gc_free)
+            REPR(obj)->gc_free(tc, obj);
 #ifdef MVM_USE_OVERFLOW_SERIALIZATION_INDEX
-                        if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED)
-                            MVM_free(col->sc_forward_u.sci);
+        if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED)
+            MVM_free(col->sc_forward_u.sci);
 #endif
-                    }
+    }
+    return 1;
+}
 
-                    /* Chain in to the free list. */
-                    *((char **)cur_ptr) = (char *)*freelist_insert_pos;
-                    *freelist_insert_pos = (char **)cur_ptr;
+/* Finds the first free list slot in or after a page of a size class, given
+ * the index of the page holding the head of the free list. */
+static char ** first_free_from(MVMGen2SizeClass *sc, MVMuint32 head_page, MVMuint32 page) {
+    if (page <= head_page)
+        return head_page < sc->num_pages ? sc->free_list : NULL;
+    for (; page < sc->num_page_free; page++)
+        if (sc->page_free[page])
+            return sc->page_free[page];
+    return NULL;
+}
 
-                    /* Update the pointer to the insert position to point to us */
-                    freelist_insert_pos = (char ***)cur_ptr;
+/* Splits the pages of each size class of a gen2 allocator into partitions
+ * to sweep, adding them to the partitions array. */
+static void plan_allocator_sweep(MVMGen2Allocator *gen2, MVMGCSweepPartition **parts,
+        MVMuint32 *num_parts, MVMuint32 *alloc_parts) {
+    MVMuint32 bin, page;
+    for (bin = 0; bin < MVM_GEN2_BINS; bin++) {
+        MVMGen2SizeClass *sc = &gen2->size_classes[bin];
+        MVMuint32 obj_size, page_size, head_page, step;
+
+        /* If we've nothing allocated in this size class, skip it. */
+        if (sc->pages == NULL)
+            continue;
+        obj_size  = (bin + 1) << MVM_GEN2_BIN_BITS;
+        page_size = obj_size * MVM_GEN2_PAGE_ITEMS;
+
+        /* Locate the page holding the head of the free list; those before
+         * it have nothing on the free list any more. */
+        head_page = sc->num_pages;
+        if (sc->free_list) {
+            for (page = 0; page < sc->num_pages; page++) {
+                if ((char *)sc->free_list >= sc->pages[page] &&
+                        (char *)sc->free_list < sc->pages[page] + page_size) {
+                    head_page = page;
+                    break;
                 }
+            }
+        }
+
+        /* If there is a free list but we don't know where in it each page
+         * starts, the size class has to be swept as a whole. */
+        step = sc->free_list && !sc->page_free
+            ? sc->num_pages
+            : MVM_GC_SWEEP_PARTITION_PAGES;
+        for (page = 0; page < sc->num_pages; page += step) {
+            MVMGCSweepPartition *part;
+            if (*num_parts == *alloc_parts) {
+                *alloc_parts = *alloc_parts ? 2 * *alloc_parts : 64;
+                *parts = MVM_realloc(*parts, *alloc_parts * sizeof(MVMGCSweepPartition));
+            }
+            part             = &(*parts)[(*num_parts)++];
+            part->gen2       = gen2;
+            part->bin        = bin;
+            part->first_page = page;
+            part->end_page   = page + step < sc->num_pages ? page + step : sc->num_pages;
+            part->first_free = page == 0 ? sc->free_list : first_free_from(sc, head_page, page);
+        }
+
+        /* Make room to record where each page's free list slots start and
+         * end, and how many there are. */
+        if (sc->num_page_free != sc->num_pages) {
+            sc->page_free      = MVM_realloc(sc->page_free, sc->num_pages * sizeof(char **));
+            sc->page_free_tail = MVM_realloc(sc->page_free_tail, sc->num_pages * sizeof(char **));
+            sc->page_num_free  = MVM_realloc(sc->page_num_free, sc->num_pages * sizeof(MVMuint16));
+            sc->num_page_free  = sc->num_pages;
+        }
+    }
+}
+
+/* Sweeps a partition of a size class: visits each slot in its pages, making
+ * a chain per page of the existing free slots together with those of objects
+ * that were not marked, and clearing the mark on those that were. */
+static void sweep_partition(MVMThreadContext *tc, MVMGCSweepPartition *part,
+        MVMint32 global_destruction) {
+    MVMGen2SizeClass *sc        = &part->gen2->size_classes[part->bin];
+    MVMuint32         obj_size  = (part->bin + 1) << MVM_GEN2_BIN_BITS;
+    char            **next_free = part->first_free;
+    MVMuint32         page;
+
+    for (page = part->first_page; page < part->end_page; page++) {
+        char  *cur_ptr  = sc->pages[page];
+        char  *end_ptr  = page + 1 == sc->num_pages
+            ? sc->alloc_pos
+            : cur_ptr + obj_size * MVM_GEN2_PAGE_ITEMS;
+        char **tail     = NULL;
+        MVMuint16 nfree = 0;
+        sc->page_free[page] = NULL;
+        while (cur_ptr < end_ptr) {
+            MVMCollectable *col = (MVMCollectable *)cur_ptr;
+
+            /* Is this already a free list slot? If so, note where the
+             * next one is before we chain it in again. */
+            if ((char **)cur_ptr == next_free) {
+                next_free = (char **)*next_free;
+            }
 
-                /* Move to the next object. */
+            /* Otherwise, it must be a collectable of some kind. Is it
+             * live? If so, clear the mark and move on. (In global
+             * destruction, anything marked was marked by an unfinished
+             * incremental marking cycle, and is to go anyway.) */
+            else if ((col->flags & MVM_CF_GEN2_LIVE) && !global_destruction) {
+                col->flags &= ~MVM_CF_GEN2_LIVE;
                 cur_ptr += obj_size;
+                continue;
+            }
+
+            /* No, it's dead. Do any cleanup. */
+            else if (!free_gen2_dead(tc, col, global_destruction)) {
+                cur_ptr += obj_size;
+                continue;
             }
+
+            /* Chain in to the page's free list. */
+            if (tail)
+                *tail = cur_ptr;
+            else
+                sc->page_free[page] = (char **)cur_ptr;
+            tail = (char **)cur_ptr;
+            nfree++;
+
+            /* Move to the next object. */
+            cur_ptr += obj_size;
         }
+        sc->page_free_tail[page] = tail;
+        sc->page_num_free[page]  = nfree;
     }
-    
+}
+
+/* A page of a size class along with its free list slots, for ordering. */
+typedef struct {
+    char      *page;
+    char     **free_head;
+    char     **free_tail;
+    MVMuint16  num_free;
+} PageOrder;
+static int compare_page_order(const void *a, const void *b) {
+    return (int)((const PageOrder *)a)->num_free - (int)((const PageOrder *)b)->num_free;
+}
+
+/* Once a size class is swept, releases the pages with nothing living in
+ * them (giving their memory back to the OS), and puts the remaining pages in
+ * order of how full they are, with the fullest first, before linking up
+ * their free list slots. Allocation
+ * takes from the start of the free list, so it fills up the fullest pages,
+ * and objects in the emptiest pages are left to die off, so those pages can
+ * be released in turn. (We can't compact gen2 by evacuating objects, as C
+ * code holds pointers to gen2 objects across allocations, and thus across
+ * GC runs.) The page holding the allocation position stays last. */
+static void order_size_class(MVMThreadContext *tc, MVMGen2SizeClass *sc, MVMuint32 bin) {
+    MVMuint32   page_size = MVM_GEN2_PAGE_ITEMS * ((bin + 1) << MVM_GEN2_BIN_BITS);
+    MVMuint32   last      = sc->num_pages - 1;
+    MVMuint32   kept      = 0;
+    MVMuint32   page;
+    PageOrder  *order     = MVM_malloc(sc->num_pages * sizeof(PageOrder));
+    char     ***tail      = &sc->free_list;
+
+    for (page = 0; page <= last; page++) {
+        if (page < last && sc->page_num_free[page] == MVM_GEN2_PAGE_ITEMS) {
+            MVM_gc_gen2_release_page(tc, sc, sc->pages[page], page_size);
+            continue;
+        }
+        order[kept].page      = sc->pages[page];
+        order[kept].free_head = sc->page_free[page];
+        order[kept].free_tail = sc->page_free_tail[page];
+        order[kept].num_free  = sc->page_num_free[page];
+        kept++;
+    }
+    qsort(order, kept - 1, sizeof(PageOrder), compare_page_order);
+
+    for (page = 0; page < kept; page++) {
+        sc->pages[page]          = order[page].page;
+        sc->page_free[page]      = order[page].free_head;
+        sc->page_free_tail[page] = order[page].free_tail;
+        sc->page_num_free[page]  = order[page].num_free;
+        if (order[page].free_head) {
+            *tail = order[page].free_head;
+            tail  = (char ***)order[page].free_tail;
+        }
+    }
+    *tail = NULL;
+    sc->num_pages     = kept;
+    sc->num_page_free = kept;
+    sc->cur_page      = kept - 1;
+    MVM_free(order);
+}
+
+/* Orders and links up the free lists of the size classes of a swept gen2
+ * allocator, then frees any unmarked over-sized objects. */
+static void finish_allocator_sweep(MVMThreadContext *tc, MVMGen2Allocator *gen2) {
+    MVMuint32 i;
+
+    for (i = 0; i < MVM_GEN2_BINS; i++)
+        if (gen2->size_classes[i].pages)
+            order_size_class(tc, &gen2->size_classes[i], i);
+
     /* Also need to consider overflows. */
     for (i = 0; i < gen2->num_overflows; i++) {
         if (gen2->overflows[i]) {
@@ -752,3 +1031,74 @@ void MVM_gc_collect_free_gen2_unmarked(MVMThreadContext *tc, MVMint32 global_des
     /* And finally compact the overflow list */
     MVM_gc_gen2_compact_overflows(gen2);
 }
+
+/* Goes through the unmarked objects in the second generation heap of the
+ * current thread and builds free lists out of them. Also does any required
+ * finalization. This sweeps the whole heap on the calling thread; during a
+ * full collection, the sweep is instead planned and shared out among all
+ * of the threads taking part in it. */
+void MVM_gc_collect_free_gen2_unmarked(MVMThreadContext *tc, MVMint32 global_destruction) {
+    MVMGCSweepPartition *parts       = NULL;
+    MVMuint32            num_parts   = 0;
+    MVMuint32            alloc_parts = 0;
+    MVMuint32            i;
+    plan_allocator_sweep(tc->gen2, &parts, &num_parts, &alloc_parts);
+    for (i = 0; i < num_parts; i++)
+        sweep_partition(tc, &parts[i], global_destruction);
+    finish_allocator_sweep(tc, tc->gen2);
+    MVM_free(parts);
+}
+
+/* Called by the co-ordinator of a full collection once marking is complete,
+ * to split the gen2 heaps of all threads whose heaps are to be swept into
+ * partitions, which the threads taking part then share out among them. */
+void MVM_gc_collect_plan_gen2_sweep(MVMThreadContext *tc) {
+    MVMInstance *instance  = tc->instance;
+    MVMThread   *cur_thread = (MVMThread *)MVM_load(&instance->threads);
+    instance->gc_num_sweep_partitions = 0;
+    while (cur_thread) {
+        if (cur_thread->body.tc)
+            plan_allocator_sweep(cur_thread->body.tc->gen2, &instance->gc_sweep_partitions,
+                &instance->gc_num_sweep_partitions, &instance->gc_alloc_sweep_partitions);
+        cur_thread = cur_thread->body.next;
+    }
+    MVM_store(&instance->gc_sweep_next, 0);
+    MVM_store(&instance->gc_sweep_remaining, instance->gc_num_sweep_partitions);
+}
+
+/* Claims and sweeps partitions of the gen2 heaps until there are none left,
+ * then waits for the other threads to finish those they claimed, so that
+ * no thread goes back to allocating while its heap is still being swept. */
+void MVM_gc_collect_sweep_gen2_partitions(MVMThreadContext *tc) {
+    MVMInstance *instance = tc->instance;
+    MVMuint32    spins    = 1;
+    MVMuint32    i;
+    while (1) {
+        AO_t claimed = MVM_incr(&instance->gc_sweep_next);
+        if (claimed >= instance->gc_num_sweep_partitions)
+            break;
+        sweep_partition(tc, &instance->gc_sweep_partitions[claimed], 0);
+        MVM_decr(&instance->gc_sweep_remaining);
+    }
+
+    /* The partitions still being swept are no bigger than ours were, so
+     * they should be done soon; spin for a while, backing off, and then
+     * yield to the threads sweeping them. */
+    while (MVM_load(&instance->gc_sweep_remaining)) {
+        if (spins <= MVM_GC_SWEEP_MAX_SPINS) {
+            for (i = 0; i < spins; i++)
+                if (!MVM_load(&instance->gc_sweep_remaining))
+                    break;
+            spins *= 2;
+        }
+        else {
+            MVM_platform_thread_yield();
+        }
+    }
+}
+
+/* Completes the parallel sweep of a gen2 allocator, once all partitions are
+ * swept, by linking up its free lists and freeing over-sized objects. */
+void MVM_gc_collect_finish_gen2_sweep(MVMThreadContext *tc, MVMGen2Allocator *gen2) {
+    finish_allocator_sweep(tc, gen2);
+}
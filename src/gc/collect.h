@@ -1,7 +1,23 @@
 /* How big is the nursery area? Note that since it's semi-space copying, we
- * actually have double this amount allocated. Also it is per thread. (In
- * the future, we'll make this adaptive rather than a constant.) */
-#define MVM_NURSERY_SIZE 4194304
+ * actually have double this amount allocated. Also it is per thread, and
+ * adapts to how the thread allocates, between a minimum and a maximum. This
+ * is the size the main thread starts with; other threads start at the
+ * minimum. All three can be set using the environment variables with the
+ * same names (MVM_NURSERY_SIZE and so on), in bytes. */
+#define MVM_NURSERY_SIZE        4194304
+#define MVM_NURSERY_SIZE_MIN    262144
+#define MVM_NURSERY_SIZE_MAX    67108864
+
+/* The smallest nursery size we accept from the environment, so anything that
+ * may be allocated in the nursery will fit. */
+#define MVM_NURSERY_SIZE_FLOOR  131072
+
+/* A nursery that fills up in less than this many nanoseconds is doubled in
+ * size, as is one where more than a quarter survived the last collection. A
+ * nursery that is less than a quarter used when collected this many times
+ * in a row is halved. */
+#define MVM_NURSERY_GROW_INTERVAL   10000000
+#define MVM_NURSERY_SHRINK_RUNS     4
 
 /* How many bytes should have been promoted into gen2 before we decide to
  * do a full GC run? This defaults to a percentage of the resident set, with
@@ -22,7 +38,11 @@ typedef enum {
     MVMGCWhatToDo_InTray = 2,
 
     /* Only process the finalizing list. */
-    MVMGCWhatToDo_Finalizing = 4
+    MVMGCWhatToDo_Finalizing = 4,
+
+    /* Only process gen2 marking work taken from the instance-wide pool of
+     * work shared by other threads. */
+    MVMGCWhatToDo_Shared = 8
 } MVMGCWhatToDo;
 
 /* What generation(s) to collect? */
@@ -46,9 +66,65 @@ struct MVMGCPassedWork {
     MVMint32         num_items;
 };
 
+/* The number of items a thread must have on its worklist during a full
+ * collection before it considers sharing some of its gen2 marking work with
+ * idle threads. */
+#define MVM_GC_SHARE_THRESHOLD  256
+
+/* The number of gen2 pages of a size class that go into a partition of the
+ * parallel sweep. */
+#define MVM_GC_SWEEP_PARTITION_PAGES    16
+
+/* How many times a thread done sweeping checks, at most, between yielding
+ * the CPU while it waits for other threads to finish their partitions. It
+ * checks once at first, then twice as often each time until it hits this
+ * limit. */
+#define MVM_GC_SWEEP_MAX_SPINS          1024
+
+/* A range of pages in a size class of a gen2 allocator, to be swept by one
+ * thread. The free list slots it finds are chained per page, and the pages'
+ * chains linked up once all partitions of the size class are swept. */
+struct MVMGCSweepPartition {
+    /* The allocator and size class. */
+    MVMGen2Allocator *gen2;
+    MVMuint32         bin;
+
+    /* The range of pages. */
+    MVMuint32         first_page;
+    MVMuint32         end_page;
+
+    /* The first free list slot at or after the first page before sweeping,
+     * if there is one. */
+    char            **first_free;
+};
+
+/* Kinds of GC run, as far as statistics on how long they pause for go. */
+#define MVM_GC_PAUSE_NURSERY    0   /* Nursery collection. */
+#define MVM_GC_PAUSE_MARKING    1   /* Nursery collection with a marking slice. */
+#define MVM_GC_PAUSE_FULL       2   /* Full collection. */
+#define MVM_GC_PAUSE_REMARK     3   /* Full collection ending a marking cycle. */
+#define MVM_GC_PAUSE_KINDS      4
+
+/* Number of buckets in the histogram of pause times. The first holds pauses
+ * under 2^15ns (about 33us), each after that pauses up to twice as long as
+ * the one before, and the last all those of 2^29ns (over half a second) or
+ * more. */
+#define MVM_GC_PAUSE_BUCKETS    16
+
+/* Pause time statistics for a kind of GC run, in nanoseconds. */
+struct MVMGCPauseStats {
+    MVMuint64 count;
+    MVMuint64 total;
+    MVMuint64 max;
+    MVMuint64 histogram[MVM_GC_PAUSE_BUCKETS];
+};
+
 /* Functions. */
 void MVM_gc_collect(MVMThreadContext *tc, MVMuint8 what_to_do, MVMuint8 gen);
 void MVM_gc_collect_free_nursery_uncopied(MVMThreadContext *tc, void *limit);
 void MVM_gc_collect_free_gen2_unmarked(MVMThreadContext *tc, MVMint32 global_destruction);
+void MVM_gc_collect_plan_gen2_sweep(MVMThreadContext *tc);
+void MVM_gc_collect_sweep_gen2_partitions(MVMThreadContext *tc);
+void MVM_gc_collect_finish_gen2_sweep(MVMThreadContext *tc, MVMGen2Allocator *gen2);
 void MVM_gc_mark_collectable(MVMThreadContext *tc, MVMGCWorklist *worklist, MVMCollectable *item);
 void MVM_gc_collect_free_stables(MVMThreadContext *tc);
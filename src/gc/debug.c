@@ -10,12 +10,12 @@ void MVM_gc_debug_find_region(MVMThreadContext *tc, void *ptr) {
         MVMThreadContext *thread_tc = cur_thread->body.tc;
         if (thread_tc) {
             if (ptr >= thread_tc->nursery_fromspace &&
-                    ptr < thread_tc->nursery_fromspace + MVM_NURSERY_SIZE) {
+                    ptr < thread_tc->nursery_fromspace + thread_tc->nursery_fromspace_size) {
                 printf("In fromspace of thread %d\n", cur_thread->body.thread_id);
                 return;
             }
             if (ptr >= thread_tc->nursery_tospace &&
-                    ptr < thread_tc->nursery_tospace + MVM_NURSERY_SIZE) {
+                    ptr < thread_tc->nursery_tospace + thread_tc->nursery_size) {
                 printf("In tospace of thread %d\n", cur_thread->body.thread_id);
                 return;
             }
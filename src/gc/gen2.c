@@ -1,4 +1,5 @@
 #include "moar.h"
+#include "platform/mmap.h"
 
 /* Creates a new second generation allocator. */
 MVMGen2Allocator * MVM_gc_gen2_create(MVMInstance *i) {
@@ -16,6 +17,13 @@ MVMGen2Allocator * MVM_gc_gen2_create(MVMInstance *i) {
     return al;
 }
 
+/* Gets memory for a new page, using a spare one if there is one. */
+static char * new_page(MVMGen2SizeClass *sc, MVMuint32 page_size) {
+    return sc->num_spare_pages
+        ? sc->spare_pages[--sc->num_spare_pages]
+        : MVM_malloc(page_size);
+}
+
 /* Sets up a size class bin in the second generation. */
 static void setup_bin(MVMGen2Allocator *al, MVMuint32 bin) {
     /* Work out page size we want. */
@@ -24,7 +32,7 @@ static void setup_bin(MVMGen2Allocator *al, MVMuint32 bin) {
     /* We'll just allocate a single page to start off with. */
     al->size_classes[bin].num_pages = 1;
     al->size_classes[bin].pages     = MVM_malloc(sizeof(void *) * al->size_classes[bin].num_pages);
-    al->size_classes[bin].pages[0]  = MVM_malloc(page_size);
+    al->size_classes[bin].pages[0]  = new_page(&al->size_classes[bin], page_size);
 
     /* Set up allocation position and limit. */
     al->size_classes[bin].alloc_pos = al->size_classes[bin].pages[0];
@@ -44,7 +52,7 @@ static void add_page(MVMGen2Allocator *al, MVMuint32 bin) {
     al->size_classes[bin].num_pages++;
     al->size_classes[bin].pages = MVM_realloc(al->size_classes[bin].pages,
         sizeof(void *) * al->size_classes[bin].num_pages);
-    al->size_classes[bin].pages[cur_page] = MVM_malloc(page_size);
+    al->size_classes[bin].pages[cur_page] = new_page(&al->size_classes[bin], page_size);
 
     /* Set up allocation position and limit. */
     al->size_classes[bin].alloc_pos = al->size_classes[bin].pages[cur_page];
@@ -123,6 +131,12 @@ void MVM_gc_gen2_destroy(MVMInstance *i, MVMGen2Allocator *al) {
         for (k = 0; k < al->size_classes[j].num_pages; k++)
             MVM_free(al->size_classes[j].pages[k]);
         MVM_free(al->size_classes[j].pages);
+        MVM_free(al->size_classes[j].page_free);
+        MVM_free(al->size_classes[j].page_free_tail);
+        MVM_free(al->size_classes[j].page_num_free);
+        for (k = 0; k < al->size_classes[j].num_spare_pages; k++)
+            MVM_free(al->size_classes[j].spare_pages[k]);
+        MVM_free(al->size_classes[j].spare_pages);
     }
 
     /* Free any allocated overflows. */
@@ -138,6 +152,17 @@ void MVM_gc_gen2_destroy(MVMInstance *i, MVMGen2Allocator *al) {
     MVM_free(al);
 }
 
+/* Forgets the free list slots recorded per page of a size class. */
+static void forget_page_free(MVMGen2SizeClass *sc) {
+    MVM_free(sc->page_free);
+    sc->page_free = NULL;
+    MVM_free(sc->page_free_tail);
+    sc->page_free_tail = NULL;
+    MVM_free(sc->page_num_free);
+    sc->page_num_free = NULL;
+    sc->num_page_free = 0;
+}
+
 /* blindly move pages from one gen2 to another */
 void MVM_gc_gen2_transfer(MVMThreadContext *src, MVMThreadContext *dest) {
     MVMGen2Allocator *gen2 = src->gen2, *dest_gen2 = dest->gen2;
@@ -228,6 +253,21 @@ void MVM_gc_gen2_transfer(MVMThreadContext *src, MVMThreadContext *dest) {
         MVM_free(gen2->size_classes[bin].pages);
         gen2->size_classes[bin].pages = NULL;
         gen2->size_classes[bin].num_pages = 0;
+
+        /* The free list no longer matches the first free slots recorded
+         * per page, so forget them until the next sweep. */
+        forget_page_free(&gen2->size_classes[bin]);
+        forget_page_free(&dest_gen2->size_classes[bin]);
+    }
+    for (bin = 0; bin < MVM_GEN2_BINS; bin++) {
+        /* Spare pages are not worth moving; just free them. */
+        MVMGen2SizeClass *sc = &gen2->size_classes[bin];
+        for (page = 0; page < sc->num_spare_pages; page++)
+            MVM_free(sc->spare_pages[page]);
+        MVM_free(sc->spare_pages);
+        sc->spare_pages       = NULL;
+        sc->num_spare_pages   = 0;
+        sc->alloc_spare_pages = 0;
     }
     { /* copy the roots... */
         MVMuint32 i, n = src->num_gen2roots;
@@ -242,6 +282,26 @@ void MVM_gc_gen2_transfer(MVMThreadContext *src, MVMThreadContext *dest) {
 }
 
 
+/* Releases a page of a size class that has become empty. The memory of its
+ * whole OS pages is given back to the OS, and the page is kept as a spare to
+ * allocate into again; if it's too small to give anything back, it is freed
+ * instead. */
+void MVM_gc_gen2_release_page(MVMThreadContext *tc, MVMGen2SizeClass *sc, char *page,
+        MVMuint32 page_size) {
+    size_t discarded = MVM_platform_discard_pages(page, page_size);
+    if (discarded) {
+        if (sc->num_spare_pages == sc->alloc_spare_pages) {
+            sc->alloc_spare_pages = sc->alloc_spare_pages ? 2 * sc->alloc_spare_pages : 8;
+            sc->spare_pages = MVM_realloc(sc->spare_pages, sc->alloc_spare_pages * sizeof(char *));
+        }
+        sc->spare_pages[sc->num_spare_pages++] = page;
+        MVM_add(&tc->instance->released_page_bytes, discarded);
+    }
+    else {
+        MVM_free(page);
+    }
+}
+
 void MVM_gc_gen2_compact_overflows(MVMGen2Allocator *al) {
     /* compact the overflow list to prevent it from growing without bounds */
     MVMCollectable **overflows     = al->overflows;
@@ -20,6 +20,27 @@ struct MVMGen2SizeClass {
 
     /* The number of pages allocated. */
     MVMuint32 num_pages;
+
+    /* The first free list slot in each page as of the last sweep, or NULL
+     * if the page had none. Allocation only ever takes from the head of the
+     * free list, which is kept in page order, so these stay accurate for the
+     * pages after the one holding the head. They let the pages be swept in
+     * parallel partitions. NULL if not known (for example, after pages were
+     * transferred from another allocator). */
+    char    ***page_free;
+    MVMuint32  num_page_free;
+
+    /* The last free list slot in each page, and the number of free slots in
+     * each page, as of the last sweep. Used to release empty pages and to
+     * put the fullest pages first. */
+    char    ***page_free_tail;
+    MVMuint16 *page_num_free;
+
+    /* Pages that were released when they became empty, whose memory was
+     * given back to the OS, kept to be used again before allocating more. */
+    char     **spare_pages;
+    MVMuint32  num_spare_pages;
+    MVMuint32  alloc_spare_pages;
 };
 
 /* An "instance" of the fixed size allocator. */
@@ -71,3 +92,5 @@ void * MVM_gc_gen2_allocate_zeroed(MVMGen2Allocator *al, MVMuint32 size);
 void MVM_gc_gen2_destroy(MVMInstance *i, MVMGen2Allocator *allocator);
 void MVM_gc_gen2_transfer(MVMThreadContext *src, MVMThreadContext *dest);
 void MVM_gc_gen2_compact_overflows(MVMGen2Allocator *allocator);
+void MVM_gc_gen2_release_page(MVMThreadContext *tc, MVMGen2SizeClass *sc, char *page,
+    MVMuint32 page_size);
@@ -0,0 +1,104 @@
+#include "moar.h"
+
+/* Pushes a marked gen2 collectable onto the thread's grey list, so that the
+ * things it references will be marked by a later slice (or the remark). */
+void MVM_gc_incremental_grey(MVMThreadContext *tc, MVMCollectable *item) {
+    if (tc->num_gc_grey == tc->alloc_gc_grey) {
+        tc->alloc_gc_grey = tc->alloc_gc_grey ? tc->alloc_gc_grey * 2 : 256;
+        tc->gc_grey = MVM_realloc(tc->gc_grey,
+            tc->alloc_gc_grey * sizeof(MVMCollectable *));
+    }
+    tc->gc_grey[tc->num_gc_grey++] = item;
+}
+
+/* Pushes a marked gen2 collectable onto the instance-wide mark stack, which
+ * only the coordinator of a GC run touches. */
+static void push_mark_stack(MVMInstance *instance, MVMCollectable *item) {
+    if (instance->gc_num_mark_stack == instance->gc_alloc_mark_stack) {
+        instance->gc_alloc_mark_stack = instance->gc_alloc_mark_stack
+            ? instance->gc_alloc_mark_stack * 2
+            : 1024;
+        instance->gc_mark_stack = MVM_realloc(instance->gc_mark_stack,
+            instance->gc_alloc_mark_stack * sizeof(MVMCollectable *));
+    }
+    instance->gc_mark_stack[instance->gc_num_mark_stack++] = item;
+}
+
+/* Moves the grey lists of all threads onto the instance-wide mark stack. */
+static void gather_grey(MVMThreadContext *tc) {
+    MVMInstance *instance   = tc->instance;
+    MVMThread   *cur_thread = (MVMThread *)MVM_load(&instance->threads);
+    while (cur_thread) {
+        MVMThreadContext *other = cur_thread->body.tc;
+        if (other) {
+            MVMuint32 i;
+            for (i = 0; i < other->num_gc_grey; i++)
+                push_mark_stack(instance, other->gc_grey[i]);
+            other->num_gc_grey = 0;
+        }
+        cur_thread = cur_thread->body.next;
+    }
+}
+
+/* Does a slice of incremental marking. Called by the coordinator of a
+ * nursery collection once all the copying is done, so the world is stopped
+ * and all references in gen2 objects are up to date. Scans up to a slice
+ * worth of grey objects, marking and greying the gen2 objects they
+ * reference; the nursery objects they reference needn't be considered, as
+ * anything in gen2 that references a nursery object is an inter-generational
+ * root, which the remark will scan. */
+void MVM_gc_incremental_slice(MVMThreadContext *tc) {
+    MVMInstance   *instance = tc->instance;
+    MVMGCWorklist *worklist = MVM_gc_worklist_create(tc, 1);
+    MVMuint32      budget   = MVM_GC_MARK_SLICE_SIZE;
+
+    gather_grey(tc);
+    while (budget-- && instance->gc_num_mark_stack) {
+        MVMCollectable  *item = instance->gc_mark_stack[--instance->gc_num_mark_stack];
+        MVMCollectable **ref_ptr;
+        MVM_gc_mark_collectable(tc, worklist, item);
+        while ((ref_ptr = MVM_gc_worklist_get(tc, worklist))) {
+            MVMCollectable *ref = *ref_ptr;
+            if (ref && (ref->flags & MVM_CF_SECOND_GEN) && MVM_gc_claim_gen2_mark(ref))
+                push_mark_stack(instance, ref);
+        }
+    }
+    MVM_gc_worklist_destroy(tc, worklist);
+
+    GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : marking slice left %d grey objects\n",
+        instance->gc_num_mark_stack);
+    instance->gc_marking_slices++;
+    if (instance->gc_marking == MVM_GC_MARKING_STARTING)
+        instance->gc_marking = MVM_GC_MARKING_ACTIVE;
+}
+
+/* Adds what the remark of a marking cycle needs to consider on top of the
+ * usual roots to a worklist: the things referenced by objects that are still
+ * grey, and by inter-generational roots that are already marked, since the
+ * marking will not scan any marked object again. Each thread does this for
+ * itself; the instance-wide mark stack is done by the one doing instance
+ * roots. */
+void MVM_gc_incremental_add_to_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist,
+        MVMuint8 instance_wide) {
+    MVMuint32 i;
+    if (instance_wide) {
+        MVMInstance *instance = tc->instance;
+        for (i = 0; i < instance->gc_num_mark_stack; i++)
+            MVM_gc_mark_collectable(tc, worklist, instance->gc_mark_stack[i]);
+        instance->gc_num_mark_stack = 0;
+    }
+    for (i = 0; i < tc->num_gc_grey; i++)
+        MVM_gc_mark_collectable(tc, worklist, tc->gc_grey[i]);
+    tc->num_gc_grey = 0;
+    for (i = 0; i < tc->num_gen2roots; i++)
+        if (tc->gen2roots[i]->flags & MVM_CF_GEN2_LIVE)
+            MVM_gc_mark_collectable(tc, worklist, tc->gen2roots[i]);
+}
+
+/* Ends a marking cycle, once the remark is done. */
+void MVM_gc_incremental_finish(MVMThreadContext *tc) {
+    MVMInstance *instance = tc->instance;
+    instance->gc_marking        = MVM_GC_MARKING_NONE;
+    instance->gc_marking_slices = 0;
+    instance->gc_num_mark_stack = 0;
+}
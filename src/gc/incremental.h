@@ -0,0 +1,61 @@
+/* Incremental marking of generation 2, enabled by setting the environment
+ * variable MVM_GC_INCREMENTAL. Rather than marking all of generation 2 in a
+ * single pause once enough has been promoted into it, a marking cycle is
+ * started at a nursery collection, which marks the generation 2 objects it
+ * finds referenced from the roots and nursery and puts them on a grey list.
+ * Each following nursery collection then scans a bounded slice of the grey
+ * list, marking and greying what those objects reference. Between the
+ * slices, a write barrier makes sure that a marked object never comes to
+ * hold the only reference to an unmarked one, by marking and greying the
+ * referenced object. Once the grey list runs dry, a full collection is done
+ * as a remark; it only needs to scan the objects that are not yet marked,
+ * plus the inter-generational roots, which point to nursery objects that
+ * were never traced by the slices.
+ *
+ * The slices are done while the world is stopped for a nursery collection,
+ * since objects may only be scanned when their owners are not running. */
+
+/* States of incremental marking. */
+#define MVM_GC_MARKING_NONE         0   /* No marking cycle is in progress. */
+#define MVM_GC_MARKING_STARTING     1   /* Nursery collection starting a cycle. */
+#define MVM_GC_MARKING_ACTIVE       2   /* Cycle in progress; slices being done. */
+#define MVM_GC_MARKING_REMARK       3   /* Full collection completing a cycle. */
+
+/* The number of grey objects scanned in each slice. */
+#define MVM_GC_MARK_SLICE_SIZE      8192
+
+/* The number of slices after which we remark even if the grey list did not
+ * yet run dry, so a cycle doesn't go on for ever if mutators keep up with
+ * the marking. */
+#define MVM_GC_MARK_MAX_SLICES      64
+
+/* Sets the live mark on a collectable in the second generation, unless
+ * another thread got there first. Returns non-zero if we set it, in which
+ * case it's up to us to mark the things it references. The flags share a
+ * 32-bit word with the size, which doesn't change after allocation, so we
+ * swap the whole word. */
+MVM_STATIC_INLINE MVMint32 MVM_gc_claim_gen2_mark(MVMCollectable *item) {
+    union {
+        unsigned int word;
+        struct {
+            MVMuint16 flags;
+            MVMuint16 size;
+        } parts;
+    } old_header, new_header;
+    volatile unsigned int *word = (volatile unsigned int *)&item->flags;
+    do {
+        old_header.word = *word;
+        if (old_header.parts.flags & MVM_CF_GEN2_LIVE)
+            return 0;
+        new_header = old_header;
+        new_header.parts.flags |= MVM_CF_GEN2_LIVE;
+    } while (!AO_int_compare_and_swap_full(word, old_header.word, new_header.word));
+    return 1;
+}
+
+/* Functions. */
+void MVM_gc_incremental_grey(MVMThreadContext *tc, MVMCollectable *item);
+void MVM_gc_incremental_slice(MVMThreadContext *tc);
+void MVM_gc_incremental_add_to_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist,
+    MVMuint8 instance_wide);
+void MVM_gc_incremental_finish(MVMThreadContext *tc);
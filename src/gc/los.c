@@ -0,0 +1,37 @@
+#include "moar.h"
+#include "platform/mmap.h"
+
+/* Rounds a size up to a whole number of pages. */
+static size_t round_to_pages(size_t size) {
+    size_t page_size = MVM_platform_page_size();
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+/* Allocates a block in the large object space. */
+void * MVM_gc_los_alloc(MVMInstance *instance, size_t size) {
+    size_t mapped = round_to_pages(size);
+    void  *block  = MVM_platform_alloc_pages(mapped, MVM_PAGE_READ | MVM_PAGE_WRITE);
+    MVM_add(&instance->los_bytes, mapped);
+    MVM_incr(&instance->los_blocks);
+    return block;
+}
+
+/* Resizes a block in the large object space, which may move it. */
+void * MVM_gc_los_realloc(MVMInstance *instance, void *block, size_t old_size, size_t new_size) {
+    size_t old_mapped = round_to_pages(old_size);
+    size_t new_mapped = round_to_pages(new_size);
+    if (new_mapped == old_mapped)
+        return block;
+    block = MVM_platform_realloc_pages(block, old_mapped, new_mapped);
+    MVM_add(&instance->los_bytes, new_mapped - old_mapped);
+    return block;
+}
+
+/* Frees a block in the large object space, giving its memory back to the
+ * OS. */
+void MVM_gc_los_free(MVMInstance *instance, void *block, size_t size) {
+    size_t mapped = round_to_pages(size);
+    MVM_platform_free_pages(block, mapped);
+    MVM_add(&instance->los_bytes, -(AO_t)mapped);
+    MVM_decr(&instance->los_blocks);
+}
@@ -0,0 +1,18 @@
+/* The large object space. The slot storage of big arrays, once it is at
+ * least MVM_LOS_MIN_SIZE bytes, is mapped from the OS a page at a time
+ * rather than taken from malloc. (Objects too big for the size classes of
+ * the second generation never get that big, so stay on malloc.) Blocks are
+ * page aligned, can be grown by remapping rather than copying where the OS
+ * allows it, and go straight back to the OS when freed. The memory they use is counted apart from the rest of the
+ * heap, in the instance. */
+
+/* The smallest size of a block that goes in the large object space. Each
+ * block is a mapping of its own, and the OS limits how many a process may
+ * have, so only blocks big enough that there can't be very many of them go
+ * there. */
+#define MVM_LOS_MIN_SIZE    131072
+
+/* Functions. */
+void * MVM_gc_los_alloc(MVMInstance *instance, size_t size);
+void * MVM_gc_los_realloc(MVMInstance *instance, void *block, size_t old_size, size_t new_size);
+void MVM_gc_los_free(MVMInstance *instance, void *block, size_t size);
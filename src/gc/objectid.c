@@ -1,65 +1,207 @@
 #include "moar.h"
 
+/* Hashes an object address; the top bits pick the shard, and the rest the
+ * slot within its table. */
+MVM_STATIC_INLINE MVMuint64 hash_addr(MVMCollectable *item) {
+    return ((MVMuint64)(uintptr_t)item >> 3) * 0x9E3779B97F4A7C15ULL;
+}
+MVM_STATIC_INLINE MVMObjectIdShard * shard_for(MVMInstance *instance, MVMuint64 hash) {
+    return &(instance->object_ids[hash >> (64 - MVM_OBJECT_ID_SHARD_BITS)]);
+}
+MVM_STATIC_INLINE MVMuint32 slot_for(MVMObjectIdTable *table, MVMuint64 hash) {
+    return (MVMuint32)(hash >> 16) & table->mask;
+}
+
+/* Allocates an empty table with the specified number of slots. */
+static MVMObjectIdTable * alloc_table(MVMuint32 slots) {
+    MVMObjectIdTable *table = MVM_calloc(1, sizeof(MVMObjectIdTable)
+        + (slots - 1) * sizeof(MVMObjectIdEntry));
+    table->mask = slots - 1;
+    return table;
+}
+
+/* Looks up the entry for an object. Safe to do without holding the lock of
+ * the shard: an entry is filled in before its key is set, and entries never
+ * move within a table, since removing one leaves a tombstone. */
+static MVMObjectIdEntry * find_entry(MVMObjectIdTable *table, MVMCollectable *item,
+                                     MVMuint64 hash) {
+    MVMuint32 slot = slot_for(table, hash);
+    while (1) {
+        MVMObjectIdEntry *entry   = &(table->entries[slot]);
+        MVMCollectable   *current = (MVMCollectable *)MVM_load(&(entry->current));
+        if (current == item)
+            return entry;
+        if (!current)
+            return NULL;
+        slot = (slot + 1) & table->mask;
+    }
+}
+
+/* Adds an entry to a table known to have space for it, returning it. */
+static MVMObjectIdEntry * add_entry(MVMObjectIdTable *table, MVMCollectable *item,
+                                    MVMCollectable *gen2_addr, MVMuint64 hash) {
+    MVMuint32 slot = slot_for(table, hash);
+    while (table->entries[slot].current)
+        slot = (slot + 1) & table->mask;
+    table->entries[slot].gen2_addr = gen2_addr;
+    MVM_store(&(table->entries[slot].current), item);
+    table->used++;
+    return &(table->entries[slot]);
+}
+
+/* Rebuilds the table of a shard if adding another entry would make it more
+ * than three quarters full, counting tombstones. The new table leaves the
+ * tombstones behind, and is only twice the size if the live entries alone
+ * would fill more than half of it. Must hold the shard's lock. */
+static void maybe_grow(MVMObjectIdShard *shard) {
+    MVMObjectIdTable *old_table = shard->table;
+    MVMObjectIdTable *new_table;
+    MVMuint32 slots = old_table->mask + 1;
+    MVMuint32 i;
+    if ((old_table->used + 1) * 4 <= slots * 3)
+        return;
+    if ((old_table->used - old_table->removed + 1) * 2 > slots)
+        slots *= 2;
+    new_table = alloc_table(slots);
+    for (i = 0; i <= old_table->mask; i++) {
+        MVMObjectIdEntry *entry = &(old_table->entries[i]);
+        if (entry->current && entry->current != MVM_OBJECT_ID_TOMBSTONE)
+            add_entry(new_table, entry->current, entry->gen2_addr, hash_addr(entry->current));
+    }
+    MVM_store(&(shard->table), new_table);
+    old_table->next_retired = shard->retired;
+    shard->retired = old_table;
+}
+
+/* Removes an entry from a table by turning it into a tombstone, which keeps
+ * the probe sequences through it intact. Must hold the shard's lock. This
+ * may happen while other threads are running (the GC frees nurseries after
+ * releasing them), but nothing can be looking up the removed object, which
+ * is either dead or being moved during collection; lookups of others just
+ * probe past the tombstone. The slot is only reclaimed when the table is
+ * next rebuilt. */
+static void remove_entry(MVMObjectIdTable *table, MVMObjectIdEntry *entry) {
+    MVM_store(&(entry->current), MVM_OBJECT_ID_TOMBSTONE);
+    table->removed++;
+}
+
 /* Gets a stable identifier for an object, which will not change even if the
  * GC moves the object. */
 MVMuint64 MVM_gc_object_id(MVMThreadContext *tc, MVMObject *obj) {
-    MVMuint64 id;
+    MVMCollectable   *item = &(obj->header);
+    MVMuint64         hash;
+    MVMObjectIdShard *shard;
+    MVMObjectIdEntry *entry;
+    MVMuint64         id;
 
     /* If it's already in the old generation, just use memory address, as
      * gen2 objects never move. */
-    if (obj->header.flags & MVM_CF_SECOND_GEN) {
-        id = (MVMuint64)obj;
-    }
+    if (item->flags & MVM_CF_SECOND_GEN)
+        return (MVMuint64)obj;
 
     /* Otherwise, see if we already have a persistent object ID. */
-    else {
-        MVMObjectId *entry;
-        uv_mutex_lock(&tc->instance->mutex_object_ids);
-        if (obj->header.flags & MVM_CF_HAS_OBJECT_ID) {
-            /* Has one, so just look up by address in the hash ID hash. */
-            HASH_FIND(hash_handle, tc->instance->object_ids, (void *)&obj,
-                sizeof(MVMObject *), entry);
-        }
-        else {
-            /* Hasn't got one; allocate it a place in gen2 and make an entry
-             * in the persistent object ID hash. */
-            entry            = MVM_calloc(1, sizeof(MVMObjectId));
-            entry->current   = obj;
-            entry->gen2_addr = MVM_gc_gen2_allocate_zeroed(tc->gen2, obj->header.size);
-            HASH_ADD_KEYPTR(hash_handle, tc->instance->object_ids, &(entry->current),
-                sizeof(MVMObject *), entry);
-            obj->header.flags |= MVM_CF_HAS_OBJECT_ID;
-        }
-        id = (MVMuint64)entry->gen2_addr;
-        uv_mutex_unlock(&tc->instance->mutex_object_ids);
+    hash  = hash_addr(item);
+    shard = shard_for(tc->instance, hash);
+    if (item->flags & MVM_CF_HAS_OBJECT_ID) {
+        entry = find_entry((MVMObjectIdTable *)MVM_load(&(shard->table)), item, hash);
+        if (entry)
+            return (MVMuint64)entry->gen2_addr;
+    }
+
+    /* Hasn't got one, or it was added to a table we didn't see yet; take the
+     * lock and look again, and if it really has none then allocate it a
+     * place in gen2 and make an entry for it. */
+    uv_mutex_lock(&shard->mutex);
+    entry = item->flags & MVM_CF_HAS_OBJECT_ID
+        ? find_entry(shard->table, item, hash)
+        : NULL;
+    if (!entry) {
+        maybe_grow(shard);
+        entry = add_entry(shard->table, item,
+            MVM_gc_gen2_allocate_zeroed(tc->gen2, item->size), hash);
+        MVM_barrier();
+        item->flags |= MVM_CF_HAS_OBJECT_ID;
+
+        /* Objects of types whose objects get asked for their IDs may be
+         * allocated in gen2 from the start, where their address serves. */
+        if (tc->instance->object_id_pretenure && !(item->flags & MVM_CF_TYPE_OBJECT)
+                && !MVM_load(&obj->st->pretenure_left))
+            MVM_store(&obj->st->pretenure_left, MVM_GC_PRETENURE_ALLOCS);
     }
+    id = (MVMuint64)entry->gen2_addr;
+    uv_mutex_unlock(&shard->mutex);
 
     return id;
 }
 
 /* If an object with an entry here lives long enough to be promoted to gen2,
- * this removes the hash entry for it and returns the pre-allocated gen2
+ * this removes the entry for it and returns the pre-allocated gen2
  * address. */
 void * MVM_gc_object_id_use_allocation(MVMThreadContext *tc, MVMCollectable *item) {
-    MVMObjectId *entry;
-    void        *addr;
-    uv_mutex_lock(&tc->instance->mutex_object_ids);
-    HASH_FIND(hash_handle, tc->instance->object_ids, (void *)&item, sizeof(MVMObject *), entry);
-    addr = entry->gen2_addr;
-    HASH_DELETE(hash_handle, tc->instance->object_ids, entry);
-    MVM_free(entry);
+    MVMuint64         hash  = hash_addr(item);
+    MVMObjectIdShard *shard = shard_for(tc->instance, hash);
+    MVMObjectIdEntry *entry;
+    void             *addr;
+    uv_mutex_lock(&shard->mutex);
+    entry = find_entry(shard->table, item, hash);
+    addr  = entry->gen2_addr;
+    remove_entry(shard->table, entry);
     item->flags ^= MVM_CF_HAS_OBJECT_ID;
-    uv_mutex_unlock(&tc->instance->mutex_object_ids);
+    uv_mutex_unlock(&shard->mutex);
     return addr;
 }
 
-/* Clears hash entry for a persistent object ID when an object dies in the
+/* Clears the entry for a persistent object ID when an object dies in the
  * nursery. */
 void MVM_gc_object_id_clear(MVMThreadContext *tc, MVMCollectable *item) {
-    MVMObjectId *entry;
-    uv_mutex_lock(&tc->instance->mutex_object_ids);
-    HASH_FIND(hash_handle, tc->instance->object_ids, (void *)&item, sizeof(MVMObject *), entry);
-    HASH_DELETE(hash_handle, tc->instance->object_ids, entry);
-    MVM_free(entry);
-    uv_mutex_unlock(&tc->instance->mutex_object_ids);
+    MVMuint64         hash  = hash_addr(item);
+    MVMObjectIdShard *shard = shard_for(tc->instance, hash);
+    MVMObjectIdEntry *entry;
+    uv_mutex_lock(&shard->mutex);
+    entry = find_entry(shard->table, item, hash);
+    if (entry)
+        remove_entry(shard->table, entry);
+    uv_mutex_unlock(&shard->mutex);
+}
+
+/* Frees tables retired since the last GC run. Called while the world is
+ * stopped, so nothing can be looking anything up in them. */
+void MVM_gc_object_id_free_retired(MVMInstance *instance) {
+    MVMuint32 i;
+    for (i = 0; i < MVM_OBJECT_ID_SHARDS; i++) {
+        MVMObjectIdTable *table = instance->object_ids[i].retired;
+        while (table) {
+            MVMObjectIdTable *next = table->next_retired;
+            MVM_free(table);
+            table = next;
+        }
+        instance->object_ids[i].retired = NULL;
+    }
+}
+
+/* Sets up the persistent object ID shards. */
+void MVM_gc_object_id_init(MVMInstance *instance) {
+    MVMuint32 i;
+    int init_stat;
+    instance->object_ids = MVM_calloc(MVM_OBJECT_ID_SHARDS, sizeof(MVMObjectIdShard));
+    for (i = 0; i < MVM_OBJECT_ID_SHARDS; i++) {
+        instance->object_ids[i].table = alloc_table(MVM_OBJECT_ID_MIN_SLOTS);
+        if ((init_stat = uv_mutex_init(&(instance->object_ids[i].mutex))) < 0) {
+            fprintf(stderr, "MoarVM: Initialization of object ID mutex failed\n    %s\n",
+                uv_strerror(init_stat));
+            exit(1);
+        }
+    }
+}
+
+/* Frees the persistent object ID shards. */
+void MVM_gc_object_id_destroy(MVMInstance *instance) {
+    MVMuint32 i;
+    MVM_gc_object_id_free_retired(instance);
+    for (i = 0; i < MVM_OBJECT_ID_SHARDS; i++) {
+        MVM_free(instance->object_ids[i].table);
+        uv_mutex_destroy(&(instance->object_ids[i].mutex));
+    }
+    MVM_free(instance->object_ids);
+    instance->object_ids = NULL;
 }
@@ -1,3 +1,58 @@
+/* Persistent object IDs. Objects in gen2 never move, so their address is
+ * their ID. A nursery object asked for its ID is given a place in gen2 up
+ * front, which is its ID and where it will be moved to when it is next
+ * collected. Until then, that address is kept in a table keyed on the
+ * current address of the object. The table is split into shards by address,
+ * each an open-addressing hash with its own lock. Looking up an ID needs no
+ * lock; adding one takes the lock of the shard, as do the updates the GC
+ * makes, since threads collecting different nurseries may share a shard.
+ * Entries never move within a table, so removals leave tombstones, which go
+ * away when the table is rebuilt into a new one. */
+#define MVM_OBJECT_ID_SHARD_BITS    6
+#define MVM_OBJECT_ID_SHARDS        (1 << MVM_OBJECT_ID_SHARD_BITS)
+#define MVM_OBJECT_ID_MIN_SLOTS     64
+
+/* Marks the slot of a removed entry. */
+#define MVM_OBJECT_ID_TOMBSTONE     ((MVMCollectable *)1)
+
+/* An entry in a persistent object ID table. */
+struct MVMObjectIdEntry {
+    /* The current object address, NULL if the slot is free, or
+     * MVM_OBJECT_ID_TOMBSTONE if its entry was removed. */
+    MVMCollectable *current;
+
+    /* The gen2 address that forms the persistent ID, and where we'll move
+     * the object to if it lives long enough. */
+    MVMCollectable *gen2_addr;
+};
+
+/* An open-addressing table of persistent object IDs. */
+struct MVMObjectIdTable {
+    /* Number of slots, less one (it's a power of two), slots in use, and
+     * how many of those hold tombstones. */
+    MVMuint32 mask;
+    MVMuint32 used;
+    MVMuint32 removed;
+
+    /* The next table retired along with this one, if any. */
+    MVMObjectIdTable *next_retired;
+
+    /* The slots. */
+    MVMObjectIdEntry entries[1];
+};
+
+/* A shard of the persistent object IDs. When its table is grown, the old one
+ * may still be in use by a thread looking up an ID, so it is retired, and
+ * only freed in the next GC run, when no thread can be using it. */
+struct MVMObjectIdShard {
+    MVMObjectIdTable *table;
+    MVMObjectIdTable *retired;
+    uv_mutex_t        mutex;
+};
+
 MVMuint64 MVM_gc_object_id(MVMThreadContext *tc, MVMObject *obj);
 void * MVM_gc_object_id_use_allocation(MVMThreadContext *tc, MVMCollectable *item);
 void MVM_gc_object_id_clear(MVMThreadContext *tc, MVMCollectable *item);
+void MVM_gc_object_id_free_retired(MVMInstance *instance);
+void MVM_gc_object_id_init(MVMInstance *instance);
+void MVM_gc_object_id_destroy(MVMInstance *instance);
@@ -53,6 +53,15 @@ static MVMuint32 signal_one_thread(MVMThreadContext *tc, MVMThreadContext *to_si
             case MVMGCStatus_STOLEN:
                 GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : thread %d already stolen (it was a spawning child)\n", to_signal->thread_id);
                 return 0;
+            /* The CPU sampler asked the thread for a sample; turn that into
+             * an interrupt, since it's going to join the run instead. */
+            case MVMGCStatus_SAMPLE:
+                if (MVM_cas(&to_signal->gc_status, MVMGCStatus_SAMPLE,
+                        MVMGCStatus_INTERRUPT) == MVMGCStatus_SAMPLE) {
+                    GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : Signalled sampling thread %d to interrupt\n", to_signal->thread_id);
+                    return 1;
+                }
+                break;
             default:
                 MVM_panic(MVM_exitcode_gcorch, "invalid status %"MVM_PRSz" in GC orchestrate\n", MVM_load(&to_signal->gc_status));
                 return 0;
@@ -111,13 +120,25 @@ static int process_in_tray(MVMThreadContext *tc, MVMuint8 gen) {
     return 0;
 }
 
+/* Does gen2 marking work that other threads shared, if any. Returns a
+ * non-zero value if work was found and done, and zero otherwise. */
+static int process_shared_work(MVMThreadContext *tc, MVMuint8 gen) {
+    if (gen == MVMGCGenerations_Both && MVM_load(&tc->instance->gc_shared_work)) {
+        GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
+            "Thread %d run %d : Taking shared gen2 work\n");
+        MVM_gc_collect(tc, MVMGCWhatToDo_Shared, gen);
+        return 1;
+    }
+    return 0;
+}
+
 /* Called by a thread when it thinks it is done with GC. It may get some more
  * work yet, though. */
 static void clear_intrays(MVMThreadContext *tc, MVMuint8 gen) {
     MVMuint32 did_work = 1;
     while (did_work) {
         MVMThread *cur_thread;
-        did_work = 0;
+        did_work = process_shared_work(tc, gen);
         cur_thread = (MVMThread *)MVM_load(&tc->instance->threads);
         while (cur_thread) {
             if (cur_thread->body.tc)
@@ -126,27 +147,43 @@ static void clear_intrays(MVMThreadContext *tc, MVMuint8 gen) {
         }
     }
 }
+/* Does any work that we have been passed or that other threads shared,
+ * until there is none left. */
+static void do_extra_work(MVMThreadContext *tc, MVMuint8 gen) {
+    MVMuint32 i, did_work = 1;
+    while (did_work) {
+        did_work = process_shared_work(tc, gen);
+        for (i = 0; i < tc->gc_work_count; i++)
+            did_work += process_in_tray(tc->gc_work[i].tc, gen);
+    }
+}
+
 static void finish_gc(MVMThreadContext *tc, MVMuint8 gen, MVMuint8 is_coordinator) {
-    MVMuint32 i, did_work;
+    MVMuint32 i;
+    AO_t      votes;
 
     /* Do any extra work that we have been passed. */
     GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
         "Thread %d run %d : doing any work in thread in-trays\n");
-    did_work = 1;
-    while (did_work) {
-        did_work = 0;
-        for (i = 0; i < tc->gc_work_count; i++)
-            did_work += process_in_tray(tc->gc_work[i].tc, gen);
-    }
+    do_extra_work(tc, gen);
 
-    /* Decrement gc_finish to say we're done, and wait for termination. */
+    /* Decrement gc_finish to say we're done, and wait for termination. If
+     * other threads share work while we wait, take back our vote (which is
+     * only possible while some thread has yet to vote) and help out. */
     GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : Voting to finish\n");
     MVM_decr(&tc->instance->gc_finish);
-    while (MVM_load(&tc->instance->gc_finish)) {
+    while ((votes = MVM_load(&tc->instance->gc_finish))) {
+        if (gen == MVMGCGenerations_Both && MVM_load(&tc->instance->gc_shared_work)) {
+            if (MVM_trycas(&tc->instance->gc_finish, votes, votes + 1)) {
+                GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
+                    "Thread %d run %d : Took back finish vote to help with shared work\n");
+                do_extra_work(tc, gen);
+                MVM_decr(&tc->instance->gc_finish);
+            }
+            continue;
+        }
         for (i = 0; i < 1000; i++)
             ; /* XXX Something HT-efficienter. */
-        /* XXX Here we can look to see if we got passed any work, and if so
-         * try to un-vote. */
     }
     GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : Termination agreed\n");
 
@@ -182,9 +219,26 @@ static void finish_gc(MVMThreadContext *tc, MVMuint8 gen, MVMuint8 is_coordinato
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
             "Thread %d run %d : Co-ordinator handling fixed-size allocator safepoint frees\n");
         MVM_fixed_size_safepoint(tc, tc->instance->fsa);
+        MVM_gc_object_id_free_retired(tc->instance);
+        if (gen == MVMGCGenerations_Both)
+            MVM_fixed_size_release_empty_pages(tc, tc->instance->fsa);
 
         MVM_profile_heap_take_snapshot(tc);
 
+        if (gen == MVMGCGenerations_Both) {
+            GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
+                "Thread %d run %d : Co-ordinator planning gen2 sweep\n");
+            MVM_gc_collect_plan_gen2_sweep(tc);
+            if (tc->instance->gc_marking == MVM_GC_MARKING_REMARK)
+                MVM_gc_incremental_finish(tc);
+            tc->instance->gc_full_cycles++;
+        }
+        else if (tc->instance->gc_marking) {
+            GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
+                "Thread %d run %d : Co-ordinator doing a gen2 marking slice\n");
+            MVM_gc_incremental_slice(tc);
+        }
+
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
             "Thread %d run %d : Co-ordinator signalling in-trays clear\n");
         MVM_store(&tc->instance->gc_intrays_clearing, 0);
@@ -199,6 +253,23 @@ static void finish_gc(MVMThreadContext *tc, MVMuint8 gen, MVMuint8 is_coordinato
             "Thread %d run %d : Got in-tray clearing complete notice\n");
     }
 
+    /* If it's a full collection, all of the threads sweep the gen2 heaps
+     * together, and then each links up the free lists of the heaps of the
+     * threads it is doing GC work for. This includes the heaps of threads
+     * about to be destroyed, so nothing they transfer is left marked. */
+    if (gen == MVMGCGenerations_Both) {
+        GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
+            "Thread %d run %d : sweeping gen2 partitions\n");
+        MVM_gc_collect_sweep_gen2_partitions(tc);
+        for (i = 0; i < tc->gc_work_count; i++) {
+            MVMThreadContext *other = tc->gc_work[i].tc;
+            GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
+                "Thread %d run %d : finishing gen2 sweep of thread %d\n",
+                other->thread_id);
+            MVM_gc_collect_finish_gen2_sweep(tc, other->gen2);
+        }
+    }
+
     /* Reset GC status flags. This is also where thread destruction happens,
      * and it needs to happen before we acknowledge this GC run is finished. */
     for (i = 0; i < tc->gc_work_count; i++) {
@@ -215,22 +286,19 @@ static void finish_gc(MVMThreadContext *tc, MVMuint8 gen, MVMuint8 is_coordinato
             MVM_store(&thread_obj->body.stage, MVM_thread_stage_destroyed);
         }
         else {
-            /* Free gen2 unmarked if full collection. */
-            if (gen == MVMGCGenerations_Both) {
-                GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
-                    "Thread %d run %d : freeing gen2 of thread %d\n",
-                    other->thread_id);
-                MVM_gc_collect_free_gen2_unmarked(other, 0);
-            }
-
-            /* Contribute this thread's promoted bytes. */
-            MVM_add(&tc->instance->gc_promoted_bytes_since_last_full, other->gc_promoted_bytes);
-
-            /* Collect nursery. */
+            /* Contribute this thread's promoted and pretenured bytes. */
+            MVM_add(&tc->instance->gc_promoted_bytes_since_last_full,
+                other->gc_promoted_bytes + other->gc_pretenured_bytes);
+            MVM_add(&tc->instance->gc_promoted_bytes_total,
+                other->gc_promoted_bytes + other->gc_pretenured_bytes);
+            other->gc_pretenured_bytes = 0;
+
+            /* Collect nursery, noting how much survived in it. */
             GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
                 "Thread %d run %d : collecting nursery uncopied of thread %d\n",
                 other->thread_id);
             MVM_gc_collect_free_nursery_uncopied(other, tc->gc_work[i].limit);
+            other->nursery_survived = (char *)other->nursery_alloc - (char *)other->nursery_tospace;
 
             /* Handle exited threads. */
             if (MVM_load(&thread_obj->body.stage) == MVM_thread_stage_exited) {
@@ -269,9 +337,12 @@ void MVM_gc_mark_thread_blocked(MVMThreadContext *tc) {
             return;
 
         /* The only way this can fail is if another thread just decided we're to
-         * participate in a GC run. */
+         * participate in a GC run, or the CPU sampler wanted a sample; we skip
+         * those, since blocked threads aren't sampled. */
         if (MVM_load(&tc->gc_status) == MVMGCStatus_INTERRUPT)
             MVM_gc_enter_from_interrupt(tc);
+        else if (MVM_load(&tc->gc_status) == MVMGCStatus_SAMPLE)
+            MVM_cas(&tc->gc_status, MVMGCStatus_SAMPLE, MVMGCStatus_NONE);
         else
             MVM_panic(MVM_exitcode_gcorch,
                 "Invalid GC status observed while blocking thread; aborting");
@@ -327,6 +398,51 @@ static MVMint32 is_full_collection(MVMThreadContext *tc) {
     return percent_growth >= MVM_GC_GEN2_THRESHOLD_PERCENT;
 }
 
+/* Decides what kind of collection to do. Normally, that's a nursery one
+ * unless enough has been promoted to gen2 to make a full one worthwhile.
+ * With incremental marking, it instead starts a marking cycle, and does
+ * the full collection as a remark once the cycle has marked all it can. */
+static MVMint32 decide_full_collection(MVMThreadContext *tc) {
+    MVMInstance *instance = tc->instance;
+    if (!instance->gc_incremental)
+        return is_full_collection(tc);
+    switch (instance->gc_marking) {
+        case MVM_GC_MARKING_NONE:
+            if (is_full_collection(tc))
+                instance->gc_marking = MVM_GC_MARKING_STARTING;
+            return 0;
+        case MVM_GC_MARKING_ACTIVE:
+            if (instance->gc_num_mark_stack == 0
+                    || instance->gc_marking_slices >= MVM_GC_MARK_MAX_SLICES) {
+                instance->gc_marking = MVM_GC_MARKING_REMARK;
+                return 1;
+            }
+            return 0;
+        default:
+            MVM_panic(MVM_exitcode_gcorch, "Invalid GC marking state %u\n", instance->gc_marking);
+            return 0;
+    }
+}
+
+/* Records how long a GC run stopped the world for. */
+static void record_pause(MVMThreadContext *tc, MVMuint32 kind, MVMuint64 start) {
+    MVMGCPauseStats *stats  = &tc->instance->gc_pauses[kind];
+    MVMuint64        pause  = uv_hrtime() - start;
+    MVMuint64        scaled = pause >> 15;
+    MVMuint32        bucket = 0;
+    stats->count++;
+    stats->total += pause;
+    if (pause > stats->max)
+        stats->max = pause;
+    while (scaled && bucket < MVM_GC_PAUSE_BUCKETS - 1) {
+        scaled >>= 1;
+        bucket++;
+    }
+    stats->histogram[bucket]++;
+    tc->instance->gc_last_pause_kind = kind;
+    tc->instance->gc_last_pause      = pause;
+}
+
 static void run_gc(MVMThreadContext *tc, MVMuint8 what_to_do) {
     MVMuint8   gen;
     MVMuint32  i, n;
@@ -376,6 +492,8 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
     if (MVM_trycas(&tc->instance->gc_start, 0, 1)) {
         MVMThread *last_starter = NULL;
         MVMuint32 num_threads = 0;
+        MVMuint64 start_time = uv_hrtime();
+        MVMuint32 pause_kind;
 
         /* Need to wait for other threads to reset their gc_status. */
         while (MVM_load(&tc->instance->gc_ack)) {
@@ -393,7 +511,10 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
             (int)MVM_load(&tc->instance->gc_seq_number));
 
         /* Decide if it will be a full collection. */
-        tc->instance->gc_full_collect = is_full_collection(tc);
+        tc->instance->gc_full_collect = decide_full_collection(tc);
+        pause_kind = tc->instance->gc_full_collect
+            ? (tc->instance->gc_marking ? MVM_GC_PAUSE_REMARK : MVM_GC_PAUSE_FULL)
+            : (tc->instance->gc_marking ? MVM_GC_PAUSE_MARKING : MVM_GC_PAUSE_NURSERY);
 
         MVM_telemetry_timestamp(tc, "won the gc starting race");
 
@@ -444,6 +565,7 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
         /* gc_ack gets an extra so the final acknowledger
          * can also free the STables. */
         MVM_store(&tc->instance->gc_finish, num_threads + 1);
+        tc->instance->gc_participants = num_threads + 1;
         MVM_store(&tc->instance->gc_ack, num_threads + 2);
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : finish votes is %d\n",
             (int)MVM_load(&tc->instance->gc_finish));
@@ -468,11 +590,15 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
         /* Start collecting. */
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : coordinator entering run_gc\n");
         run_gc(tc, MVMGCWhatToDo_All);
+        record_pause(tc, pause_kind, start_time);
 
         /* If profiling, record that GC is over. */
         if (tc->instance->profiling)
             MVM_profiler_log_gc_end(tc);
 
+        /* If the language wants to know about GC runs, arrange to tell it. */
+        MVM_gc_stats_setup_handler_call(tc);
+
         MVM_telemetry_timestamp(tc, "gc finished");
 
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : GC complete (cooridnator)\n");
@@ -489,8 +615,20 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
  * that another thread is already trying to start a GC run, so we don't need to
  * try and do that, just enlist in the run. */
 void MVM_gc_enter_from_interrupt(MVMThreadContext *tc) {
+    void *jit_label = tc->cpu_sample_jit_label;
     AO_t curr;
 
+    /* If the CPU sampler signalled us rather than a GC run, take a sample
+     * and carry on. If we lose the race to put the status back, a GC run
+     * has just turned it into an interrupt, so join in with that. */
+    tc->cpu_sample_jit_label = NULL;
+    if (MVM_load(&tc->gc_status) == MVMGCStatus_SAMPLE
+            && MVM_cas(&tc->gc_status, MVMGCStatus_SAMPLE,
+                MVMGCStatus_NONE) == MVMGCStatus_SAMPLE) {
+        MVM_profile_cpu_sample(tc, jit_label);
+        return;
+    }
+
     GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : Entered from interrupt\n");
 
     MVM_telemetry_timestamp(tc, "gc_enter_from_interrupt");
@@ -536,6 +674,7 @@ void MVM_gc_global_destruction(MVMThreadContext *tc) {
     nursery_tmp = tc->nursery_fromspace;
     tc->nursery_fromspace = tc->nursery_tospace;
     tc->nursery_tospace = nursery_tmp;
+    tc->nursery_fromspace_size = tc->nursery_size;
 
     /* Run the objects' finalizers */
     MVM_gc_collect_free_nursery_uncopied(tc, tc->nursery_alloc);
@@ -543,3 +682,23 @@ void MVM_gc_global_destruction(MVMThreadContext *tc) {
     MVM_gc_collect_free_gen2_unmarked(tc, 1);
     MVM_gc_collect_free_stables(tc);
 }
+
+/* Writes a summary of GC pause times to the given file handle. */
+void MVM_gc_report_pause_stats(MVMInstance *instance, FILE *fh) {
+    MVMuint32 i;
+    fprintf(fh, "%-16s %10s %14s %14s %14s\n", "kind", "count", "total (us)",
+        "mean (us)", "max (us)");
+    for (i = 0; i < MVM_GC_PAUSE_KINDS; i++) {
+        MVMGCPauseStats *stats = &instance->gc_pauses[i];
+        fprintf(fh, "%-16s %10"PRIu64" %14"PRIu64" %14"PRIu64" %14"PRIu64"\n",
+            MVM_gc_stats_pause_kind_name(i),
+            stats->count, stats->total / 1000,
+            stats->count ? stats->total / stats->count / 1000 : 0,
+            stats->max / 1000);
+    }
+    fprintf(fh, "released page bytes: %"PRIu64"\n",
+        (MVMuint64)MVM_load(&instance->released_page_bytes));
+    fprintf(fh, "large object space: %"PRIu64" blocks, %"PRIu64" bytes\n",
+        (MVMuint64)MVM_load(&instance->los_blocks),
+        (MVMuint64)MVM_load(&instance->los_bytes));
+}
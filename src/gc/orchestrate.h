@@ -4,6 +4,7 @@ MVM_PUBLIC void MVM_gc_mark_thread_blocked(MVMThreadContext *tc);
 MVM_PUBLIC void MVM_gc_mark_thread_unblocked(MVMThreadContext *tc);
 MVM_PUBLIC MVMint32 MVM_gc_is_thread_blocked(MVMThreadContext *tc);
 void MVM_gc_global_destruction(MVMThreadContext *tc);
+void MVM_gc_report_pause_stats(MVMInstance *instance, FILE *fh);
 
 struct MVMWorkThread {
     MVMThreadContext *tc;
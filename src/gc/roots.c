@@ -69,7 +69,8 @@ void MVM_gc_root_add_instance_roots_to_worklist(MVMThreadContext *tc, MVMGCWorkl
     MVMLoadedCompUnitName       *current_lcun, *tmp_lcun;
     unsigned                     bucket_tmp;
     MVMString                  **int_to_str_cache;
-    MVMuint32                    i;
+    MVMIntConstCache            *int_const_cache;
+    MVMuint32                    i, j;
 
     add_collectable(tc, worklist, snapshot, tc->instance->threads, "Thread list");
     add_collectable(tc, worklist, snapshot, tc->instance->compiler_registry, "Compiler registry");
@@ -78,12 +79,41 @@ void MVM_gc_root_add_instance_roots_to_worklist(MVMThreadContext *tc, MVMGCWorkl
     add_collectable(tc, worklist, snapshot, tc->instance->event_loop_todo_queue, "Event loop todo queue");
     add_collectable(tc, worklist, snapshot, tc->instance->event_loop_cancel_queue, "Event loop cancel queue");
     add_collectable(tc, worklist, snapshot, tc->instance->event_loop_active, "Event loop active");
+    add_collectable(tc, worklist, snapshot, tc->instance->spesh_queue, "Spesh work queue");
 
     int_to_str_cache = tc->instance->int_to_str_cache;
     for (i = 0; i < MVM_INT_TO_STR_CACHE_SIZE; i++)
         add_collectable(tc, worklist, snapshot, int_to_str_cache[i],
             "Integer to string cache entry");
 
+    /* Boxed constant cache; only types that are set have their boxes in
+     * place. */
+    int_const_cache = tc->instance->int_const_cache;
+    for (i = 0; i < int_const_cache->max_types; i++) {
+        if (int_const_cache->int_types[i]) {
+            MVMuint32 num_ints = (MVMuint32)(int_const_cache->max - int_const_cache->min + 1);
+            add_collectable(tc, worklist, snapshot, int_const_cache->int_types[i],
+                "Boxed integer cache type");
+            for (j = 0; j < num_ints; j++)
+                add_collectable(tc, worklist, snapshot, int_const_cache->int_cache[i][j],
+                    "Boxed integer cache entry");
+        }
+        if (int_const_cache->num_types[i]) {
+            add_collectable(tc, worklist, snapshot, int_const_cache->num_types[i],
+                "Boxed num cache type");
+            for (j = 0; j < MVM_INTCACHE_NUMS; j++)
+                add_collectable(tc, worklist, snapshot, int_const_cache->num_cache[i][j],
+                    "Boxed num cache entry");
+        }
+        if (int_const_cache->str_types[i]) {
+            add_collectable(tc, worklist, snapshot, int_const_cache->str_types[i],
+                "Boxed string cache type");
+            for (j = 0; j < MVM_INTCACHE_STRS; j++)
+                add_collectable(tc, worklist, snapshot, int_const_cache->str_cache[i][j],
+                    "Boxed string cache entry");
+        }
+    }
+
     /* okay, so this makes the weak hash slightly less weak.. for certain
      * keys of it anyway... */
     HASH_ITER(hash_handle, tc->instance->sc_weakhash, current, tmp, bucket_tmp) {
@@ -107,6 +137,12 @@ void MVM_gc_root_add_instance_roots_to_worklist(MVMThreadContext *tc, MVMGCWorkl
 
     add_collectable(tc, worklist, snapshot, tc->instance->cached_backend_config,
         "Cached backend configuration hash");
+
+    /* Allocation and CPU samples. */
+    if (worklist) {
+        MVM_profile_alloc_sample_mark(tc, worklist);
+        MVM_profile_cpu_mark(tc, worklist);
+    }
 }
 
 /* Adds anything that is a root thanks to being referenced by a thread,
@@ -175,8 +211,10 @@ void MVM_gc_root_add_tc_roots_to_worklist(MVMThreadContext *tc, MVMGCWorklist *w
     }
 
     /* Profiling data. */
-    if (worklist)
+    if (worklist) {
         MVM_profile_instrumented_mark_data(tc, worklist);
+        MVM_profile_alloc_sample_mark_thread(tc, worklist);
+    }
 
     /* Serialized string heap, if any. */
     add_collectable(tc, worklist, snapshot, tc->serialized_string_heap,
@@ -289,9 +327,24 @@ void MVM_gc_root_add_gen2s_to_worklist(MVMThreadContext *tc, MVMGCWorklist *work
 
         /* Put things it references into the worklist; since the worklist will
          * be set not to include gen2 things, only nursery things will make it
-         * in. */
+         * in. Objects that do card marking only get the slots of their dirty
+         * cards scanned, unless they were made a root by something other
+         * than their card marking write barrier. */
         assert(!(gen2roots[i]->flags & MVM_CF_FORWARDER_VALID));
-        MVM_gc_mark_collectable(tc, worklist, gen2roots[i]);
+        if (!(gen2roots[i]->flags & (MVM_CF_TYPE_OBJECT | MVM_CF_STABLE | MVM_CF_FRAME))
+                && REPR(gen2roots[i])->gc_mark_cards) {
+            MVMObject *obj    = (MVMObject *)gen2roots[i];
+            MVMuint32  sc_idx = MVM_sc_get_idx_of_sc(gen2roots[i]);
+            if (sc_idx > 0)
+                MVM_gc_worklist_add(tc, worklist, &(tc->instance->all_scs[sc_idx]->sc));
+            MVM_gc_worklist_add(tc, worklist, &obj->st);
+            REPR(obj)->gc_mark_cards(tc, STABLE(obj), OBJECT_BODY(obj), worklist,
+                !(gen2roots[i]->flags & MVM_CF_DIRTY_CARDS));
+            gen2roots[i]->flags |= MVM_CF_DIRTY_CARDS;
+        }
+        else {
+            MVM_gc_mark_collectable(tc, worklist, gen2roots[i]);
+        }
 
         /* If we added any nursery objects, or if we are a frame with ->work
          * area, keep in this list. */
@@ -305,7 +358,7 @@ void MVM_gc_root_add_gen2s_to_worklist(MVMThreadContext *tc, MVMGCWorklist *work
          * thread may also clear this flag if it also had the entry in its
          * inter-gen list, so be careful to clear it, not just toggle. */
         else {
-            gen2roots[i]->flags &= ~MVM_CF_IN_GEN2_ROOT_LIST;
+            gen2roots[i]->flags &= ~(MVM_CF_IN_GEN2_ROOT_LIST | MVM_CF_DIRTY_CARDS);
         }
     }
 
@@ -360,6 +413,11 @@ void MVM_gc_root_add_frame_roots_to_worklist(MVMThreadContext *tc, MVMGCWorklist
     MVM_gc_worklist_add(tc, worklist, &cur_frame->code_ref);
     MVM_gc_worklist_add(tc, worklist, &cur_frame->static_info);
 
+    /* Note that the frame's spesh candidate is still in use, so it won't
+     * be freed if it is discarded. */
+    if (cur_frame->spesh_cand)
+        cur_frame->spesh_cand->seen_cycle = tc->instance->gc_full_cycles;
+
     /* Mark special return data, if needed. */
     if (cur_frame->special_return_data && cur_frame->mark_special_return_data)
         cur_frame->mark_special_return_data(tc, cur_frame, worklist);
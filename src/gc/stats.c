@@ -0,0 +1,250 @@
+#include "moar.h"
+
+/* Names of the kinds of GC run, as far as pause time statistics go. */
+static const char *pause_kind_names[MVM_GC_PAUSE_KINDS] = {
+    "nursery", "nursery+marking", "full", "remark"
+};
+const char * MVM_gc_stats_pause_kind_name(MVMuint32 kind) {
+    return kind < MVM_GC_PAUSE_KINDS ? pause_kind_names[kind] : "unknown";
+}
+
+/* A snapshot of the figures for a thread. */
+typedef struct {
+    MVMuint64 thread_id;
+    MVMuint64 nursery_size;
+    MVMuint64 nursery_used;
+    MVMuint64 gen2roots;
+} ThreadStats;
+
+/* A snapshot of all of the GC statistics, taken before we build any objects,
+ * since doing that may itself trigger a GC run. */
+typedef struct {
+    MVMuint64        seq;
+    MVMGCPauseStats  pauses[MVM_GC_PAUSE_KINDS];
+    MVMuint32        last_kind;
+    MVMuint64        last_pause;
+    MVMuint64        promoted_bytes;
+    MVMuint64        promoted_bytes_since_last_full;
+    MVMuint64        released_page_bytes;
+    MVMuint64        los_blocks;
+    MVMuint64        los_bytes;
+    MVMuint64        pages[MVM_GEN2_BINS];
+    MVMuint64        overflows;
+    ThreadStats     *threads;
+    MVMuint32        num_threads;
+} Snapshot;
+
+/* Takes the snapshot. Nothing here allocates a collectable, so no GC run can
+ * happen (and so no thread can go away) while we walk the threads. */
+static void take_snapshot(MVMThreadContext *tc, Snapshot *ss) {
+    MVMInstance *instance = tc->instance;
+    MVMThread   *cur_thread;
+    MVMuint32    i;
+
+    memset(ss, 0, sizeof(Snapshot));
+    ss->seq = MVM_load(&instance->gc_seq_number);
+    memcpy(ss->pauses, instance->gc_pauses, sizeof(ss->pauses));
+    ss->last_kind  = instance->gc_last_pause_kind;
+    ss->last_pause = instance->gc_last_pause;
+    ss->promoted_bytes = MVM_load(&instance->gc_promoted_bytes_total);
+    ss->promoted_bytes_since_last_full = MVM_load(&instance->gc_promoted_bytes_since_last_full);
+    ss->released_page_bytes = MVM_load(&instance->released_page_bytes);
+    ss->los_blocks = MVM_load(&instance->los_blocks);
+    ss->los_bytes  = MVM_load(&instance->los_bytes);
+
+    /* Per thread figures, while totting up the gen2 pages of each size
+     * class. */
+    cur_thread = (MVMThread *)MVM_load(&instance->threads);
+    while (cur_thread) {
+        if (cur_thread->body.tc)
+            ss->num_threads++;
+        cur_thread = cur_thread->body.next;
+    }
+    ss->threads = MVM_malloc((ss->num_threads ? ss->num_threads : 1) * sizeof(ThreadStats));
+    ss->num_threads = 0;
+    cur_thread = (MVMThread *)MVM_load(&instance->threads);
+    while (cur_thread) {
+        MVMThreadContext *other = cur_thread->body.tc;
+        if (other) {
+            ThreadStats *ts  = &(ss->threads[ss->num_threads++]);
+            ts->thread_id    = other->thread_id;
+            ts->nursery_size = other->nursery_size;
+            ts->nursery_used = (char *)other->nursery_alloc - (char *)other->nursery_tospace;
+            ts->gen2roots    = other->num_gen2roots;
+            for (i = 0; i < MVM_GEN2_BINS; i++)
+                ss->pages[i] += other->gen2->size_classes[i].num_pages;
+            ss->overflows += other->gen2->num_overflows;
+        }
+        cur_thread = cur_thread->body.next;
+    }
+}
+
+/* Simple allocation functions. Any of them may trigger a GC run, so the
+ * objects they are passed are rooted while they allocate. */
+static MVMObject * new_array(MVMThreadContext *tc) {
+    return MVM_repr_alloc_init(tc, MVM_hll_current(tc)->slurpy_array_type);
+}
+static MVMObject * new_hash(MVMThreadContext *tc) {
+    return MVM_repr_alloc_init(tc, MVM_hll_current(tc)->slurpy_hash_type);
+}
+static MVMObject * box_i(MVMThreadContext *tc, MVMint64 i) {
+    return MVM_repr_box_int(tc, MVM_hll_current(tc)->int_box_type, i);
+}
+static MVMString * str(MVMThreadContext *tc, const char *buf) {
+    return MVM_string_ascii_decode_nt(tc, tc->instance->VMString, buf);
+}
+static void bind_o(MVMThreadContext *tc, MVMObject *hash, const char *key, MVMObject *value) {
+    MVMString *key_str;
+    MVMROOT(tc, hash, {
+        MVMROOT(tc, value, {
+            key_str = str(tc, key);
+        });
+    });
+    MVM_repr_bind_key_o(tc, hash, key_str, value);
+}
+static void bind_i(MVMThreadContext *tc, MVMObject *hash, const char *key, MVMint64 i) {
+    MVMObject *boxed;
+    MVMROOT(tc, hash, {
+        boxed = box_i(tc, i);
+    });
+    bind_o(tc, hash, key, boxed);
+}
+static void bind_s(MVMThreadContext *tc, MVMObject *hash, const char *key, const char *s) {
+    MVMString *s_str;
+    MVMObject *boxed;
+    MVMROOT(tc, hash, {
+        s_str = str(tc, s);
+        boxed = MVM_repr_box_str(tc, MVM_hll_current(tc)->str_box_type, s_str);
+    });
+    bind_o(tc, hash, key, boxed);
+}
+static void push_i(MVMThreadContext *tc, MVMObject *array, MVMint64 i) {
+    MVMObject *boxed;
+    MVMROOT(tc, array, {
+        boxed = box_i(tc, i);
+    });
+    MVM_repr_push_o(tc, array, boxed);
+}
+
+/* Builds a hash of the pause time statistics for a kind of GC run. */
+static MVMObject * pause_stats(MVMThreadContext *tc, MVMGCPauseStats *stats) {
+    MVMObject *hash      = new_hash(tc);
+    MVMObject *histogram = NULL;
+    MVMuint32  i;
+    MVMROOT(tc, hash, {
+        bind_i(tc, hash, "count", stats->count);
+        bind_i(tc, hash, "total", stats->total);
+        bind_i(tc, hash, "max", stats->max);
+        histogram = new_array(tc);
+        MVMROOT(tc, histogram, {
+            for (i = 0; i < MVM_GC_PAUSE_BUCKETS; i++)
+                push_i(tc, histogram, stats->histogram[i]);
+        });
+        bind_o(tc, hash, "histogram", histogram);
+    });
+    return hash;
+}
+
+/* Builds a hash of the GC statistics. Pause times are in nanoseconds. The
+ * figures for the nurseries of other threads are only approximate, since
+ * they may be allocating while we look. The hash is built in the nursery
+ * like anything else, so that calling this after every GC run (as the GC
+ * handler is) doesn't promote a load of objects to gen2 and so skew the
+ * very figures it reports; it's built from a snapshot of the figures, so it
+ * doesn't matter if doing so triggers another run. */
+MVMObject * MVM_gc_stats(MVMThreadContext *tc) {
+    Snapshot   ss;
+    MVMObject *result = NULL;
+    MVMObject *list   = NULL;
+    MVMObject *hash   = NULL;
+    MVMuint32  i;
+
+    take_snapshot(tc, &ss);
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&result);
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&list);
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&hash);
+    result = new_hash(tc);
+
+    /* How many runs there were, and how long they paused for. */
+    bind_i(tc, result, "seq", ss.seq);
+    bind_i(tc, result, "minor_collections",
+        ss.pauses[MVM_GC_PAUSE_NURSERY].count + ss.pauses[MVM_GC_PAUSE_MARKING].count);
+    bind_i(tc, result, "major_collections",
+        ss.pauses[MVM_GC_PAUSE_FULL].count + ss.pauses[MVM_GC_PAUSE_REMARK].count);
+    hash = new_hash(tc);
+    for (i = 0; i < MVM_GC_PAUSE_KINDS; i++) {
+        MVMObject *kind_stats = pause_stats(tc, &ss.pauses[i]);
+        bind_o(tc, hash, pause_kind_names[i], kind_stats);
+    }
+    bind_o(tc, result, "pauses", hash);
+    bind_s(tc, result, "last_kind", MVM_gc_stats_pause_kind_name(ss.last_kind));
+    bind_i(tc, result, "last_pause", ss.last_pause);
+
+    /* What was promoted, and what memory was given back. */
+    bind_i(tc, result, "promoted_bytes", ss.promoted_bytes);
+    bind_i(tc, result, "promoted_bytes_since_last_full", ss.promoted_bytes_since_last_full);
+    bind_i(tc, result, "released_page_bytes", ss.released_page_bytes);
+    bind_i(tc, result, "los_blocks", ss.los_blocks);
+    bind_i(tc, result, "los_bytes", ss.los_bytes);
+
+    /* Per thread figures. */
+    list = new_array(tc);
+    for (i = 0; i < ss.num_threads; i++) {
+        ThreadStats *ts = &(ss.threads[i]);
+        hash = new_hash(tc);
+        bind_i(tc, hash, "thread_id", ts->thread_id);
+        bind_i(tc, hash, "nursery_size", ts->nursery_size);
+        bind_i(tc, hash, "nursery_used", ts->nursery_used);
+        bind_i(tc, hash, "gen2roots", ts->gen2roots);
+        MVM_repr_push_o(tc, list, hash);
+    }
+    bind_o(tc, result, "threads", list);
+
+    /* Size of gen2 by size class; the bytes are those of the pages. */
+    list = new_array(tc);
+    for (i = 0; i < MVM_GEN2_BINS; i++) {
+        MVMuint64 item_size = (MVMuint64)(i + 1) << MVM_GEN2_BIN_BITS;
+        hash = new_hash(tc);
+        bind_i(tc, hash, "item_size", item_size);
+        bind_i(tc, hash, "pages", ss.pages[i]);
+        bind_i(tc, hash, "bytes", ss.pages[i] * MVM_GEN2_PAGE_ITEMS * item_size);
+        MVM_repr_push_o(tc, list, hash);
+    }
+    bind_o(tc, result, "gen2", list);
+    bind_i(tc, result, "gen2_overflows", ss.overflows);
+
+    MVM_gc_root_temp_pop_n(tc, 3);
+    MVM_free(ss.threads);
+    return result;
+}
+
+/* Calls the GC handler of the current language, if it has one, with the
+ * GC statistics. */
+static void gc_handler_caller(MVMThreadContext *tc, void *sr_data) {
+    if (MVM_hll_current(tc)->gc_handler) {
+        MVMCallsite *inv_arg_callsite = MVM_callsite_get_common(tc, MVM_CALLSITE_ID_INV_ARG);
+        MVMObject   *stats            = MVM_gc_stats(tc);
+        MVMObject   *handler;
+        MVMROOT(tc, stats, {
+            handler = MVM_frame_find_invokee(tc, MVM_hll_current(tc)->gc_handler, NULL);
+            MVM_args_setup_thunk(tc, NULL, MVM_RETURN_VOID, inv_arg_callsite);
+        });
+        tc->cur_frame->args[0].o = stats;
+        STABLE(handler)->invoke(tc, handler, inv_arg_callsite, tc->cur_frame->args);
+    }
+}
+
+/* Sets things up so the GC handler of the language is called when we
+ * return to a frame of it, if it has one. Called by the coordinator at the
+ * end of a GC run. */
+void MVM_gc_stats_setup_handler_call(MVMThreadContext *tc) {
+    MVMFrame *install_on = tc->cur_frame;
+    while (install_on) {
+        if (!install_on->special_return)
+            if (install_on->static_info->body.cu->body.hll_config)
+                break;
+        install_on = install_on->caller;
+    }
+    if (install_on && install_on->static_info->body.cu->body.hll_config->gc_handler)
+        install_on->special_return = gc_handler_caller;
+}
@@ -0,0 +1,11 @@
+/* GC statistics for running programs. The counters behind them are always
+ * kept, and are cheap: pause times are recorded by the coordinator of each
+ * GC run, and bytes promoted are summed as each nursery is collected. The
+ * gcstats op gets them as a hash, and a language may set a gc_handler in its
+ * configuration to be invoked with that hash after each GC run, on the thread
+ * that coordinated it. The hash is built in the nursery, from a snapshot of
+ * the figures taken when it is asked for. */
+
+const char * MVM_gc_stats_pause_kind_name(MVMuint32 kind);
+MVMObject * MVM_gc_stats(MVMThreadContext *tc);
+void MVM_gc_stats_setup_handler_call(MVMThreadContext *tc);
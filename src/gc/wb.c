@@ -6,8 +6,57 @@
  * into, and referenced is the object that the pointer references).
  * This barrier forces a re-scan of the object's contents during a GC
  * run - even a nursery only one - since somewhere it has references
- * to a nursery object. */
+ * to a nursery object. If it is already a root that only has its dirty cards
+ * scanned, it will now be scanned in full, since the write may not have
+ * been to a slot covered by a card. Some callers write a batch of references
+ * and then hit the barrier once, so nothing has marked the gen2 objects among
+ * them; if an incremental marking cycle is in progress and the object was
+ * already marked, it is greyed so a later slice (or the remark) scans it
+ * again. (Being an inter-generational root doesn't do that, as the next
+ * nursery collection drops it from the list again.) */
 void MVM_gc_write_barrier_hit(MVMThreadContext *tc, MVMCollectable *update_root) {
+    MVMuint32 marking;
     if (!(update_root->flags & MVM_CF_IN_GEN2_ROOT_LIST))
         MVM_gc_root_gen2_add(tc, update_root);
+    else if (update_root->flags & MVM_CF_DIRTY_CARDS)
+        update_root->flags &= ~MVM_CF_DIRTY_CARDS;
+    marking = tc->instance->gc_marking;
+    if ((marking == MVM_GC_MARKING_STARTING || marking == MVM_GC_MARKING_ACTIVE)
+            && (update_root->flags & MVM_CF_GEN2_LIVE)
+            && !(tc->num_gc_grey && tc->gc_grey[tc->num_gc_grey - 1] == update_root))
+        MVM_gc_incremental_grey(tc, update_root);
+}
+
+/* Called instead of MVM_gc_write_barrier_hit for an object that does card
+ * marking. Dirties the card of the slot being written to; if the object
+ * was not yet an inter-generational root, it becomes one that only needs
+ * its dirty cards scanned. (If something else already made it one, all of
+ * it will be scanned, and the cards worked out afresh.) */
+void MVM_gc_write_barrier_hit_card(MVMThreadContext *tc, MVMCollectable *update_root,
+        MVMuint8 *cards, MVMuint64 slot) {
+    cards[slot >> MVM_GC_CARD_BITS] = 1;
+    if (!(update_root->flags & MVM_CF_IN_GEN2_ROOT_LIST)) {
+        MVM_gc_root_gen2_add(tc, update_root);
+        update_root->flags |= MVM_CF_DIRTY_CARDS;
+    }
+}
+
+/* Called when the write barrier macro detects that an object marked live in
+ * gen2 is about to reference an unmarked gen2 object. If an incremental
+ * marking cycle is in progress, marks and greys the referenced object. (A
+ * full collection also marks objects live, but has its own way to visit
+ * what they reference.) */
+void MVM_gc_write_barrier_hit_marking(MVMThreadContext *tc, MVMCollectable *referenced) {
+    MVMuint32 marking = tc->instance->gc_marking;
+    if ((marking == MVM_GC_MARKING_STARTING || marking == MVM_GC_MARKING_ACTIVE)
+            && MVM_gc_claim_gen2_mark(referenced))
+        MVM_gc_incremental_grey(tc, referenced);
+}
+
+/* Called by JIT-compiled code, which only checks the flags of the objects
+ * involved to see whether the write barrier may be needed, and leaves the
+ * rest to the barrier itself. */
+void MVM_gc_write_barrier_hit_by(MVMThreadContext *tc, MVMCollectable *update_root,
+        MVMCollectable *referenced) {
+    MVM_gc_write_barrier(tc, update_root, referenced);
 }
@@ -1,12 +1,49 @@
+/* Card marking. A big array or hash in gen2 may divide its slots into cards
+ * of 2^MVM_GC_CARD_BITS slots, with a byte for each card that is set when a
+ * reference to a nursery object is written into one of its slots. When it is
+ * an inter-generational root, a nursery collection then only scans the slots
+ * of the dirty cards, rather than the whole thing. Objects with fewer slots
+ * than MVM_GC_CARDS_MIN_SLOTS don't bother. */
+#define MVM_GC_CARD_BITS        7
+#define MVM_GC_CARDS_MIN_SLOTS  1024
+#define MVM_GC_NUM_CARDS(slots) (((slots) + (1 << MVM_GC_CARD_BITS) - 1) >> MVM_GC_CARD_BITS)
+
 /* Functions for if the write barriers are hit. */
 MVM_PUBLIC void MVM_gc_write_barrier_hit(MVMThreadContext *tc, MVMCollectable *update_root);
+MVM_PUBLIC void MVM_gc_write_barrier_hit_card(MVMThreadContext *tc, MVMCollectable *update_root,
+    MVMuint8 *cards, MVMuint64 slot);
+MVM_PUBLIC void MVM_gc_write_barrier_hit_marking(MVMThreadContext *tc, MVMCollectable *referenced);
+MVM_PUBLIC void MVM_gc_write_barrier_hit_by(MVMThreadContext *tc, MVMCollectable *update_root,
+    MVMCollectable *referenced);
 
 /* Ensures that if a generation 2 object comes to hold a reference to a
  * nursery object, then the generation 2 object becomes an inter-generational
- * root. */
+ * root. Also, gen2 objects are only marked live outside of a full collection
+ * during incremental marking; then, a marked object coming to reference an
+ * unmarked one must mark it, since the marked one won't be scanned again. */
 MVM_STATIC_INLINE void MVM_gc_write_barrier(MVMThreadContext *tc, MVMCollectable *update_root, const MVMCollectable *referenced) {
-    if (((update_root->flags & MVM_CF_SECOND_GEN) && referenced && !(referenced->flags & MVM_CF_SECOND_GEN)))
-        MVM_gc_write_barrier_hit(tc, update_root);
+    if ((update_root->flags & MVM_CF_SECOND_GEN) && referenced) {
+        if (!(referenced->flags & MVM_CF_SECOND_GEN))
+            MVM_gc_write_barrier_hit(tc, update_root);
+        else if ((update_root->flags & MVM_CF_GEN2_LIVE) && !(referenced->flags & MVM_CF_GEN2_LIVE))
+            MVM_gc_write_barrier_hit_marking(tc, (MVMCollectable *)referenced);
+    }
+}
+
+/* The write barrier for an object that does card marking, which also takes
+ * its cards (or NULL if it has none) and the slot being written to. */
+MVM_STATIC_INLINE void MVM_gc_write_barrier_card(MVMThreadContext *tc, MVMCollectable *update_root,
+        MVMuint8 *cards, MVMuint64 slot, const MVMCollectable *referenced) {
+    if ((update_root->flags & MVM_CF_SECOND_GEN) && referenced) {
+        if (!(referenced->flags & MVM_CF_SECOND_GEN)) {
+            if (cards)
+                MVM_gc_write_barrier_hit_card(tc, update_root, cards, slot);
+            else
+                MVM_gc_write_barrier_hit(tc, update_root);
+        }
+        else if ((update_root->flags & MVM_CF_GEN2_LIVE) && !(referenced->flags & MVM_CF_GEN2_LIVE))
+            MVM_gc_write_barrier_hit_marking(tc, (MVMCollectable *)referenced);
+    }
 }
 
 /* Does an assignment, but makes sure the write barrier MVM_WB is applied
@@ -31,3 +68,23 @@ MVM_STATIC_INLINE void MVM_gc_write_barrier(MVMThreadContext *tc, MVMCollectable
         update_addr = _r; \
     }
 #endif
+
+/* Like MVM_ASSIGN_REF, but for a slot of an object that does card marking. */
+#if MVM_GC_DEBUG
+#define MVM_ASSIGN_REF_CARD(tc, update_root, cards, slot, update_addr, referenced) \
+    { \
+        void *_r = referenced; \
+        if (_r && ((MVMCollectable *)_r)->owner == 0) \
+            MVM_panic(1, "Invalid assignment (maybe of heap frame to stack frame?)"); \
+        MVM_ASSERT_NOT_FROMSPACE(tc, _r); \
+        MVM_gc_write_barrier_card(tc, update_root, cards, slot, (MVMCollectable *)_r); \
+        update_addr = _r; \
+    }
+#else
+#define MVM_ASSIGN_REF_CARD(tc, update_root, cards, slot, update_addr, referenced) \
+    { \
+        void *_r = referenced; \
+        MVM_gc_write_barrier_card(tc, update_root, cards, slot, (MVMCollectable *)_r); \
+        update_addr = _r; \
+    }
+#endif
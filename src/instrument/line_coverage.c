@@ -172,8 +172,11 @@ void MVM_line_coverage_instrument(MVMThreadContext *tc, MVMStaticFrame *sf) {
 
         /* Throw away any specializations; we'll need to reproduce them as
          * instrumented versions. */
-        sf->body.num_spesh_candidates = 0;
-        sf->body.spesh_candidates     = NULL;
+        sf->body.num_spesh_candidates      = 0;
+        sf->body.spesh_candidates          = NULL;
+        sf->body.spesh_guard_tree          = NULL;
+        sf->body.alloc_spesh_candidates    = 0;
+        sf->body.num_live_spesh_candidates = 0;
     }
 }
 
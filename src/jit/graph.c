@@ -2741,6 +2741,7 @@ static MVMint32 jgb_consume_ins(MVMThreadContext *tc, JitGraphBuilder *jgb,
     case MVM_OP_sp_guardconttype:
     case MVM_OP_sp_guardrwconc:
     case MVM_OP_sp_guardrwtype:
+    case MVM_OP_sp_guardobj:
         jgb_append_guard(tc, jgb, ins);
         break;
     case MVM_OP_prepargs: {
@@ -78,6 +78,7 @@ The following environment variables are respected:\n\
     MVM_SPESH_INLINE_DISABLE    Disables inlining\n\
     MVM_SPESH_OSR_DISABLE       Disables on-stack replacement\n\
     MVM_SPESH_LIMIT             Limit the maximum number of specializations\n\
+    MVM_SPESH_BLOCKING          Specialize on the calling thread, not in the background\n\
     MVM_JIT_DISABLE             Disables JITting to machine code\n\
     MVM_SPESH_LOG               Specifies a dynamic optimizer log file\n\
     MVM_JIT_LOG                 Specifies a JIT-compiler log file\n\
@@ -1,5 +1,6 @@
 #include "moar.h"
 #include <platform/threads.h>
+#include "platform/sys.h"
 
 #if defined(_MSC_VER)
 #define snprintf _snprintf
@@ -63,18 +64,68 @@ static FILE *fopen_perhaps_with_pid(char *path, const char *mode) {
     }
 }
 
+/* Gets a nursery size from an environment variable, or the default if it is
+ * not set or not sensible. */
+static size_t nursery_size_from_env(const char *name, size_t def) {
+    char *value = getenv(name);
+    if (value && strlen(value)) {
+        size_t size = (size_t)strtoull(value, NULL, 10);
+        if (size >= MVM_NURSERY_SIZE_FLOOR)
+            return size;
+    }
+    return def;
+}
+
 /* Create a new instance of the VM. */
 MVMInstance * MVM_vm_create_instance(void) {
     MVMInstance *instance;
     char *spesh_log, *spesh_nodelay, *spesh_disable, *spesh_inline_disable,
-         *spesh_osr_disable, *spesh_limit;
+         *spesh_osr_disable, *spesh_limit, *spesh_blocking;
     char *jit_log, *jit_disable, *jit_bytecode_dir;
     char *dynvar_log;
+    char *gc_pause_log;
+    char *alloc_sample_log;
+    char *cpu_sample_log;
     int init_stat;
 
     /* Set up instance data structure. */
     instance = MVM_calloc(1, sizeof(MVMInstance));
 
+    /* Pick the string hash key before any strings are hashed. If the OS
+     * can't give us random bytes, make do with the time and our address. */
+    if (!MVM_platform_random_bytes(instance->string_hash_key, sizeof(instance->string_hash_key))) {
+        instance->string_hash_key[0] = uv_hrtime() ^ (MVMuint64)(uintptr_t)instance;
+        instance->string_hash_key[1] = MVM_platform_now() ^ ((MVMuint64)(uintptr_t)&instance << 17);
+    }
+
+    /* Decide the nursery sizes, which the main thread context needs. */
+    instance->nursery_size_min     = nursery_size_from_env("MVM_NURSERY_SIZE_MIN", MVM_NURSERY_SIZE_MIN);
+    instance->nursery_size_max     = nursery_size_from_env("MVM_NURSERY_SIZE_MAX", MVM_NURSERY_SIZE_MAX);
+    if (instance->nursery_size_max < instance->nursery_size_min)
+        instance->nursery_size_max = instance->nursery_size_min;
+    instance->nursery_size_initial = nursery_size_from_env("MVM_NURSERY_SIZE", MVM_NURSERY_SIZE);
+    if (instance->nursery_size_initial < instance->nursery_size_min)
+        instance->nursery_size_initial = instance->nursery_size_min;
+    if (instance->nursery_size_initial > instance->nursery_size_max)
+        instance->nursery_size_initial = instance->nursery_size_max;
+
+    /* Decide if allocations should be sampled, before any are made. */
+    alloc_sample_log = getenv("MVM_ALLOC_SAMPLE_LOG");
+    if (alloc_sample_log && strlen(alloc_sample_log)) {
+        char *alloc_sample_bytes = getenv("MVM_ALLOC_SAMPLE_BYTES");
+        instance->alloc_sample_log_fh = fopen_perhaps_with_pid(alloc_sample_log, "w");
+        if (instance->alloc_sample_log_fh) {
+            if (alloc_sample_bytes && strlen(alloc_sample_bytes))
+                instance->alloc_sample_bytes = strtoull(alloc_sample_bytes, NULL, 10);
+            if (!instance->alloc_sample_bytes)
+                instance->alloc_sample_bytes = MVM_ALLOC_SAMPLE_BYTES_DEFAULT;
+            init_mutex(instance->mutex_alloc_samples, "allocation samples");
+        }
+    }
+
+    /* Set up CPU sampling; it's started once the VM is. */
+    init_mutex(instance->mutex_cpu_samples, "CPU samples");
+
     /* Create the main thread's ThreadContext and stash it. */
     instance->main_thread = MVM_tc_create(NULL, instance);
 
@@ -117,8 +168,8 @@ MVMInstance * MVM_vm_create_instance(void) {
     /* Set up container registry mutex. */
     init_mutex(instance->mutex_container_registry, "container registry");
 
-    /* Set up persistent object ID hash mutex. */
-    init_mutex(instance->mutex_object_ids, "object ID hash");
+    /* Set up persistent object ID tables. */
+    MVM_gc_object_id_init(instance);
 
     /* Allocate all things during following setup steps directly in gen2, as
      * they will have program lifetime. */
@@ -126,7 +177,7 @@ MVMInstance * MVM_vm_create_instance(void) {
 
     /* Set up integer constant and string cache. */
     init_mutex(instance->mutex_int_const_cache, "int constant cache");
-    instance->int_const_cache = MVM_calloc(1, sizeof(MVMIntConstCache));
+    MVM_intcache_init(instance);
     instance->int_to_str_cache = MVM_calloc(MVM_INT_TO_STR_CACHE_SIZE, sizeof(MVMString *));
 
     /* Bootstrap 6model. It is assumed the GC will not be called during this. */
@@ -207,6 +258,14 @@ MVMInstance * MVM_vm_create_instance(void) {
         instance->spesh_nodelay = 1;
     }
 
+    /* Should specialization be done on the thread that finished the logging
+     * runs, rather than on the background worker? Makes spesh deterministic,
+     * which is useful for debugging it. */
+    init_mutex(instance->mutex_spesh_worker_start, "spesh worker thread start");
+    spesh_blocking = getenv("MVM_SPESH_BLOCKING");
+    if (spesh_blocking && strlen(spesh_blocking))
+        instance->spesh_blocking = 1;
+
     /* Should we limit the number of specialized frames produced? (This is
      * mostly useful for building spesh bug bisect tools.) */
     spesh_limit = getenv("MVM_SPESH_LIMIT");
@@ -230,6 +289,25 @@ MVMInstance * MVM_vm_create_instance(void) {
     }
     instance->jit_seq_nr = 0;
 
+    /* Should gen2 be marked incrementally, to shorten full collection
+     * pauses? Should types of objects asked for their IDs be pretenured?
+     * And should we report GC pause times at exit? */
+    if (getenv("MVM_GC_INCREMENTAL"))
+        instance->gc_incremental = 1;
+    if (getenv("MVM_OBJECT_ID_PRETENURE"))
+        instance->object_id_pretenure = 1;
+    gc_pause_log = getenv("MVM_GC_PAUSE_LOG");
+    if (gc_pause_log && strlen(gc_pause_log))
+        instance->gc_pause_log_fh = fopen_perhaps_with_pid(gc_pause_log, "w");
+
+    /* Should we sample the CPU from the start? */
+    cpu_sample_log = getenv("MVM_CPU_SAMPLE_LOG");
+    if (cpu_sample_log && strlen(cpu_sample_log)) {
+        instance->cpu_sample_log_fh = fopen_perhaps_with_pid(cpu_sample_log, "w");
+        if (instance->cpu_sample_log_fh)
+            MVM_profile_cpu_start_from_env(instance);
+    }
+
     /* Various kinds of debugging that can be enabled. */
     dynvar_log = getenv("MVM_DYNVAR_LOG");
     if (dynvar_log && strlen(dynvar_log)) {
@@ -367,6 +445,15 @@ void MVM_vm_exit(MVMInstance *instance) {
         fprintf(instance->dynvar_log_fh, "- x 0 0 0 0 %"PRId64" %"PRIu64" %"PRIu64"\n", instance->dynvar_log_lasttime, uv_hrtime(), uv_hrtime());
         fclose(instance->dynvar_log_fh);
     }
+    if (instance->gc_pause_log_fh) {
+        MVM_gc_report_pause_stats(instance, instance->gc_pause_log_fh);
+        fclose(instance->gc_pause_log_fh);
+    }
+    if (instance->alloc_sample_log_fh) {
+        MVM_profile_alloc_sample_write(instance->main_thread, instance->alloc_sample_log_fh);
+        fclose(instance->alloc_sample_log_fh);
+    }
+    MVM_profile_cpu_finish_at_exit(instance->main_thread);
 
     /* And, we're done. */
     exit(0);
@@ -405,6 +492,14 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
     /* Join any foreground threads. */
     MVM_thread_join_foreground(instance->main_thread);
 
+    /* Write out any allocation and CPU samples while the frames and types
+     * they refer to are still around. */
+    if (instance->alloc_sample_log_fh) {
+        MVM_profile_alloc_sample_write(instance->main_thread, instance->alloc_sample_log_fh);
+        fclose(instance->alloc_sample_log_fh);
+    }
+    MVM_profile_cpu_finish_at_exit(instance->main_thread);
+
     /* Run the GC global destruction phase. After this,
      * no 6model object pointers should be accessed. */
     MVM_gc_global_destruction(instance->main_thread);
@@ -419,6 +514,13 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
     MVM_free(instance->permroots);
     MVM_free(instance->permroot_descriptions);
 
+    /* Clean up persistent object ID tables. */
+    MVM_gc_object_id_destroy(instance);
+
+    /* Clean up parallel gen2 sweep partitions and incremental mark stack. */
+    MVM_free(instance->gc_sweep_partitions);
+    MVM_free(instance->gc_mark_stack);
+
     /* Clean up Hash of HLLConfig. */
     uv_mutex_destroy(&instance->mutex_hllconfigs);
     MVM_HASH_DESTROY(hash_handle, MVMHLLConfig, instance->compiler_hll_configs);
@@ -465,14 +567,25 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
     /* Release this interpreter's hold on Unicode database */
     MVM_unicode_release(instance->main_thread);
 
-    /* Clean up spesh install mutex and close any log. */
+    /* Clean up spesh mutexes and close any log. */
     uv_mutex_destroy(&instance->mutex_spesh_install);
+    uv_mutex_destroy(&instance->mutex_spesh_worker_start);
     if (instance->spesh_log_fh)
         fclose(instance->spesh_log_fh);
     if (instance->jit_log_fh)
         fclose(instance->jit_log_fh);
     if (instance->dynvar_log_fh)
         fclose(instance->dynvar_log_fh);
+    if (instance->gc_pause_log_fh) {
+        MVM_gc_report_pause_stats(instance, instance->gc_pause_log_fh);
+        fclose(instance->gc_pause_log_fh);
+    }
+
+    /* Clean up allocation samples. */
+    if (instance->alloc_sample_log_fh) {
+        uv_mutex_destroy(&instance->mutex_alloc_samples);
+        MVM_free(instance->alloc_samples);
+    }
 
     /* Clean up cross-thread-write-logging mutex */
     uv_mutex_destroy(&instance->mutex_cross_thread_write_logging);
@@ -486,7 +599,7 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
 
     /* Clean up integer constant and string cache. */
     uv_mutex_destroy(&instance->mutex_int_const_cache);
-    MVM_free(instance->int_const_cache);
+    MVM_intcache_destroy(instance);
     MVM_free(instance->int_to_str_cache);
 
     /* Clean up event loop starting mutex. */
@@ -495,6 +608,9 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
     /* Destroy main thread contexts. */
     MVM_tc_destroy(instance->main_thread);
 
+    /* Clean up CPU samples, now no thread context is left to sample. */
+    uv_mutex_destroy(&instance->mutex_cpu_samples);
+
     /* Clear up VM instance memory. */
     MVM_free(instance);
 }
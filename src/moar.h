@@ -130,17 +130,21 @@ MVM_PUBLIC const MVMint32 MVM_jit_support(void);
 #include "6model/parametric.h"
 #include "core/compunit.h"
 #include "gc/gen2.h"
+#include "gc/los.h"
 #include "gc/allocation.h"
 #include "gc/worklist.h"
 #include "gc/orchestrate.h"
 #include "gc/roots.h"
 #include "gc/objectid.h"
 #include "gc/finalize.h"
+#include "gc/incremental.h"
+#include "gc/stats.h"
 #include "core/regionalloc.h"
 #include "spesh/dump.h"
 #include "spesh/graph.h"
 #include "spesh/codegen.h"
 #include "spesh/candidate.h"
+#include "spesh/guardtree.h"
 #include "spesh/manipulate.h"
 #include "spesh/args.h"
 #include "spesh/facts.h"
@@ -149,8 +153,11 @@ MVM_PUBLIC const MVMint32 MVM_jit_support(void);
 #include "spesh/log.h"
 #include "spesh/threshold.h"
 #include "spesh/inline.h"
+#include "spesh/escape.h"
 #include "spesh/osr.h"
 #include "spesh/lookup.h"
+#include "spesh/worker.h"
+#include "spesh/stats.h"
 #include "strings/normalize.h"
 #include "strings/decode_stream.h"
 #include "strings/ascii.h"
@@ -190,6 +197,8 @@ MVM_PUBLIC const MVMint32 MVM_jit_support(void);
 #include "profiler/profile.h"
 #include "profiler/heapsnapshot.h"
 #include "profiler/telemeh.h"
+#include "profiler/allocsample.h"
+#include "profiler/cpusample.h"
 #include "instrument/crossthreadwrite.h"
 #include "instrument/line_coverage.h"
 
@@ -5,5 +5,8 @@
 void *MVM_platform_alloc_pages(size_t size, int mode);
 int MVM_platform_set_page_mode(void * block, size_t size, int mode);
 int MVM_platform_free_pages(void *block, size_t size);
+void *MVM_platform_realloc_pages(void *block, size_t old_size, size_t new_size);
+size_t MVM_platform_page_size(void);
+size_t MVM_platform_discard_pages(void *block, size_t size);
 void *MVM_platform_map_file(int fd, void **handle, size_t size, int writable);
 int MVM_platform_unmap_file(void *block, void *handle, size_t size);
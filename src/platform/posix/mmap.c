@@ -1,8 +1,10 @@
+#define _GNU_SOURCE
 #include <stddef.h>
 #include <sys/mman.h>
 #include "moar.h"
 #include "platform/mmap.h"
 #include <errno.h>
+#include <unistd.h>
 
 /* MAP_ANONYMOUS is Linux, MAP_ANON is BSD */
 #ifndef MVM_MAP_ANON
@@ -60,6 +62,47 @@ int MVM_platform_free_pages(void *block, size_t size)
     return munmap(block, size) == 0;
 }
 
+/* Resizes a block of read/write pages, which may move it. Where we can
+ * remap, the contents are not copied. */
+void *MVM_platform_realloc_pages(void *block, size_t old_size, size_t new_size)
+{
+#ifdef MREMAP_MAYMOVE
+    void *new_block = mremap(block, old_size, new_size, MREMAP_MAYMOVE);
+    if (new_block == MAP_FAILED)
+        MVM_panic(1, "MVM_platform_realloc_pages failed: %d", errno);
+    return new_block;
+#else
+    void *new_block = MVM_platform_alloc_pages(new_size, MVM_PAGE_READ | MVM_PAGE_WRITE);
+    memcpy(new_block, block, old_size < new_size ? old_size : new_size);
+    munmap(block, old_size);
+    return new_block;
+#endif
+}
+
+size_t MVM_platform_page_size(void)
+{
+    static size_t page_size = 0;
+    if (!page_size)
+        page_size = (size_t)sysconf(_SC_PAGESIZE);
+    return page_size;
+}
+
+/* Tells the OS we don't need the contents of the whole pages within the
+ * given block of memory any more, so it can take them back; they read as
+ * zeroes when next touched. Returns the number of bytes discarded. */
+size_t MVM_platform_discard_pages(void *block, size_t size)
+{
+    size_t    page_size = MVM_platform_page_size();
+    MVMuint64 start, end;
+    start = ((MVMuint64)(uintptr_t)block + page_size - 1) & ~((MVMuint64)page_size - 1);
+    end   = ((MVMuint64)(uintptr_t)block + size) & ~((MVMuint64)page_size - 1);
+    if (end <= start)
+        return 0;
+    return madvise((void *)(uintptr_t)start, (size_t)(end - start), MADV_DONTNEED) == 0
+        ? (size_t)(end - start)
+        : 0;
+}
+
 void *MVM_platform_map_file(int fd, void **handle, size_t size, int writable)
 {
     void *block = mmap(NULL, size,
@@ -2,6 +2,9 @@
 #include "moar.h"
 #include "platform/sys.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #if __GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 6) || defined(__FreeBSD_kernel__)
 
 #include <unistd.h>
@@ -60,3 +63,21 @@ MVMuint32 MVM_platform_cpu_count(void) {
 }
 
 #endif
+
+MVMint32 MVM_platform_random_bytes(void *buf, size_t size) {
+    char *pos = buf;
+    int   fd  = open("/dev/urandom", O_RDONLY);
+    if (fd < 0)
+        return 0;
+    while (size) {
+        ssize_t got = read(fd, pos, size);
+        if (got <= 0) {
+            close(fd);
+            return 0;
+        }
+        pos  += got;
+        size -= got;
+    }
+    close(fd);
+    return 1;
+}
@@ -2,3 +2,8 @@
  * May return 0 on error.
  */
 MVMuint32 MVM_platform_cpu_count(void);
+
+/* Fills a buffer with random bytes from the operating system, suitable for
+ * seeding things that must not be predictable. Returns 0 on failure.
+ */
+MVMint32 MVM_platform_random_bytes(void *buf, size_t size);
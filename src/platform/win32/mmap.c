@@ -1,5 +1,6 @@
 #include <windows.h>
 #include <io.h>
+#include <string.h>
 #include "platform/mmap.h"
 
 static int page_mode_to_prot_mode(int page_mode) {
@@ -40,6 +41,39 @@ int MVM_platform_free_pages(void *pages, size_t size) {
     return VirtualFree(pages, 0, MEM_RELEASE);
 }
 
+/* Resizes a block of read/write pages, which moves it. */
+void *MVM_platform_realloc_pages(void *block, size_t old_size, size_t new_size) {
+    void *new_block = MVM_platform_alloc_pages(new_size, MVM_PAGE_READ | MVM_PAGE_WRITE);
+    memcpy(new_block, block, old_size < new_size ? old_size : new_size);
+    VirtualFree(block, 0, MEM_RELEASE);
+    return new_block;
+}
+
+size_t MVM_platform_page_size(void) {
+    static size_t page_size = 0;
+    if (!page_size) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        page_size = info.dwPageSize;
+    }
+    return page_size;
+}
+
+/* Tells the OS we don't need the contents of the whole pages within the
+ * given block of memory any more, so it can take them back. Returns the
+ * number of bytes discarded. */
+size_t MVM_platform_discard_pages(void *block, size_t size) {
+    size_t    page_size = MVM_platform_page_size();
+    ULONG_PTR start, end;
+    start = ((ULONG_PTR)block + page_size - 1) & ~((ULONG_PTR)page_size - 1);
+    end   = ((ULONG_PTR)block + size) & ~((ULONG_PTR)page_size - 1);
+    if (end <= start)
+        return 0;
+    return VirtualAlloc((void *)start, end - start, MEM_RESET, PAGE_READWRITE)
+        ? (size_t)(end - start)
+        : 0;
+}
+
 void *MVM_platform_map_file(int fd, void **handle, size_t size, int writable) {
     HANDLE fh, mapping;
     LARGE_INTEGER li;
@@ -4,6 +4,9 @@
 
 #include <windows.h>
 
+/* RtlGenRandom, exported from advapi32 under this name. */
+BOOLEAN NTAPI SystemFunction036(PVOID buffer, ULONG length);
+
 MVMuint32 MVM_platform_cpu_count(void) {
     DWORD_PTR proc_mask, sys_mask;
 
@@ -12,3 +15,7 @@ MVMuint32 MVM_platform_cpu_count(void) {
 
     return MVM_bithacks_count_bits(proc_mask);
 }
+
+MVMint32 MVM_platform_random_bytes(void *buf, size_t size) {
+    return SystemFunction036(buf, (ULONG)size) ? 1 : 0;
+}
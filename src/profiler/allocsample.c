@@ -0,0 +1,178 @@
+#include "moar.h"
+
+/* Picks how many bytes to allocate before the next sample; uniformly
+ * distributed around the configured interval, using a simple xorshift
+ * generator of our own so we don't disturb the program's random numbers. */
+static MVMint64 next_interval(MVMThreadContext *tc) {
+    MVMuint64 x = tc->alloc_sample_rand;
+    MVMuint64 bytes = tc->instance->alloc_sample_bytes;
+    if (!x)
+        x = uv_hrtime() ^ ((MVMuint64)tc->thread_id << 32) ^ 0x9E3779B97F4A7C15ULL;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    tc->alloc_sample_rand = x;
+    return (MVMint64)(bytes / 2 + x % bytes);
+}
+
+/* Completes the pending sample of a thread, now that the header of the
+ * object it sampled has been filled in, and adds it to the samples. */
+static void complete_sample(MVMThreadContext *tc) {
+    MVMInstance    *instance = tc->instance;
+    MVMCollectable *item     = tc->alloc_sample_obj;
+    MVMAllocSample *sample;
+    tc->alloc_sample_obj = NULL;
+    if (!item->size)
+        return;
+    uv_mutex_lock(&instance->mutex_alloc_samples);
+    if (instance->num_alloc_samples == instance->alloc_alloc_samples) {
+        instance->alloc_alloc_samples = instance->alloc_alloc_samples
+            ? instance->alloc_alloc_samples * 2
+            : 256;
+        instance->alloc_samples = MVM_realloc(instance->alloc_samples,
+            instance->alloc_alloc_samples * sizeof(MVMAllocSample));
+    }
+    sample = &(instance->alloc_samples[instance->num_alloc_samples++]);
+    sample->sf = tc->alloc_sample_sf;
+    if (item->flags & MVM_CF_STABLE) {
+        sample->kind = MVM_ALLOC_SAMPLE_STABLE;
+        sample->st   = NULL;
+    }
+    else if (item->flags & MVM_CF_FRAME) {
+        sample->kind = MVM_ALLOC_SAMPLE_FRAME;
+        sample->st   = NULL;
+    }
+    else {
+        sample->kind = MVM_ALLOC_SAMPLE_OBJECT;
+        sample->st   = ((MVMObject *)item)->st;
+    }
+    sample->size = item->size;
+    uv_mutex_unlock(&instance->mutex_alloc_samples);
+}
+
+/* Called by the nursery allocator when the sample countdown runs out, with
+ * the memory it just allocated. This must not allocate, nor be a GC safe
+ * point, since the allocation is not yet an object. */
+void MVM_profile_alloc_sample(MVMThreadContext *tc, void *allocated) {
+    if (!tc->instance->alloc_sample_bytes) {
+        tc->alloc_sample_countdown = MVM_ALLOC_SAMPLE_OFF;
+        return;
+    }
+    if (tc->alloc_sample_obj)
+        complete_sample(tc);
+    tc->alloc_sample_obj = (MVMCollectable *)allocated;
+    tc->alloc_sample_sf  = tc->cur_frame ? tc->cur_frame->static_info : NULL;
+    tc->alloc_sample_countdown += next_interval(tc);
+}
+
+/* Marks the pending sample of a thread. If the object it sampled never got
+ * its header filled in, there is nothing the GC could do with it, so the
+ * sample is dropped. */
+void MVM_profile_alloc_sample_mark_thread(MVMThreadContext *tc, MVMGCWorklist *worklist) {
+    if (tc->alloc_sample_obj) {
+        if (tc->alloc_sample_obj->size)
+            MVM_gc_worklist_add(tc, worklist, &(tc->alloc_sample_obj));
+        else
+            tc->alloc_sample_obj = NULL;
+        MVM_gc_worklist_add(tc, worklist, &(tc->alloc_sample_sf));
+    }
+}
+
+/* Marks the frames and types of the completed samples. The world is
+ * stopped, so we needn't take the lock. */
+void MVM_profile_alloc_sample_mark(MVMThreadContext *tc, MVMGCWorklist *worklist) {
+    MVMInstance *instance = tc->instance;
+    MVMuint32    i;
+    for (i = 0; i < instance->num_alloc_samples; i++) {
+        MVM_gc_worklist_add(tc, worklist, &(instance->alloc_samples[i].sf));
+        MVM_gc_worklist_add(tc, worklist, &(instance->alloc_samples[i].st));
+    }
+}
+
+/* Orders samples by frame, then kind, then type, so those to aggregate are
+ * next to each other. */
+static int compare_samples(const void *a, const void *b) {
+    const MVMAllocSample *sa = (const MVMAllocSample *)a;
+    const MVMAllocSample *sb = (const MVMAllocSample *)b;
+    if (sa->sf != sb->sf)
+        return (uintptr_t)sa->sf < (uintptr_t)sb->sf ? -1 : 1;
+    if (sa->kind != sb->kind)
+        return sa->kind < sb->kind ? -1 : 1;
+    if (sa->st != sb->st)
+        return (uintptr_t)sa->st < (uintptr_t)sb->st ? -1 : 1;
+    return 0;
+}
+
+/* Writes a line for a frame and type that were sampled. */
+static void write_line(MVMThreadContext *tc, FILE *fh, MVMAllocSample *sample,
+                       MVMuint64 count, MVMuint64 sampled_bytes) {
+    const char *type;
+    char       *name = NULL;
+    char       *file = NULL;
+    MVMint32    line = -1;
+
+    switch (sample->kind) {
+        case MVM_ALLOC_SAMPLE_STABLE:
+            type = "<STable>";
+            break;
+        case MVM_ALLOC_SAMPLE_FRAME:
+            type = "<frame>";
+            break;
+        default:
+            type = sample->st && sample->st->debug_name ? sample->st->debug_name : "<anon>";
+            break;
+    }
+
+    if (sample->sf) {
+        MVMStaticFrame        *sf    = sample->sf;
+        MVMBytecodeAnnotation *annot = MVM_bytecode_resolve_annotation(tc, &(sf->body), 0);
+        MVMint32               fshi  = annot ? (MVMint32)annot->filename_string_heap_index : -1;
+        if (sf->body.name)
+            name = MVM_string_utf8_encode_C_string(tc, sf->body.name);
+        if (fshi >= 0 && fshi < sf->body.cu->body.num_strings)
+            file = MVM_string_utf8_encode_C_string(tc, MVM_cu_string(tc, sf->body.cu, fshi));
+        else if (sf->body.cu->body.filename)
+            file = MVM_string_utf8_encode_C_string(tc, sf->body.cu->body.filename);
+        if (annot)
+            line = (MVMint32)annot->line_number;
+        MVM_free(annot);
+    }
+
+    fprintf(fh, "%"PRIu64"\t%"PRIu64"\t%"PRIu64"\t%s\t%s\t%s:%d\n",
+        count, count * tc->instance->alloc_sample_bytes, sampled_bytes, type,
+        name && *name ? name : "<anon>", file ? file : "<unknown>", line);
+    MVM_free(name);
+    MVM_free(file);
+}
+
+/* Writes the samples taken, aggregated by frame and type. Each line has the
+ * number of samples, the estimated bytes allocated, the bytes of the
+ * objects actually sampled, the type, the name of the routine, and where it
+ * is. Done at exit; we allocate in gen2 so that we don't trigger a GC run
+ * while we hold on to the samples. */
+void MVM_profile_alloc_sample_write(MVMThreadContext *tc, FILE *fh) {
+    MVMInstance    *instance = tc->instance;
+    MVMAllocSample *samples;
+    MVMuint32       num_samples, i, start;
+
+    MVM_gc_allocate_gen2_default_set(tc);
+    if (tc->alloc_sample_obj)
+        complete_sample(tc);
+    uv_mutex_lock(&instance->mutex_alloc_samples);
+    num_samples = instance->num_alloc_samples;
+    samples     = MVM_malloc((num_samples ? num_samples : 1) * sizeof(MVMAllocSample));
+    memcpy(samples, instance->alloc_samples, num_samples * sizeof(MVMAllocSample));
+    uv_mutex_unlock(&instance->mutex_alloc_samples);
+
+    qsort(samples, num_samples, sizeof(MVMAllocSample), compare_samples);
+    fprintf(fh, "# samples\testimated bytes\tsampled bytes\ttype\troutine\tfile:line\n");
+    for (start = 0; start < num_samples; start = i) {
+        MVMuint64 sampled_bytes = 0;
+        for (i = start; i < num_samples && !compare_samples(&samples[start], &samples[i]); i++)
+            sampled_bytes += samples[i].size;
+        write_line(tc, fh, &samples[start], i - start, sampled_bytes);
+    }
+
+    MVM_free(samples);
+    MVM_gc_allocate_gen2_default_clear(tc);
+}
@@ -0,0 +1,39 @@
+/* Sampling allocation profiler, enabled by setting MVM_ALLOC_SAMPLE_LOG to a
+ * filename. Rather than logging every allocation, as the instrumenting
+ * profiler does, the nursery allocator counts down the bytes allocated, and
+ * once every MVM_ALLOC_SAMPLE_BYTES (on average; the interval is randomized
+ * so allocation patterns don't line up with it) it samples the allocation
+ * it is making, along with the frame making it. The type of the object is
+ * only known once its header is filled in, so each sample is completed when
+ * the next is taken. At exit, the samples are aggregated by frame and type
+ * and written to the log, one line per pair. */
+
+/* Default average number of bytes allocated between samples. */
+#define MVM_ALLOC_SAMPLE_BYTES_DEFAULT  524288
+
+/* Countdown used when not sampling, so we (almost) never get called. */
+#define MVM_ALLOC_SAMPLE_OFF            ((MVMint64)1 << 62)
+
+/* Kinds of thing sampled that are not objects, and so have no type. */
+#define MVM_ALLOC_SAMPLE_OBJECT         0
+#define MVM_ALLOC_SAMPLE_STABLE         1
+#define MVM_ALLOC_SAMPLE_FRAME          2
+
+/* A completed allocation sample. */
+struct MVMAllocSample {
+    /* The static frame that was running when the allocation was made, if
+     * any. */
+    MVMStaticFrame *sf;
+
+    /* The type of the object allocated, if it was an object. */
+    MVMSTable *st;
+
+    /* The kind of thing allocated, and its size. */
+    MVMuint32 kind;
+    MVMuint32 size;
+};
+
+void MVM_profile_alloc_sample(MVMThreadContext *tc, void *allocated);
+void MVM_profile_alloc_sample_mark_thread(MVMThreadContext *tc, MVMGCWorklist *worklist);
+void MVM_profile_alloc_sample_mark(MVMThreadContext *tc, MVMGCWorklist *worklist);
+void MVM_profile_alloc_sample_write(MVMThreadContext *tc, FILE *fh);
@@ -0,0 +1,310 @@
+#include "moar.h"
+
+/* Whether we're sampling. */
+MVMint32 MVM_profile_cpu_sampling(MVMThreadContext *tc) {
+    return MVM_load(&tc->instance->cpu_sampling) != 0;
+}
+
+/* Adds a thread context to those the timer thread signals. */
+void MVM_profile_cpu_add_thread(MVMThreadContext *tc) {
+    MVMInstance *instance = tc->instance;
+    uv_mutex_lock(&instance->mutex_cpu_samples);
+    tc->cpu_sample_next = instance->cpu_sample_threads;
+    instance->cpu_sample_threads = tc;
+    uv_mutex_unlock(&instance->mutex_cpu_samples);
+}
+
+/* Removes a thread context from those the timer thread signals, before it
+ * is destroyed. */
+void MVM_profile_cpu_remove_thread(MVMThreadContext *tc) {
+    MVMInstance       *instance = tc->instance;
+    MVMThreadContext **link;
+    uv_mutex_lock(&instance->mutex_cpu_samples);
+    for (link = &instance->cpu_sample_threads; *link; link = &((*link)->cpu_sample_next)) {
+        if (*link == tc) {
+            *link = tc->cpu_sample_next;
+            break;
+        }
+    }
+    uv_mutex_unlock(&instance->mutex_cpu_samples);
+}
+
+/* The timer thread, which at each sampling interval signals every thread
+ * that is executing to take a sample, until sampling is turned off. It does
+ * so through the GC status of the thread, which the thread checks at its
+ * GC sync points anyway, so there is nothing to check when not sampling.
+ * Threads that are blocked, or already signalled, are left alone. It never
+ * touches anything managed by the GC, so it need not take part in GC
+ * runs. */
+static void timer(void *arg) {
+    MVMInstance *instance = (MVMInstance *)arg;
+    while (MVM_load(&instance->cpu_sampling)) {
+        MVMThreadContext *other;
+        MVM_platform_nanosleep(instance->cpu_sample_interval);
+        uv_mutex_lock(&instance->mutex_cpu_samples);
+        for (other = instance->cpu_sample_threads; other; other = other->cpu_sample_next)
+            MVM_cas(&other->gc_status, MVMGCStatus_NONE, MVMGCStatus_SAMPLE);
+        uv_mutex_unlock(&instance->mutex_cpu_samples);
+    }
+}
+
+/* Sets up the call tree and starts the timer thread. Returns non-zero on
+ * success. */
+static int start_sampling(MVMInstance *instance, MVMint64 frequency) {
+    int status;
+    if (frequency <= 0 || frequency > 1000000)
+        frequency = MVM_CPU_SAMPLE_FREQUENCY_DEFAULT;
+    instance->cpu_sample_interval = 1000000000 / frequency;
+    instance->cpu_samples         = MVM_calloc(1, sizeof(MVMCpuSampleNode));
+    MVM_store(&instance->cpu_sampling, 1);
+    if ((status = uv_thread_create(&instance->cpu_sample_thread, timer, instance)) != 0) {
+        MVM_store(&instance->cpu_sampling, 0);
+        MVM_free(instance->cpu_samples);
+        instance->cpu_samples = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+/* Starts sampling with the specified configuration, which may have the
+ * number of samples to take per second, and a file to write the collapsed
+ * stacks to when we're done. */
+void MVM_profile_cpu_start(MVMThreadContext *tc, MVMObject *config) {
+    MVMint64   frequency = MVM_CPU_SAMPLE_FREQUENCY_DEFAULT;
+    MVMString *path      = NULL;
+    FILE      *fh        = NULL;
+    MVMROOT(tc, config, {
+        MVMString *key = MVM_string_ascii_decode_nt(tc, tc->instance->VMString, "frequency");
+        if (MVM_repr_exists_key(tc, config, key))
+            frequency = MVM_repr_get_int(tc, MVM_repr_at_key_o(tc, config, key));
+        key = MVM_string_ascii_decode_nt(tc, tc->instance->VMString, "path");
+        if (MVM_repr_exists_key(tc, config, key))
+            path = MVM_repr_get_str(tc, MVM_repr_at_key_o(tc, config, key));
+    });
+    if (path) {
+        char *c_path = MVM_string_utf8_c8_encode_C_string(tc, path);
+        fh = fopen(c_path, "w");
+        if (!fh) {
+            char *waste[] = { c_path, NULL };
+            MVM_exception_throw_adhoc_free(tc, waste,
+                "Could not open CPU sample file '%s'", c_path);
+        }
+        MVM_free(c_path);
+    }
+    tc->instance->cpu_sample_log_fh = fh;
+    if (!start_sampling(tc->instance, frequency)) {
+        if (fh)
+            fclose(fh);
+        tc->instance->cpu_sample_log_fh = NULL;
+        MVM_exception_throw_adhoc(tc, "Could not start CPU sampling timer thread");
+    }
+}
+
+/* Starts sampling when the VM starts, as configured by environment
+ * variables; the log file has already been opened. */
+void MVM_profile_cpu_start_from_env(MVMInstance *instance) {
+    char *frequency = getenv("MVM_CPU_SAMPLE_FREQUENCY");
+    if (!start_sampling(instance, frequency && strlen(frequency)
+            ? (MVMint64)strtoll(frequency, NULL, 10)
+            : MVM_CPU_SAMPLE_FREQUENCY_DEFAULT)) {
+        fprintf(stderr, "MoarVM: Could not start CPU sampling timer thread\n");
+        fclose(instance->cpu_sample_log_fh);
+        instance->cpu_sample_log_fh = NULL;
+    }
+}
+
+/* Finds the callee node for a static frame, adding it if needed. */
+static MVMCpuSampleNode * get_succ(MVMCpuSampleNode *node, MVMStaticFrame *sf) {
+    MVMCpuSampleNode *succ;
+    MVMuint32 i;
+    for (i = 0; i < node->num_succ; i++)
+        if (node->succ[i]->sf == sf)
+            return node->succ[i];
+    if (node->num_succ == node->alloc_succ) {
+        node->alloc_succ = node->alloc_succ ? node->alloc_succ * 2 : 4;
+        node->succ = MVM_realloc(node->succ, node->alloc_succ * sizeof(MVMCpuSampleNode *));
+    }
+    succ = MVM_calloc(1, sizeof(MVMCpuSampleNode));
+    succ->sf = sf;
+    node->succ[node->num_succ++] = succ;
+    return succ;
+}
+
+/* Called at a GC sync point when the timer thread signalled for a sample,
+ * with the JIT label of the sync point if it was in JIT compiled code.
+ * Walks the call stack of the current thread, innermost frame first, and
+ * adds it to the call tree. Where a specialized frame has inlines, the position in it
+ * tells which of them are active: for the innermost frame, that is where
+ * we are in the interpreter or, if it's JIT compiled, the JIT label given;
+ * for its callers, where they will return to. The inlines table lists the
+ * innermost inline first. */
+void MVM_profile_cpu_sample(MVMThreadContext *tc, void *jit_label) {
+    MVMInstance      *instance = tc->instance;
+    MVMStaticFrame   *frames[MVM_CPU_SAMPLE_MAX_DEPTH];
+    MVMuint32         depth    = 0;
+    MVMFrame         *f        = tc->cur_frame;
+    MVMCpuSampleNode *node;
+
+    if (!MVM_load(&instance->cpu_sampling))
+        return;
+
+    while (f && depth < MVM_CPU_SAMPLE_MAX_DEPTH) {
+        MVMSpeshCandidate *cand = f->spesh_cand;
+        MVMuint32          i;
+        if (cand && cand->num_inlines) {
+            if (cand->jitcode && f->effective_bytecode == cand->jitcode->bytecode) {
+                void         **labels = cand->jitcode->labels;
+                MVMJitInline  *inls   = cand->jitcode->inlines;
+                void          *label  = f == tc->cur_frame ? jit_label : f->jit_entry_label;
+                if (label)
+                    for (i = 0; i < cand->jitcode->num_inlines && depth < MVM_CPU_SAMPLE_MAX_DEPTH; i++)
+                        if (label >= labels[inls[i].start_label] && label <= labels[inls[i].end_label])
+                            frames[depth++] = cand->inlines[i].code->body.sf;
+            }
+            else {
+                MVMuint8 *pos    = f == tc->cur_frame && tc->interp_cur_op
+                    ? *(tc->interp_cur_op)
+                    : f->return_address;
+                MVMint32  offset = pos - f->effective_bytecode;
+                for (i = 0; i < cand->num_inlines && depth < MVM_CPU_SAMPLE_MAX_DEPTH; i++)
+                    if (offset >= cand->inlines[i].start && offset < cand->inlines[i].end)
+                        frames[depth++] = cand->inlines[i].code->body.sf;
+            }
+        }
+        if (depth < MVM_CPU_SAMPLE_MAX_DEPTH)
+            frames[depth++] = f->static_info;
+        f = f->caller;
+    }
+    if (!depth)
+        return;
+
+    uv_mutex_lock(&instance->mutex_cpu_samples);
+    if ((node = instance->cpu_samples)) {
+        while (depth > 0)
+            node = get_succ(node, frames[--depth]);
+        node->samples++;
+    }
+    uv_mutex_unlock(&instance->mutex_cpu_samples);
+}
+
+/* Marks the static frames in the call tree. The world is stopped, so we
+ * needn't take the lock. */
+static void mark_node(MVMThreadContext *tc, MVMGCWorklist *worklist, MVMCpuSampleNode *node) {
+    MVMuint32 i;
+    MVM_gc_worklist_add(tc, worklist, &(node->sf));
+    for (i = 0; i < node->num_succ; i++)
+        mark_node(tc, worklist, node->succ[i]);
+}
+void MVM_profile_cpu_mark(MVMThreadContext *tc, MVMGCWorklist *worklist) {
+    if (tc->instance->cpu_samples)
+        mark_node(tc, worklist, tc->instance->cpu_samples);
+}
+
+/* The collapsed stack being built up while walking the call tree. */
+typedef struct {
+    char   *buf;
+    size_t  len;
+    size_t  alloc;
+} StackLine;
+
+/* Appends the name of a frame, and where it is, to the collapsed stack.
+ * Semicolons separate the frames, so any in the names are replaced. */
+static void append_frame(MVMThreadContext *tc, StackLine *line, MVMStaticFrame *sf) {
+    MVMBytecodeAnnotation *annot = MVM_bytecode_resolve_annotation(tc, &(sf->body), 0);
+    MVMint32               fshi  = annot ? (MVMint32)annot->filename_string_heap_index : -1;
+    char                  *name  = sf->body.name
+        ? MVM_string_utf8_encode_C_string(tc, sf->body.name)
+        : NULL;
+    char                  *file  = NULL;
+    size_t                 start = line->len;
+    size_t                 needed, i;
+    if (fshi >= 0 && fshi < sf->body.cu->body.num_strings)
+        file = MVM_string_utf8_encode_C_string(tc, MVM_cu_string(tc, sf->body.cu, fshi));
+    else if (sf->body.cu->body.filename)
+        file = MVM_string_utf8_encode_C_string(tc, sf->body.cu->body.filename);
+
+    needed = line->len + (name ? strlen(name) : 0) + (file ? strlen(file) : 0) + 32;
+    if (needed > line->alloc) {
+        line->alloc = needed * 2;
+        line->buf   = MVM_realloc(line->buf, line->alloc);
+    }
+    line->len += sprintf(line->buf + line->len, "%s%s %s:%d", start ? ";" : "",
+        name && *name ? name : "<anon>", file ? file : "<unknown>",
+        annot ? (MVMint32)annot->line_number : -1);
+    for (i = start + (start ? 1 : 0); i < line->len; i++)
+        if (line->buf[i] == ';')
+            line->buf[i] = ',';
+
+    MVM_free(annot);
+    MVM_free(name);
+    MVM_free(file);
+}
+
+/* Walks the call tree, adding the collapsed stack of each node that has
+ * samples to the result hash and writing it to the file, if any. Frees the
+ * nodes as it goes. */
+static void collapse_node(MVMThreadContext *tc, MVMCpuSampleNode *node, StackLine *line,
+                          MVMObject *result, FILE *fh) {
+    MVMuint32 i;
+    size_t    len = line->len;
+    if (node->sf) {
+        append_frame(tc, line, node->sf);
+        if (node->samples) {
+            MVM_repr_bind_key_o(tc, result,
+                MVM_string_utf8_decode(tc, tc->instance->VMString, line->buf, line->len),
+                MVM_repr_box_int(tc, MVM_hll_current(tc)->int_box_type, node->samples));
+            if (fh)
+                fprintf(fh, "%.*s %"PRIu64"\n", (int)line->len, line->buf, node->samples);
+        }
+    }
+    for (i = 0; i < node->num_succ; i++)
+        collapse_node(tc, node->succ[i], line, result, fh);
+    line->len = len;
+    MVM_free(node->succ);
+    MVM_free(node);
+}
+
+/* Stops sampling and returns a hash of the collapsed stacks sampled to the
+ * number of samples each got, writing them to the file, if one was given. */
+MVMObject * MVM_profile_cpu_end(MVMThreadContext *tc) {
+    MVMInstance      *instance = tc->instance;
+    MVMCpuSampleNode *root;
+    MVMObject        *result;
+    StackLine         line;
+
+    /* Stop the timer thread, marking ourselves blocked while we wait for
+     * it, since it may be sleeping. */
+    MVM_store(&instance->cpu_sampling, 0);
+    MVM_gc_mark_thread_blocked(tc);
+    uv_thread_join(&instance->cpu_sample_thread);
+    MVM_gc_mark_thread_unblocked(tc);
+
+    /* Take the call tree; any thread still sampling won't add to it. */
+    uv_mutex_lock(&instance->mutex_cpu_samples);
+    root = instance->cpu_samples;
+    instance->cpu_samples = NULL;
+    uv_mutex_unlock(&instance->mutex_cpu_samples);
+
+    /* Allocate the result in gen2, so the frames in the call tree can't
+     * move while we walk it. */
+    MVM_gc_allocate_gen2_default_set(tc);
+    result     = MVM_repr_alloc_init(tc, MVM_hll_current(tc)->slurpy_hash_type);
+    line.buf   = MVM_malloc(256);
+    line.len   = 0;
+    line.alloc = 256;
+    collapse_node(tc, root, &line, result, instance->cpu_sample_log_fh);
+    MVM_free(line.buf);
+    MVM_gc_allocate_gen2_default_clear(tc);
+
+    if (instance->cpu_sample_log_fh) {
+        fclose(instance->cpu_sample_log_fh);
+        instance->cpu_sample_log_fh = NULL;
+    }
+    return result;
+}
+
+/* Writes out the samples at exit, if sampling is still on. */
+void MVM_profile_cpu_finish_at_exit(MVMThreadContext *tc) {
+    if (MVM_profile_cpu_sampling(tc))
+        MVM_profile_cpu_end(tc);
+}
@@ -0,0 +1,46 @@
+/* Sampling CPU profiler. Unlike the instrumented profiler, it leaves the
+ * code alone, so specialization and JIT compilation happen as usual. A
+ * timer thread signals each executing thread at the sampling frequency, by
+ * setting its GC status as a GC run would; the thread notices at its next
+ * GC sync point (a branch or allocation, in the interpreter or in JIT
+ * compiled code) and samples its own call stack there, including the
+ * frames inlined into specialized ones. Threads that are blocked don't get
+ * to a sync point, so only threads using the CPU are sampled. The samples
+ * are kept as a call tree of static frames, and turned into collapsed
+ * stacks (one line per distinct stack, with the number of samples it got)
+ * as taken by flame graph tools.
+ *
+ * Sampling is started and ended at runtime by the startprofile and
+ * endprofile ops, with the kind "cpu", or from startup by setting the
+ * environment variable MVM_CPU_SAMPLE_LOG to a filename. */
+
+/* Default sampling frequency, in samples per second. A prime number, so
+ * the samples don't line up with things that happen periodically. */
+#define MVM_CPU_SAMPLE_FREQUENCY_DEFAULT    97
+
+/* The deepest stack we sample; beyond this, outer frames are left out. */
+#define MVM_CPU_SAMPLE_MAX_DEPTH            512
+
+/* A node in the call tree of samples. */
+struct MVMCpuSampleNode {
+    /* The static frame; NULL for the root. */
+    MVMStaticFrame *sf;
+
+    /* The number of samples with this frame innermost. */
+    MVMuint64 samples;
+
+    /* The callees. */
+    MVMCpuSampleNode **succ;
+    MVMuint32          num_succ;
+    MVMuint32          alloc_succ;
+};
+
+MVMint32 MVM_profile_cpu_sampling(MVMThreadContext *tc);
+void MVM_profile_cpu_start(MVMThreadContext *tc, MVMObject *config);
+MVMObject * MVM_profile_cpu_end(MVMThreadContext *tc);
+void MVM_profile_cpu_add_thread(MVMThreadContext *tc);
+void MVM_profile_cpu_remove_thread(MVMThreadContext *tc);
+void MVM_profile_cpu_sample(MVMThreadContext *tc, void *jit_label);
+void MVM_profile_cpu_mark(MVMThreadContext *tc, MVMGCWorklist *worklist);
+void MVM_profile_cpu_start_from_env(MVMInstance *instance);
+void MVM_profile_cpu_finish_at_exit(MVMThreadContext *tc);
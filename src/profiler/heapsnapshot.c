@@ -5,9 +5,34 @@ MVMint32 MVM_profile_heap_profiling(MVMThreadContext *tc) {
     return tc->instance->heap_snapshots != NULL;
 }
 
-/* Start heap profiling. */
+/* Start heap profiling. If the configuration has a path, each snapshot is
+ * written to that file as soon as it has been taken, rather than all being
+ * kept in memory until the end. */
 void MVM_profile_heap_start(MVMThreadContext *tc, MVMObject *config) {
-    tc->instance->heap_snapshots = MVM_calloc(1, sizeof(MVMHeapSnapshotCollection));
+    MVMHeapSnapshotCollection *col;
+    MVMString *path = NULL;
+    FILE      *fh   = NULL;
+    char      *c_path;
+    MVMROOT(tc, config, {
+        MVMString *key = MVM_string_ascii_decode_nt(tc, tc->instance->VMString, "path");
+        if (MVM_repr_exists_key(tc, config, key))
+            path = MVM_repr_get_str(tc, MVM_repr_at_key_o(tc, config, key));
+    });
+    if (path) {
+        c_path = MVM_string_utf8_c8_encode_C_string(tc, path);
+        fh = fopen(c_path, "wb");
+        if (!fh) {
+            char *waste[] = { c_path, NULL };
+            MVM_exception_throw_adhoc_free(tc, waste,
+                "Could not open heap snapshot file '%s'", c_path);
+        }
+        fwrite(MVM_HEAP_SNAPSHOT_MAGIC, 1, strlen(MVM_HEAP_SNAPSHOT_MAGIC), fh);
+        fputc(MVM_HEAP_SNAPSHOT_VERSION, fh);
+    }
+    col = MVM_calloc(1, sizeof(MVMHeapSnapshotCollection));
+    col->fh   = fh;
+    col->path = fh ? c_path : NULL;
+    tc->instance->heap_snapshots = col;
 }
 
 /* Grows storage if it's full, zeroing the extension. Assumes it's only being
@@ -599,14 +624,103 @@ static void record_snapshot(MVMThreadContext *tc, MVMHeapSnapshotCollection *col
     MVM_gc_worklist_destroy(tc, ss.gcwl);
 }
 
+/* Writes an unsigned integer as a LEB128 varint. */
+static void write_varint(FILE *fh, MVMuint64 value) {
+    MVMuint8 buffer[10];
+    size_t   length = 0;
+    do {
+        MVMuint8 byte = value & 0x7F;
+        value >>= 7;
+        buffer[length++] = value ? byte | 0x80 : byte;
+    } while (value);
+    fwrite(buffer, 1, length, fh);
+}
+
+/* Writes the strings, types and static frames added since we last wrote
+ * them, so that later snapshots refer to those already written. */
+static void write_new_tables(MVMHeapSnapshotCollection *col) {
+    FILE     *fh = col->fh;
+    MVMuint64 i;
+    if (col->num_strings > col->num_strings_written) {
+        fputc('s', fh);
+        write_varint(fh, col->num_strings - col->num_strings_written);
+        for (i = col->num_strings_written; i < col->num_strings; i++) {
+            size_t length = strlen(col->strings[i]);
+            write_varint(fh, length);
+            fwrite(col->strings[i], 1, length, fh);
+        }
+        col->num_strings_written = col->num_strings;
+    }
+    if (col->num_types > col->num_types_written) {
+        fputc('t', fh);
+        write_varint(fh, col->num_types - col->num_types_written);
+        for (i = col->num_types_written; i < col->num_types; i++) {
+            write_varint(fh, col->types[i].repr_name);
+            write_varint(fh, col->types[i].type_name);
+        }
+        col->num_types_written = col->num_types;
+    }
+    if (col->num_static_frames > col->num_static_frames_written) {
+        fputc('f', fh);
+        write_varint(fh, col->num_static_frames - col->num_static_frames_written);
+        for (i = col->num_static_frames_written; i < col->num_static_frames; i++) {
+            write_varint(fh, col->static_frames[i].name);
+            write_varint(fh, col->static_frames[i].cuid);
+            write_varint(fh, col->static_frames[i].line);
+            write_varint(fh, col->static_frames[i].file);
+        }
+        col->num_static_frames_written = col->num_static_frames;
+    }
+}
+
+/* Writes a snapshot to the snapshot file. References are written in the
+ * order of the collectables they are from, which need not be the order they
+ * were recorded in, and refer to their target relative to their source, as
+ * the two tend to be close. */
+static void write_snapshot(MVMHeapSnapshotCollection *col, MVMHeapSnapshot *hs) {
+    FILE     *fh = col->fh;
+    MVMuint64 i, j;
+    write_new_tables(col);
+    fputc('S', fh);
+    write_varint(fh, hs->num_collectables);
+    for (i = 0; i < hs->num_collectables; i++) {
+        MVMHeapSnapshotCollectable *c = &(hs->collectables[i]);
+        write_varint(fh, c->kind);
+        write_varint(fh, c->type_or_frame_index);
+        write_varint(fh, c->collectable_size);
+        write_varint(fh, c->unmanaged_size);
+        write_varint(fh, c->num_refs);
+    }
+    write_varint(fh, hs->num_references);
+    for (i = 0; i < hs->num_collectables; i++) {
+        MVMHeapSnapshotCollectable *c = &(hs->collectables[i]);
+        for (j = c->refs_start; j < c->refs_start + c->num_refs; j++) {
+            MVMint64 delta = (MVMint64)hs->references[j].collectable_index - (MVMint64)i;
+            write_varint(fh, hs->references[j].description);
+            write_varint(fh, ((MVMuint64)delta << 1) ^ (MVMuint64)(delta >> 63));
+        }
+    }
+    fflush(fh);
+}
+
 /* Takes a snapshot of the heap, adding it to the current heap snapshot
- * collection. */
+ * collection, or writing it out if we're streaming to a file. */
 void MVM_profile_heap_take_snapshot(MVMThreadContext *tc) {
     if (MVM_profile_heap_profiling(tc)) {
         MVMHeapSnapshotCollection *col = tc->instance->heap_snapshots;
-        grow_storage(&(col->snapshots), &(col->num_snapshots), &(col->alloc_snapshots),
-            sizeof(MVMHeapSnapshot));
-        record_snapshot(tc, col, &(col->snapshots[col->num_snapshots]));
+        if (col->fh) {
+            MVMHeapSnapshot hs;
+            memset(&hs, 0, sizeof(MVMHeapSnapshot));
+            record_snapshot(tc, col, &hs);
+            write_snapshot(col, &hs);
+            MVM_free(hs.collectables);
+            MVM_free(hs.references);
+        }
+        else {
+            grow_storage(&(col->snapshots), &(col->num_snapshots), &(col->alloc_snapshots),
+                sizeof(MVMHeapSnapshot));
+            record_snapshot(tc, col, &(col->snapshots[col->num_snapshots]));
+        }
         col->num_snapshots++;
     }
 }
@@ -632,6 +746,10 @@ static void destroy_heap_snapshot_collection(MVMThreadContext *tc) {
     MVM_free(col->types);
     MVM_free(col->static_frames);
 
+    if (col->fh)
+        fclose(col->fh);
+    MVM_free(col->path);
+
     MVM_free(col);
     tc->instance->heap_snapshots = NULL;
 }
@@ -829,13 +947,29 @@ MVMObject * collection_to_mvm_objects(MVMThreadContext *tc, MVMHeapSnapshotColle
 
 /* Finishes heap profiling, getting the data. */
 MVMObject * MVM_profile_heap_end(MVMThreadContext *tc) {
+    MVMHeapSnapshotCollection *col;
     MVMObject *dataset;
 
     /* Trigger a GC run, to ensure we get at least one heap snapshot. */
     MVM_gc_enter_from_allocator(tc);
 
-    /* Process and return the data. */
-    dataset = collection_to_mvm_objects(tc, tc->instance->heap_snapshots);
+    /* If we streamed the snapshots, finish off the file, and just say where
+     * it is; otherwise, process and return the data. */
+    col = tc->instance->heap_snapshots;
+    if (col->fh) {
+        write_new_tables(col);
+        fputc('E', col->fh);
+        MVM_gc_allocate_gen2_default_set(tc);
+        dataset = MVM_repr_alloc_init(tc, MVM_hll_current(tc)->slurpy_hash_type);
+        MVM_repr_bind_key_o(tc, dataset, vmstr(tc, "path"),
+            box_s(tc, vmstr(tc, col->path)));
+        MVM_repr_bind_key_o(tc, dataset, vmstr(tc, "num_snapshots"),
+            MVM_repr_box_int(tc, MVM_hll_current(tc)->int_box_type, col->num_snapshots));
+        MVM_gc_allocate_gen2_default_clear(tc);
+    }
+    else {
+        dataset = collection_to_mvm_objects(tc, col);
+    }
     destroy_heap_snapshot_collection(tc);
     return dataset;
 }
@@ -27,8 +27,37 @@ struct MVMHeapSnapshotCollection {
     char *strings_free;
     MVMuint64 num_strings_free;
     MVMuint64 alloc_strings_free;
+
+    /* If we're streaming snapshots to a file, the file and its name, and
+     * how many of the strings, types and static frames have been written to
+     * it so far. */
+    FILE *fh;
+    char *path;
+    MVMuint64 num_strings_written;
+    MVMuint64 num_types_written;
+    MVMuint64 num_static_frames_written;
 };
 
+/* Streamed heap snapshot file format. All integers are unsigned LEB128
+ * varints. The file starts with the magic bytes and a format version, and
+ * is followed by records, each starting with a tag byte:
+ *   's'  new strings: count, then for each its length in bytes and UTF-8
+ *   't'  new types: count, then for each repr_name, type_name
+ *   'f'  new static frames: count, then for each name, cuid, line, file
+ *   'S'  a snapshot: the number of collectables, then for each kind,
+ *        type_or_frame_index, collectable_size, unmanaged_size, num_refs;
+ *        then the number of references, then for each description and the
+ *        zigzag-encoded difference between the index of the collectable
+ *        referenced and that of the referencing one
+ *   'E'  end of file, written when profiling ends
+ * Strings, types and static frames are numbered from zero in the order
+ * written, across the whole file, and only those new since the previous
+ * snapshot are written before it. References are in the order of their
+ * collectables, so the refs_start of each is the sum of the num_refs of
+ * those before it. */
+#define MVM_HEAP_SNAPSHOT_MAGIC     "MOARHEAP"
+#define MVM_HEAP_SNAPSHOT_VERSION   1
+
 /* An individual heap snapshot. */
 struct MVMHeapSnapshot {
     /* Array of data about collectables on the heap. */
@@ -243,8 +243,11 @@ void MVM_profile_instrument(MVMThreadContext *tc, MVMStaticFrame *sf) {
 
         /* Throw away any specializations; we'll need to reproduce them as
          * instrumented versions. */
-        sf->body.num_spesh_candidates = 0;
-        sf->body.spesh_candidates     = NULL;
+        sf->body.num_spesh_candidates      = 0;
+        sf->body.spesh_candidates          = NULL;
+        sf->body.spesh_guard_tree          = NULL;
+        sf->body.alloc_spesh_candidates    = 0;
+        sf->body.num_live_spesh_candidates = 0;
     }
 }
 
@@ -257,8 +260,11 @@ void MVM_profile_ensure_uninstrumented(MVMThreadContext *tc, MVMStaticFrame *sf)
         sf->body.bytecode_size = sf->body.instrumentation->uninstrumented_bytecode_size;
 
         /* Throw away specializations, which may also be instrumented. */
-        sf->body.num_spesh_candidates = 0;
-        sf->body.spesh_candidates     = NULL;
+        sf->body.num_spesh_candidates      = 0;
+        sf->body.spesh_candidates          = NULL;
+        sf->body.spesh_guard_tree          = NULL;
+        sf->body.alloc_spesh_candidates    = 0;
+        sf->body.num_live_spesh_candidates = 0;
 
         /* XXX For now, due to bugs, disable spesh here. */
         tc->instance->spesh_enabled = 0;
@@ -382,7 +382,9 @@ void MVM_spesh_args(MVMThreadContext *tc, MVMSpeshGraph *g, MVMCallsite *cs, MVM
             case MVM_OP_param_op_o:
                 if (arg_flag == MVM_CALLSITE_ARG_OBJ) {
                     pos_ins[i]->info = MVM_op_get_op(MVM_OP_sp_getarg_o);
-                    if (args[i].o)
+                    /* Don't guard on positions seen with many types, so one
+                     * candidate can serve all of them. */
+                    if (args[i].o && !MVM_spesh_stats_is_megamorphic(tc, g->sf, cs, i))
                         add_guards_and_facts(tc, g, i, args[i].o, pos_ins[i]);
                 }
                 else if (arg_flag == MVM_CALLSITE_ARG_INT) {
@@ -19,6 +19,52 @@ static void calculate_work_env_sizes(MVMThreadContext *tc, MVMStaticFrame *sf,
     c->env_size = c->num_lexicals * sizeof(MVMRegister);
 }
 
+/* Checks if a candidate's callsite and argument guards match a call. */
+MVMint32 MVM_spesh_candidate_guards_pass(MVMThreadContext *tc, MVMSpeshCandidate *cand,
+        MVMCallsite *callsite, MVMRegister *args) {
+    MVMuint32 i;
+    if (cand->cs != callsite)
+        return 0;
+    for (i = 0; i < cand->num_guards; i++) {
+        MVMSpeshGuard *guard = &cand->guards[i];
+        if (!MVM_spesh_guard_tree_test(tc, guard->kind, (MVMSTable *)guard->match,
+                args[guard->slot].o))
+            return 0;
+    }
+    return 1;
+}
+
+/* Checks if the static frame is allowed another specialization. */
+MVMint32 MVM_spesh_candidate_has_room(MVMThreadContext *tc, MVMStaticFrame *static_frame) {
+    MVMuint32 limit = static_frame->body.spesh_cand_limit
+        ? static_frame->body.spesh_cand_limit
+        : MVM_SPESH_LIMIT;
+    return static_frame->body.num_spesh_candidates < MVM_SPESH_MAX_SLOTS &&
+        static_frame->body.num_live_spesh_candidates < limit;
+}
+
+/* Grows the specializations array of a static frame. Other threads may be
+ * reading the current array without holding a lock, so it is only freed at
+ * the next safepoint. Called with the spesh install lock held. */
+static void grow_candidates(MVMThreadContext *tc, MVMStaticFrame *static_frame) {
+    MVMuint32           old_alloc = static_frame->body.alloc_spesh_candidates;
+    MVMuint32           new_alloc = old_alloc ? old_alloc * 2 : MVM_SPESH_LIMIT;
+    MVMSpeshCandidate **old_cands = static_frame->body.spesh_candidates;
+    MVMSpeshCandidate **new_cands;
+    if (new_alloc > MVM_SPESH_MAX_SLOTS)
+        new_alloc = MVM_SPESH_MAX_SLOTS;
+    new_cands = MVM_fixed_size_alloc(tc, tc->instance->fsa,
+        new_alloc * sizeof(MVMSpeshCandidate *));
+    if (old_alloc)
+        memcpy(new_cands, old_cands, old_alloc * sizeof(MVMSpeshCandidate *));
+    MVM_barrier();
+    static_frame->body.spesh_candidates       = new_cands;
+    static_frame->body.alloc_spesh_candidates = new_alloc;
+    if (old_cands)
+        MVM_fixed_size_free_at_safepoint(tc, tc->instance->fsa,
+            old_alloc * sizeof(MVMSpeshCandidate *), old_cands);
+}
+
 /* Tries to set up a specialization of the bytecode for a given arg tuple.
  * Doesn't do the actual optimizations, just works out the guards and does
  * any simple argument transformations, and then inserts logging to record
@@ -78,23 +124,22 @@ MVMSpeshCandidate * MVM_spesh_candidate_setup(MVMThreadContext *tc,
     result    = NULL;
     used      = 0;
     uv_mutex_lock(&tc->instance->mutex_spesh_install);
-    if (static_frame->body.num_spesh_candidates < MVM_SPESH_LIMIT) {
+    if (MVM_spesh_candidate_has_room(tc, static_frame)) {
         MVMint32 num_spesh = static_frame->body.num_spesh_candidates;
         MVMint32 i;
         for (i = 0; i < num_spesh; i++) {
-            MVMSpeshCandidate *compare = &static_frame->body.spesh_candidates[i];
-            if (compare->cs == callsite && compare->num_guards == num_guards &&
+            MVMSpeshCandidate *compare = static_frame->body.spesh_candidates[i];
+            if (!compare->discarded && compare->cs == callsite && compare->num_guards == num_guards &&
                 memcmp(compare->guards, guards, num_guards * sizeof(MVMSpeshGuard)) == 0) {
                 /* Beaten! */
-                result = osr ? NULL : &static_frame->body.spesh_candidates[i];
+                result = osr ? NULL : compare;
                 break;
             }
         }
         if (!result) {
-            if (!static_frame->body.spesh_candidates)
-                static_frame->body.spesh_candidates = MVM_calloc(
-                    MVM_SPESH_LIMIT, sizeof(MVMSpeshCandidate));
-            result                      = &static_frame->body.spesh_candidates[num_spesh];
+            if (num_spesh == static_frame->body.alloc_spesh_candidates)
+                grow_candidates(tc, static_frame);
+            result                      = MVM_calloc(1, sizeof(MVMSpeshCandidate));
             result->cs                  = callsite;
             result->num_guards          = num_guards;
             result->guards              = guards;
@@ -115,11 +160,19 @@ MVMSpeshCandidate * MVM_spesh_candidate_setup(MVMThreadContext *tc,
             result->sg                  = sg;
             result->log_enter_idx       = 0;
             result->log_exits_remaining = MVM_SPESH_LOG_RUNS;
+            result->logging_done        = 0;
+            if (num_spesh < static_frame->body.spesh_cand_high_water)
+                result->check_guards = 1;
+            else
+                static_frame->body.spesh_cand_high_water = num_spesh + 1;
             calculate_work_env_sizes(tc, static_frame, result);
             if (osr)
                 result->osr_logging = 1;
+            static_frame->body.spesh_candidates[num_spesh] = result;
             MVM_barrier();
             static_frame->body.num_spesh_candidates++;
+            static_frame->body.num_live_spesh_candidates++;
+            MVM_spesh_guard_tree_rebuild(tc, &(static_frame->body), 0);
             if (static_frame->common.header.flags & MVM_CF_SECOND_GEN)
                 MVM_gc_write_barrier_hit(tc, (MVMCollectable *)static_frame);
             if (tc->instance->spesh_log_fh) {
@@ -157,10 +210,23 @@ MVMSpeshCandidate * MVM_spesh_candidate_setup(MVMThreadContext *tc,
     return result;
 }
 
+/* Picks the specialization of a static frame whose callsite and argument
+ * guards match the incoming arguments, using the frame's guard tree.
+ * Returns NULL if there is no such candidate. The candidate may still be in
+ * its logging phase, or waiting to be specialized, which callers check by
+ * looking at sg. */
+MVMSpeshCandidate * MVM_spesh_candidate_find(MVMThreadContext *tc, MVMStaticFrame *static_frame,
+        MVMCallsite *callsite, MVMRegister *args) {
+    MVMSpeshGuardTree *tree = static_frame->body.spesh_guard_tree;
+    MVMint32 idx = tree ? MVM_spesh_guard_tree_run(tc, tree, callsite, args) : -1;
+    return idx >= 0 ? static_frame->body.spesh_candidates[idx] : NULL;
+}
+
 /* Called at the point we have the finished logging for a specialization and
  * so are ready to do the specialization work for it. We can be sure this
  * will only be called once, and when nothing is running the logging version
- * of the code. */
+ * of the code. Unless MVM_SPESH_BLOCKING is set, this runs on the spesh
+ * worker thread rather than on an interpreter thread. */
 void MVM_spesh_candidate_specialize(MVMThreadContext *tc, MVMStaticFrame *static_frame,
         MVMSpeshCandidate *candidate) {
     MVMSpeshCode  *sc;
@@ -174,6 +240,10 @@ void MVM_spesh_candidate_specialize(MVMThreadContext *tc, MVMStaticFrame *static
     tc->in_spesh = 1;
 #endif
 
+    /* Add what the logging runs saw to the statistics, so facts discovery
+     * can consider it along with what earlier candidates saw. */
+    MVM_spesh_stats_add_log(tc, static_frame, candidate);
+
     /* Obtain the graph, add facts, and do optimization work. */
     sg = candidate->sg;
     MVM_spesh_facts_discover(tc, sg);
@@ -184,11 +254,13 @@ void MVM_spesh_candidate_specialize(MVMThreadContext *tc, MVMStaticFrame *static
         char *c_name = MVM_string_utf8_encode_C_string(tc, static_frame->body.name);
         char *c_cuid = MVM_string_utf8_encode_C_string(tc, static_frame->body.cuuid);
         char *dump   = MVM_spesh_dump(tc, sg);
+        uv_mutex_lock(&tc->instance->mutex_spesh_install);
         fprintf(tc->instance->spesh_log_fh,
             "Finished specialization of '%s' (cuid: %s)\n\n", c_name, c_cuid);
         fprintf(tc->instance->spesh_log_fh,
             "%s\n\n========\n\n", dump);
         fflush(tc->instance->spesh_log_fh);
+        uv_mutex_unlock(&tc->instance->mutex_spesh_install);
         MVM_free(dump);
         MVM_free(c_name);
         MVM_free(c_cuid);
@@ -209,6 +281,10 @@ void MVM_spesh_candidate_specialize(MVMThreadContext *tc, MVMStaticFrame *static
     candidate->num_lexicals  = sg->num_lexicals;
     candidate->num_inlines   = sg->num_inlines;
     candidate->inlines       = sg->inlines;
+    candidate->num_materializations   = sg->num_materializations;
+    candidate->materializations       = sg->materializations;
+    candidate->num_materialized_attrs = sg->num_materialized_attrs;
+    candidate->materialized_attrs     = sg->materialized_attrs;
     candidate->local_types   = sg->local_types;
     candidate->lexical_types = sg->lexical_types;
     calculate_work_env_sizes(tc, static_frame, candidate);
@@ -257,6 +333,110 @@ void MVM_spesh_candidate_specialize(MVMThreadContext *tc, MVMStaticFrame *static
 }
 
 
+/* Frees discarded candidates that the GC saw no frame referring to in a
+ * full marking cycle that started after they were discarded. Since no new
+ * frames run a discarded candidate, nothing can refer to them again. The
+ * remaining candidates are moved down to close the gaps, which lets the
+ * frame have new candidates in their place. sp_fastinvoke instructions
+ * refer to candidates by index, so those that move have to have their
+ * guards checked when invoked that way. */
+static void free_discarded(MVMThreadContext *tc, MVMStaticFrameBody *body) {
+    MVMuint32 cycles = tc->instance->gc_full_cycles;
+    MVMuint32 kept   = 0;
+    MVMuint32 i;
+    for (i = 0; i < body->num_spesh_candidates; i++) {
+        MVMSpeshCandidate *cand = body->spesh_candidates[i];
+        if (cand->discarded && cand->seen_cycle == cand->discard_cycle
+                && cycles - cand->discard_cycle >= 2) {
+            MVM_spesh_candidate_destroy(tc, cand);
+            MVM_free(cand);
+        }
+        else {
+            if (kept != i) {
+                body->spesh_candidates[kept] = cand;
+                cand->check_guards = 1;
+            }
+            kept++;
+        }
+    }
+    if (kept == body->num_spesh_candidates)
+        return;
+    if (tc->instance->spesh_log_fh)
+        fprintf(tc->instance->spesh_log_fh,
+            "Freed %u discarded specializations of static frame body %p\n\n",
+            body->num_spesh_candidates - kept, (void *)body);
+    body->num_spesh_candidates = kept;
+    MVM_spesh_guard_tree_rebuild(tc, body, 1);
+}
+
+/* Ages the specializations of a static frame. This is called by the GC, with
+ * all threads stopped, each time it marks the static frame. If calls have
+ * mostly been failing to find a matching specialization since the last time,
+ * and there is no room for more, then room is made: first by raising the
+ * limit on the number of candidates, and once that has reached its maximum
+ * by evicting the coldest candidate. Candidates evicted earlier are freed
+ * once nothing refers to them. Objects may be mid-move, so we don't look at
+ * anything but the candidates and counters here. */
+void MVM_spesh_candidate_age(MVMThreadContext *tc, MVMStaticFrameBody *body) {
+    MVMuint32           limit = body->spesh_cand_limit ? body->spesh_cand_limit : MVM_SPESH_LIMIT;
+    MVMuint32           i;
+
+    if (!body->num_spesh_candidates)
+        return;
+
+    if (body->spesh_recent_misses > body->spesh_recent_hits &&
+            body->num_live_spesh_candidates >= limit) {
+        if (limit < MVM_SPESH_MAX_CANDIDATES) {
+            limit *= 2;
+            if (limit > MVM_SPESH_MAX_CANDIDATES)
+                limit = MVM_SPESH_MAX_CANDIDATES;
+            body->spesh_cand_limit = limit;
+            if (tc->instance->spesh_log_fh)
+                fprintf(tc->instance->spesh_log_fh,
+                    "Raised specialization limit of static frame body %p to %u "
+                    "(hits: %u, misses: %u)\n\n",
+                    (void *)body, limit, body->spesh_hits, body->spesh_misses);
+        }
+        else {
+            /* Only consider candidates that are installed and have been
+             * around for a full aging period. Evict the coldest one, if it
+             * is getting fewer calls than are missing out. */
+            MVMSpeshCandidate *coldest = NULL;
+            for (i = 0; i < body->num_spesh_candidates; i++) {
+                MVMSpeshCandidate *cand = body->spesh_candidates[i];
+                if (cand->discarded || cand->sg || cand->age == 0)
+                    continue;
+                if (!coldest || cand->recent_hits < coldest->recent_hits)
+                    coldest = cand;
+            }
+            if (coldest && coldest->recent_hits < body->spesh_recent_misses) {
+                coldest->discarded     = 1;
+                coldest->discard_cycle = tc->instance->gc_full_cycles;
+                coldest->seen_cycle    = tc->instance->gc_full_cycles;
+                body->num_live_spesh_candidates--;
+                MVM_spesh_guard_tree_rebuild(tc, body, 1);
+                if (tc->instance->spesh_log_fh)
+                    fprintf(tc->instance->spesh_log_fh,
+                        "Evicted a specialization of static frame body %p with %u recent hits "
+                        "(hits: %u, misses: %u)\n\n",
+                        (void *)body, coldest->recent_hits,
+                        body->spesh_hits, body->spesh_misses);
+            }
+        }
+    }
+
+    free_discarded(tc, body);
+
+    for (i = 0; i < body->num_spesh_candidates; i++) {
+        MVMSpeshCandidate *cand = body->spesh_candidates[i];
+        if (!cand->sg)
+            cand->age++;
+        cand->recent_hits = 0;
+    }
+    body->spesh_recent_hits   = 0;
+    body->spesh_recent_misses = 0;
+}
+
 void MVM_spesh_candidate_destroy(MVMThreadContext *tc, MVMSpeshCandidate *candidate) {
     if (candidate->sg)
         MVM_spesh_graph_destroy(tc, candidate->sg);
@@ -267,6 +447,8 @@ void MVM_spesh_candidate_destroy(MVMThreadContext *tc, MVMSpeshCandidate *candid
     MVM_free(candidate->deopts);
     MVM_free(candidate->log_slots);
     MVM_free(candidate->inlines);
+    MVM_free(candidate->materializations);
+    MVM_free(candidate->materialized_attrs);
     MVM_free(candidate->local_types);
     MVM_free(candidate->lexical_types);
     if (candidate->jitcode)
@@ -42,6 +42,10 @@ struct MVMSpeshCandidate {
      * the specialization. */
     AO_t log_exits_remaining;
 
+    /* Set to 1 once all logging runs are over and the candidate is ready to
+     * be specialized, and to 2 once the specializer has claimed it. */
+    AO_t logging_done;
+
     /* The spesh graph, if we're still in the process of producing a
      * specialization for this candidate. NULL afterwards. */
     MVMSpeshGraph *sg;
@@ -58,6 +62,12 @@ struct MVMSpeshCandidate {
     MVMint32 num_inlines;
     MVMSpeshInline *inlines;
 
+    /* Objects to materialize on deopt, and their attributes; see escape.h. */
+    MVMuint32 num_materializations;
+    MVMSpeshMaterialization *materializations;
+    MVMuint32 num_materialized_attrs;
+    MVMSpeshMaterializedAttr *materialized_attrs;
+
     /* The list of local types (only set up if we do inlines). */
     MVMuint16 *local_types;
 
@@ -84,10 +94,39 @@ struct MVMSpeshCandidate {
 
     /* JIT-code structure */
     MVMJitCode *jitcode;
+
+    /* Rough count of calls that ran this specialization since the static
+     * frame's candidates were last aged by the GC. */
+    MVMuint32 recent_hits;
+
+    /* Number of times the candidate has been aged since it was installed. */
+    MVMuint32 age;
+
+    /* Set once the candidate has been evicted. It is never picked by a
+     * guard lookup again and no new frames run it, but it stays in place
+     * until the GC knows no frame refers to it any more. */
+    MVMuint32 discarded;
+
+    /* The number of full GC marking cycles that had completed when the
+     * candidate was discarded, and when the GC last saw a frame that refers
+     * to it. */
+    MVMuint32 discard_cycle;
+    MVMuint32 seen_cycle;
+
+    /* Set if the candidate's index may once have been that of another
+     * candidate, in which case sp_fastinvoke instructions naming the index
+     * have to check its guards before running it. */
+    MVMuint32 check_guards;
 };
 
-/* The number of specializations we'll allow per static frame. */
-#define MVM_SPESH_LIMIT 4
+/* The number of specializations a static frame starts out being allowed.
+ * Frames that keep failing to find a matching candidate have their limit
+ * raised, up to MVM_SPESH_MAX_CANDIDATES; after that, cold candidates are
+ * evicted to make room. Evicted candidates use up a slot until they are
+ * freed, so the total number of slots is capped too. */
+#define MVM_SPESH_LIMIT          4
+#define MVM_SPESH_MAX_CANDIDATES 16
+#define MVM_SPESH_MAX_SLOTS      64
 
 /* A specialization guard. */
 struct MVMSpeshGuard {
@@ -113,6 +152,12 @@ struct MVMSpeshGuard {
 MVMSpeshCandidate * MVM_spesh_candidate_setup(MVMThreadContext *tc,
     MVMStaticFrame *static_frame, MVMCallsite *callsite, MVMRegister *args,
     MVMint32 osr);
+MVMSpeshCandidate * MVM_spesh_candidate_find(MVMThreadContext *tc, MVMStaticFrame *static_frame,
+    MVMCallsite *callsite, MVMRegister *args);
 void MVM_spesh_candidate_specialize(MVMThreadContext *tc, MVMStaticFrame *static_frame,
         MVMSpeshCandidate *candidate);
+MVMint32 MVM_spesh_candidate_guards_pass(MVMThreadContext *tc, MVMSpeshCandidate *cand,
+    MVMCallsite *callsite, MVMRegister *args);
+MVMint32 MVM_spesh_candidate_has_room(MVMThreadContext *tc, MVMStaticFrame *static_frame);
+void MVM_spesh_candidate_age(MVMThreadContext *tc, MVMStaticFrameBody *body);
 void MVM_spesh_candidate_destroy(MVMThreadContext *tc, MVMSpeshCandidate *candidate);
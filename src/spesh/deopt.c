@@ -13,6 +13,55 @@ MVM_STATIC_INLINE void clear_dynlex_cache(MVMThreadContext *tc, MVMFrame *f) {
     f->dynlex_cache_reg = NULL;
 }
 
+/* Allocates any objects that escape analysis did away with but that the
+ * code we're deoptimizing into may use, filling in their attributes from the
+ * registers that stood in for them. Since an object register the original
+ * code never bound holds NULL, we put back NULL for VMNull. Allocating may
+ * move the frame to the heap, so the frame to carry on with is returned. */
+static MVMFrame * materialize_objects(MVMThreadContext *tc, MVMFrame *f, MVMSpeshCandidate *cand,
+                                      MVMint32 deopt_offset, MVMint32 deopt_target) {
+    MVMuint32 i;
+    for (i = 0; i < cand->num_materializations; i++) {
+        MVMSpeshMaterialization *m = &(cand->materializations[i]);
+        if (cand->deopts[2 * m->deopt_idx] == deopt_target &&
+                cand->deopts[2 * m->deopt_idx + 1] == deopt_offset) {
+            MVMSTable *st = (MVMSTable *)cand->spesh_slots[m->st_slot];
+            MVMObject *obj;
+            char      *data;
+            MVMuint32  j;
+            f = MVM_frame_force_to_heap(tc, f);
+            MVMROOT(tc, f, {
+                obj = MVM_gc_allocate_fastcreate(tc, st, st->size);
+            });
+            data = (char *)OBJECT_BODY(obj);
+            for (j = m->first_attr; j < m->first_attr + m->num_attrs; j++) {
+                MVMSpeshMaterializedAttr *ma = &(cand->materialized_attrs[j]);
+                switch (ma->kind) {
+                case MVM_reg_obj: {
+                    MVMObject *value = f->work[ma->reg].o;
+                    if (value == tc->instance->VMNull)
+                        value = NULL;
+                    MVM_ASSIGN_REF(tc, &(obj->header), *((MVMObject **)(data + ma->offset)), value);
+                    break;
+                }
+                case MVM_reg_int64:
+                    *((MVMint64 *)(data + ma->offset)) = f->work[ma->reg].i64;
+                    break;
+                default:
+                    *((MVMnum64 *)(data + ma->offset)) = f->work[ma->reg].n64;
+                    break;
+                }
+            }
+            f->work[m->target_reg].o = obj;
+#if MVM_LOG_DEOPTS
+            fprintf(stderr, "Materialized object of type %s in register %d\n",
+                st->debug_name, m->target_reg);
+#endif
+        }
+    }
+    return f;
+}
+
 /* If we have to deopt inside of a frame containing inlines, and we're in
  * an inlined frame at the point we hit deopt, we need to undo the inlining
  * by switching all levels of inlined frame out for a bunch of frames that
@@ -162,8 +211,14 @@ static MVMint32 find_deopt_target(MVMThreadContext *tc, MVMFrame *f, MVMint32 de
 }
 
 static void deopt_frame(MVMThreadContext *tc, MVMFrame *f, MVMint32 deopt_offset, MVMint32 deopt_target) {
+    MVMSpeshInline *inlines;
+
+    /* Put back any objects the specialized code did without. */
+    if (f->spesh_cand->num_materializations)
+        f = materialize_objects(tc, f, f->spesh_cand, deopt_offset, deopt_target);
+
     /* Found it; are we in an inline? */
-    MVMSpeshInline *inlines = f->spesh_cand->inlines;
+    inlines = f->spesh_cand->inlines;
     if (inlines) {
         /* Yes, going to have to re-create the frames; uninline
          * moves the interpreter, so we can just tweak the last
@@ -268,6 +323,14 @@ void MVM_spesh_deopt_all(MVMThreadContext *tc) {
                         MVMint32 deopt_offset = f->spesh_cand->deopts[2 * deopt_idx + 1];
                         MVMint32 deopt_target = f->spesh_cand->deopts[2 * deopt_idx];
 
+                        /* Put back any objects the specialized code did
+                         * without. */
+                        if (f->spesh_cand->num_materializations) {
+                            MVMROOT(tc, l, {
+                                f = materialize_objects(tc, f, f->spesh_cand, deopt_offset, deopt_target);
+                            });
+                        }
+
 #if MVM_LOG_DEOPTS
                         fprintf(stderr, "Found deopt label for JIT (%d) (label %d idx %d)\n", i,
                                 deopts[i].label, deopts[i].idx);
@@ -310,6 +373,15 @@ void MVM_spesh_deopt_all(MVMThreadContext *tc) {
                 MVMint32 i;
                 for (i = 0; i < f->spesh_cand->num_deopts * 2; i += 2) {
                     if (f->spesh_cand->deopts[i + 1] == ret_offset) {
+                        /* Put back any objects the specialized code did
+                         * without. */
+                        if (f->spesh_cand->num_materializations) {
+                            MVMROOT(tc, l, {
+                                f = materialize_objects(tc, f, f->spesh_cand, ret_offset,
+                                    f->spesh_cand->deopts[i]);
+                            });
+                        }
+
                         /* Switch frame itself back to the original code. */
                         f->effective_bytecode    = f->static_info->body.bytecode;
                         f->effective_handlers    = f->static_info->body.handlers;
@@ -0,0 +1,335 @@
+#include "moar.h"
+
+/* Escape analysis and scalar replacement. Objects allocated by sp_fastcreate
+ * that are only ever used by having their attributes got and bound, including
+ * in code inlined into the frame, never escape it; such an object need not be
+ * allocated at all, and its attributes can live in registers instead. The
+ * code we might deoptimize into does still expect the object, though, so at
+ * each deopt point where it may be needed we record how to materialize it. */
+
+/* A use of an object we consider replacing. */
+typedef struct {
+    MVMSpeshIns *ins;
+    MVMuint16    offset;
+    MVMuint16    kind;
+    MVMuint16    is_bind;
+} ObjectUse;
+
+/* An attribute of an object we are replacing, and the register standing in
+ * for it. */
+typedef struct {
+    MVMuint16       offset;
+    MVMuint16       kind;
+    MVMSpeshOperand reg;
+} ReplacedAttr;
+
+/* State of the analysis of one allocation. */
+typedef struct {
+    ObjectUse    *uses;
+    MVMuint32     num_uses;
+    MVMuint32     alloc_uses;
+    ReplacedAttr *attrs;
+    MVMuint32     num_attrs;
+    MVMuint32    *deopt_idxs;
+    MVMuint32     num_deopt_idxs;
+    MVMuint32     alloc_deopt_idxs;
+} EscapeState;
+
+/* If the instruction is a use of the object that doesn't let it escape,
+ * works out the attribute and kind it involves and returns non-zero. The
+ * object must be the one operated on, not the value bound. */
+static MVMint32 classify_use(MVMThreadContext *tc, MVMSpeshIns *ins, MVMint32 operand,
+                             ObjectUse *use) {
+    use->ins = ins;
+    switch (ins->info->opcode) {
+    case MVM_OP_sp_p6oget_o:
+    case MVM_OP_sp_p6oget_i:
+    case MVM_OP_sp_p6oget_n:
+        if (operand != 1)
+            return 0;
+        use->offset  = ins->operands[2].lit_i16;
+        use->is_bind = 0;
+        break;
+    case MVM_OP_sp_p6obind_o:
+    case MVM_OP_sp_p6obind_i:
+    case MVM_OP_sp_p6obind_n:
+        if (operand != 0)
+            return 0;
+        use->offset  = ins->operands[1].lit_i16;
+        use->is_bind = 1;
+        break;
+    default:
+        return 0;
+    }
+    switch (ins->info->opcode) {
+    case MVM_OP_sp_p6oget_o:
+    case MVM_OP_sp_p6obind_o:
+        use->kind = MVM_reg_obj;
+        break;
+    case MVM_OP_sp_p6oget_i:
+    case MVM_OP_sp_p6obind_i:
+        use->kind = MVM_reg_int64;
+        break;
+    default:
+        use->kind = MVM_reg_num64;
+        break;
+    }
+    return 1;
+}
+
+/* Checks if the register is one that something besides an instruction may
+ * write or read, such as exception handlers or the return from an inline. */
+static MVMint32 is_special_reg(MVMThreadContext *tc, MVMSpeshGraph *g, MVMuint16 reg) {
+    MVMuint32 i;
+    for (i = 0; i < g->num_handlers; i++)
+        if (g->handlers[i].block_reg == reg || g->handlers[i].label_reg == reg)
+            return 1;
+    for (i = 0; i < (MVMuint32)g->num_inlines; i++)
+        if (g->inlines[i].res_type != MVM_RETURN_VOID && g->inlines[i].res_reg == reg)
+            return 1;
+    return 0;
+}
+
+/* Finds all the uses of the object written by the allocation. Fails if any
+ * of them lets it escape, or if anything else writes or reads its register,
+ * since then we can't be sure what the register holds at a deopt point. */
+static MVMint32 find_uses(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshIns *alloc,
+                          EscapeState *es) {
+    MVMSpeshOperand target = alloc->operands[0];
+    MVMSpeshBB *bb = g->entry;
+    while (bb) {
+        MVMSpeshIns *ins = bb->first_ins;
+        while (ins) {
+            MVMint32 is_phi = ins->info->opcode == MVM_SSA_PHI;
+            MVMint32 i;
+            for (i = 0; i < ins->info->num_operands; i++) {
+                MVMuint8 rw = is_phi
+                    ? (i == 0 ? MVM_operand_write_reg : MVM_operand_read_reg)
+                    : ins->info->operands[i] & MVM_operand_rw_mask;
+                if (rw != MVM_operand_read_reg && rw != MVM_operand_write_reg)
+                    continue;
+                if (ins->operands[i].reg.orig != target.reg.orig)
+                    continue;
+                if (rw == MVM_operand_write_reg) {
+                    if (ins != alloc)
+                        return 0;
+                }
+                else {
+                    ObjectUse use;
+                    if (is_phi || ins->operands[i].reg.i != target.reg.i)
+                        return 0;
+                    if (!classify_use(tc, ins, i, &use))
+                        return 0;
+                    if (es->num_uses == es->alloc_uses) {
+                        es->alloc_uses = es->alloc_uses ? es->alloc_uses * 2 : 8;
+                        es->uses = MVM_realloc(es->uses, es->alloc_uses * sizeof(ObjectUse));
+                    }
+                    es->uses[es->num_uses++] = use;
+                }
+            }
+            ins = ins->next;
+        }
+        bb = bb->linear_next;
+    }
+    return 1;
+}
+
+/* Adds a deopt index to those the object must be materialized at. */
+static void add_deopt_idx(MVMThreadContext *tc, EscapeState *es, MVMuint32 idx) {
+    MVMuint32 i;
+    for (i = 0; i < es->num_deopt_idxs; i++)
+        if (es->deopt_idxs[i] == idx)
+            return;
+    if (es->num_deopt_idxs == es->alloc_deopt_idxs) {
+        es->alloc_deopt_idxs = es->alloc_deopt_idxs ? es->alloc_deopt_idxs * 2 : 8;
+        es->deopt_idxs = MVM_realloc(es->deopt_idxs, es->alloc_deopt_idxs * sizeof(MVMuint32));
+    }
+    es->deopt_idxs[es->num_deopt_idxs++] = idx;
+}
+
+/* Collects the deopt points in the part of the graph dominated by the
+ * allocation, at which the object will need materializing. Fails if there
+ * is an OSR entry point there, since entering at it would skip setting up
+ * the registers standing in for the attributes. */
+static MVMint32 find_deopt_points(MVMThreadContext *tc, MVMSpeshBB *bb, MVMSpeshIns *ins,
+                                  EscapeState *es) {
+    MVMuint16 i;
+    while (ins) {
+        MVMSpeshAnn *ann = ins->annotations;
+        while (ann) {
+            switch (ann->type) {
+            case MVM_SPESH_ANN_DEOPT_ONE_INS:
+            case MVM_SPESH_ANN_DEOPT_ALL_INS:
+            case MVM_SPESH_ANN_DEOPT_INLINE:
+                add_deopt_idx(tc, es, ann->data.deopt_idx);
+                break;
+            case MVM_SPESH_ANN_DEOPT_OSR:
+                return 0;
+            }
+            ann = ann->next;
+        }
+        ins = ins->next;
+    }
+    for (i = 0; i < bb->num_children; i++)
+        if (!find_deopt_points(tc, bb->children[i], bb->children[i]->first_ins, es))
+            return 0;
+    return 1;
+}
+
+/* Adds a new instruction setting up the initial value of an attribute, as
+ * the zeroed memory of a new object would have it. */
+static void insert_init(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb,
+                        MVMSpeshIns *alloc, ReplacedAttr *attr) {
+    MVMSpeshIns *init = MVM_spesh_alloc(tc, g, sizeof(MVMSpeshIns));
+    init->operands    = MVM_spesh_alloc(tc, g, 2 * sizeof(MVMSpeshOperand));
+    init->operands[0] = attr->reg;
+    switch (attr->kind) {
+    case MVM_reg_obj:
+        init->info = MVM_op_get_op(MVM_OP_null);
+        break;
+    case MVM_reg_int64:
+        init->info = MVM_op_get_op(MVM_OP_const_i64_16);
+        init->operands[1].lit_i16 = 0;
+        break;
+    default:
+        init->info = MVM_op_get_op(MVM_OP_const_n64);
+        init->operands[1].lit_n64 = 0.0;
+        break;
+    }
+    MVM_spesh_manipulate_insert_ins(tc, bb, alloc, init);
+}
+
+/* Records that the object must be materialized at each of the deopt points
+ * we found. */
+static void add_materializations(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshIns *alloc,
+                                 EscapeState *es) {
+    MVMuint32 first_attr = g->num_materialized_attrs;
+    MVMuint32 i;
+    if (!es->num_deopt_idxs)
+        return;
+
+    if (g->num_materialized_attrs + es->num_attrs > g->alloc_materialized_attrs) {
+        g->alloc_materialized_attrs = g->num_materialized_attrs + es->num_attrs + 8;
+        g->materialized_attrs = MVM_realloc(g->materialized_attrs,
+            g->alloc_materialized_attrs * sizeof(MVMSpeshMaterializedAttr));
+    }
+    for (i = 0; i < es->num_attrs; i++) {
+        MVMSpeshMaterializedAttr *ma = &(g->materialized_attrs[g->num_materialized_attrs++]);
+        ma->offset = es->attrs[i].offset;
+        ma->reg    = es->attrs[i].reg.reg.orig;
+        ma->kind   = es->attrs[i].kind;
+    }
+
+    if (g->num_materializations + es->num_deopt_idxs > g->alloc_materializations) {
+        g->alloc_materializations = g->num_materializations + es->num_deopt_idxs + 8;
+        g->materializations = MVM_realloc(g->materializations,
+            g->alloc_materializations * sizeof(MVMSpeshMaterialization));
+    }
+    for (i = 0; i < es->num_deopt_idxs; i++) {
+        MVMSpeshMaterialization *m = &(g->materializations[g->num_materializations++]);
+        m->deopt_idx  = es->deopt_idxs[i];
+        m->target_reg = alloc->operands[0].reg.orig;
+        m->st_slot    = alloc->operands[2].lit_i16;
+        m->first_attr = first_attr;
+        m->num_attrs  = es->num_attrs;
+    }
+}
+
+/* Replaces the object's attributes with registers, turning each get and bind
+ * into a set, then throws out the allocation. */
+static void replace(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb,
+                    MVMSpeshIns *alloc, EscapeState *es) {
+    MVMSpeshFacts *obj_facts = MVM_spesh_get_facts(tc, g, alloc->operands[0]);
+    MVMuint32 i, j;
+
+    es->attrs = MVM_malloc(es->num_uses * sizeof(ReplacedAttr));
+    for (i = 0; i < es->num_uses; i++) {
+        ObjectUse    *use  = &(es->uses[i]);
+        MVMSpeshIns  *ins  = use->ins;
+        ReplacedAttr *attr = NULL;
+        for (j = 0; j < es->num_attrs; j++)
+            if (es->attrs[j].offset == use->offset)
+                attr = &(es->attrs[j]);
+        if (!attr) {
+            /* The register stays in use from here on, as the deopt points
+             * need its value; the extra usage keeps the set that writes it
+             * from being merged away. */
+            attr         = &(es->attrs[es->num_attrs++]);
+            attr->offset = use->offset;
+            attr->kind   = use->kind;
+            attr->reg    = MVM_spesh_manipulate_get_temp_reg(tc, g, use->kind);
+            MVM_spesh_get_facts(tc, g, attr->reg)->usages++;
+            insert_init(tc, g, bb, alloc, attr);
+        }
+
+        if (use->is_bind) {
+            ins->operands[0] = attr->reg;
+            ins->operands[1] = ins->operands[2];
+        }
+        else {
+            ins->operands[1] = attr->reg;
+            MVM_spesh_get_facts(tc, g, attr->reg)->usages++;
+        }
+        ins->info = MVM_op_get_op(MVM_OP_set);
+        obj_facts->usages--;
+    }
+
+    add_materializations(tc, g, alloc, es);
+    MVM_spesh_manipulate_delete_ins(tc, g, bb, alloc);
+}
+
+/* Considers an allocation for replacement. */
+static void try_replace(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb,
+                        MVMSpeshIns *alloc) {
+    MVMSTable           *st = (MVMSTable *)g->spesh_slots[alloc->operands[2].lit_i16];
+    MVMP6opaqueREPRData *repr_data;
+    EscapeState          es;
+    MVMuint32            i, j;
+
+    /* We only know how to replace P6opaque objects, and only those with no
+     * attributes to vivify, since the registers can't tell us if they were
+     * ever bound. */
+    if (st->REPR->ID != MVM_REPR_ID_P6opaque)
+        return;
+    repr_data = (MVMP6opaqueREPRData *)st->REPR_data;
+    if (!repr_data || repr_data->auto_viv_values)
+        return;
+    if (is_special_reg(tc, g, alloc->operands[0].reg.orig))
+        return;
+
+    memset(&es, 0, sizeof(EscapeState));
+    if (!find_uses(tc, g, alloc, &es) || !es.num_uses)
+        goto cleanup;
+
+    /* All uses of an attribute must agree on its kind. */
+    for (i = 0; i < es.num_uses; i++)
+        for (j = i + 1; j < es.num_uses; j++)
+            if (es.uses[i].offset == es.uses[j].offset && es.uses[i].kind != es.uses[j].kind)
+                goto cleanup;
+
+    if (!find_deopt_points(tc, bb, alloc->next, &es))
+        goto cleanup;
+
+    replace(tc, g, bb, alloc, &es);
+
+  cleanup:
+    MVM_free(es.uses);
+    MVM_free(es.attrs);
+    MVM_free(es.deopt_idxs);
+}
+
+/* Looks through the graph for allocations that don't escape, and replaces
+ * them. */
+void MVM_spesh_escape(MVMThreadContext *tc, MVMSpeshGraph *g) {
+    MVMSpeshBB *bb = g->entry;
+    while (bb) {
+        MVMSpeshIns *ins = bb->first_ins;
+        while (ins) {
+            MVMSpeshIns *next = ins->next;
+            if (ins->info->opcode == MVM_OP_sp_fastcreate)
+                try_replace(tc, g, bb, ins);
+            ins = next;
+        }
+        bb = bb->linear_next;
+    }
+}
@@ -0,0 +1,29 @@
+/* An object that escape analysis did away with, which must be allocated if
+ * we deoptimize at a certain point, since the original code may use it. Its
+ * attributes were kept in registers by the specialized code. */
+struct MVMSpeshMaterialization {
+    /* The deopt index at which the object must be materialized. */
+    MVMuint32 deopt_idx;
+
+    /* The register the object goes into. */
+    MVMuint16 target_reg;
+
+    /* The spesh slot holding the object's STable. */
+    MVMuint16 st_slot;
+
+    /* The attributes, as a range of the materialized attributes table. */
+    MVMuint32 first_attr;
+    MVMuint32 num_attrs;
+};
+
+/* An attribute of an object that escape analysis did away with. */
+struct MVMSpeshMaterializedAttr {
+    /* Offset of the attribute in the object body. */
+    MVMuint16 offset;
+
+    /* The register that holds its value, and the kind of that register. */
+    MVMuint16 reg;
+    MVMuint16 kind;
+};
+
+void MVM_spesh_escape(MVMThreadContext *tc, MVMSpeshGraph *g);
@@ -264,19 +264,95 @@ static void allocate_log_guard_table(MVMThreadContext *tc, MVMSpeshGraph *g) {
 
 /* Check for stability of what was logged, and if it looks sane then add facts
  * and turn the log instruction into a  */
+/* Adds an entry in the log guards table for a guard produced from a logging
+ * instruction, and marks the facts as depending on it. */
+static void add_log_guard(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb,
+                          MVMSpeshIns *ins, MVMSpeshFacts *facts) {
+    g->log_guards[g->num_log_guards].ins = ins;
+    g->log_guards[g->num_log_guards].bb  = bb;
+    facts->flags     |= MVM_SPESH_FACT_FROM_LOG_GUARD;
+    facts->log_guard  = g->num_log_guards;
+    g->num_log_guards++;
+}
+
+/* Sees if the logging runs saw the same code object at a logging site time
+ * after time. If so, we guard on its identity, so that invocations of it
+ * can be resolved and perhaps inlined. Uses the site's inline cache in the
+ * statistics if there is one, and requires every logging run that reached
+ * the site to agree otherwise. Returns non-zero if a guard was produced. */
+static MVMint32 log_code_facts(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb,
+                               MVMSpeshIns *ins) {
+    MVMObject     *code = NULL;
+    MVMSpeshFacts *facts;
+    MVMint32       dominant;
+
+    MVMuint16 log_start = ins->operands[1].lit_i16 * MVM_SPESH_LOG_RUNS;
+    MVMuint16 i;
+    dominant = MVM_spesh_stats_log_site_dominant_value(tc, g, ins->operands[1].lit_i16, &code);
+    if (dominant == 0)
+        return 0;
+    if (dominant < 0) {
+        for (i = log_start; i < log_start + MVM_SPESH_LOG_RUNS; i++) {
+            MVMObject *consider = (MVMObject *)g->log_slots[i];
+            if (consider) {
+                if (!code)
+                    code = consider;
+                else if (code != consider)
+                    return 0;
+            }
+        }
+        if (!code || !IS_CONCRETE(code) || (REPR(code)->ID != MVM_REPR_ID_MVMCode &&
+                !STABLE(code)->invocation_spec))
+            return 0;
+    }
+    if (STABLE(code)->container_spec)
+        return 0;
+
+    /* Produce an identity guard and set facts. */
+    facts           = &g->facts[ins->operands[0].reg.orig][ins->operands[0].reg.i];
+    facts->type     = STABLE(code)->WHAT;
+    facts->value.o  = code;
+    facts->flags   |= (MVM_SPESH_FACT_KNOWN_VALUE | MVM_SPESH_FACT_KNOWN_TYPE |
+                       MVM_SPESH_FACT_CONCRETE | MVM_SPESH_FACT_DECONTED);
+    ins->info       = MVM_op_get_op(MVM_OP_sp_guardobj);
+    ins->operands[1].lit_i16 = MVM_spesh_add_spesh_slot(tc, g, (MVMCollectable *)code);
+    add_log_guard(tc, g, bb, ins, facts);
+    return 1;
+}
+
 static void log_facts(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb, MVMSpeshIns *ins) {
     MVMObject     *stable_value = NULL;
     MVMObject     *stable_cont  = NULL;
     MVMSpeshFacts *facts;
 
+    MVMObject     *dominant_type;
+    MVMuint32      dominant_concrete;
+    MVMint32       dominant;
+
     /* See if all the recorded facts match up; a NULL means there was a code
-     * path that never reached making a log entry. */
+     * path that never reached making a log entry. If we have statistics for
+     * the logging site, aggregated over all of the logging runs made with
+     * our guards, then instead look for a value of the type that dominates
+     * there, and give up if no type does. */
     MVMuint16 log_start = ins->operands[1].lit_i16 * MVM_SPESH_LOG_RUNS;
     MVMuint16 i;
+    if (log_code_facts(tc, g, bb, ins))
+        return;
+    dominant = MVM_spesh_stats_log_site_dominant(tc, g, ins->operands[1].lit_i16,
+        &dominant_type, &dominant_concrete);
+    if (dominant == 0)
+        return;
     for (i = log_start; i < log_start + MVM_SPESH_LOG_RUNS; i++) {
         MVMObject *consider = (MVMObject *)g->log_slots[i];
         if (consider) {
-            if (!stable_value) {
+            if (dominant > 0) {
+                if (STABLE(consider) == STABLE(dominant_type)
+                        && (IS_CONCRETE(consider) ? 1 : 0) == dominant_concrete) {
+                    stable_value = consider;
+                    break;
+                }
+            }
+            else if (!stable_value) {
                 stable_value = consider;
             }
             else if (STABLE(stable_value) != STABLE(consider)
@@ -387,11 +463,7 @@ static void log_facts(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb, MV
     }
 
     /* Add entry in log guards table, and mark facts as depending on it. */
-    g->log_guards[g->num_log_guards].ins = ins;
-    g->log_guards[g->num_log_guards].bb  = bb;
-    facts->flags     |= MVM_SPESH_FACT_FROM_LOG_GUARD;
-    facts->log_guard  = g->num_log_guards;
-    g->num_log_guards++;
+    add_log_guard(tc, g, bb, ins, facts);
 }
 
 /* Visits the blocks in dominator tree order, recursively. */
@@ -1142,6 +1142,10 @@ MVMSpeshGraph * MVM_spesh_graph_create_from_cand(MVMThreadContext *tc, MVMStatic
     g->num_lexicals      = cand->num_lexicals;
     g->inlines           = cand->inlines;
     g->num_inlines       = cand->num_inlines;
+    g->materializations       = cand->materializations;
+    g->num_materializations   = cand->num_materializations;
+    g->materialized_attrs     = cand->materialized_attrs;
+    g->num_materialized_attrs = cand->num_materialized_attrs;
     g->deopt_addrs       = cand->deopts;
     g->num_deopt_addrs   = cand->num_deopts;
     g->alloc_deopt_addrs = cand->num_deopts;
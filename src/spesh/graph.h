@@ -70,6 +70,15 @@ struct MVMSpeshGraph {
     MVMSpeshInline *inlines;
     MVMint32 num_inlines;
 
+    /* Objects that escape analysis did away with, to be materialized at
+     * certain deopt points, and the table of their attributes. */
+    MVMSpeshMaterialization  *materializations;
+    MVMuint32                 num_materializations;
+    MVMuint32                 alloc_materializations;
+    MVMSpeshMaterializedAttr *materialized_attrs;
+    MVMuint32                 num_materialized_attrs;
+    MVMuint32                 alloc_materialized_attrs;
+
     /* Logging slots, along with the number of them. */
     MVMint32 num_log_slots;
     MVMCollectable **log_slots;
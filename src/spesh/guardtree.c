@@ -0,0 +1,500 @@
+#include "moar.h"
+
+/* A subtree already built for a set of candidates (as a bit set of their
+ * indexes), so it can be shared rather than built again. */
+typedef struct {
+    MVMuint64 cands;
+    MVMuint32 level;
+    MVMint32  what;
+    MVMuint32 node;
+} BuiltSubtree;
+
+/* What a built subtree does: considers the slots from its level onwards,
+ * or tests the argument loaded for its level (or the value inside it). */
+#define BUILT_LEVEL        0
+#define BUILT_TESTS        1
+#define BUILT_INNER_TESTS  2
+
+/* State kept while building a guard tree. */
+typedef struct {
+    /* The body of the static frame whose candidates we're building a tree
+     * for. */
+    MVMStaticFrameBody *body;
+
+    /* The nodes built so far. */
+    MVMSpeshGuardTreeNode *nodes;
+    MVMuint32 num_nodes;
+    MVMuint32 alloc_nodes;
+
+    /* The argument slots guarded on by candidates of the callsite we are
+     * currently building a subtree for, in ascending order. */
+    MVMuint32 slots[2 * MVM_INTERN_ARITY_LIMIT];
+    MVMuint32 num_slots;
+
+    /* Subtrees built so far for the current callsite. */
+    BuiltSubtree *built;
+    MVMuint32 num_built;
+    MVMuint32 alloc_built;
+
+    /* The first node built for the current callsite, and whether it needs
+     * more than MVM_SPESH_GUARD_TREE_MAX_NODES nodes. */
+    MVMuint32 callsite_start;
+    MVMint32  too_big;
+} TreeBuilder;
+
+/* Tests an argument against a guard. */
+MVMint32 MVM_spesh_guard_tree_test(MVMThreadContext *tc, MVMuint16 kind, MVMSTable *st,
+        MVMObject *arg) {
+    if (!arg)
+        return 0;
+    switch (kind) {
+        case MVM_SPESH_GUARD_CONC:
+            return IS_CONCRETE(arg) && STABLE(arg) == st;
+        case MVM_SPESH_GUARD_TYPE:
+            return !IS_CONCRETE(arg) && STABLE(arg) == st;
+        case MVM_SPESH_GUARD_DC_CONC: {
+            MVMRegister dc;
+            STABLE(arg)->container_spec->fetch(tc, arg, &dc);
+            return dc.o && IS_CONCRETE(dc.o) && STABLE(dc.o) == st;
+        }
+        case MVM_SPESH_GUARD_DC_TYPE: {
+            MVMRegister dc;
+            STABLE(arg)->container_spec->fetch(tc, arg, &dc);
+            return dc.o && !IS_CONCRETE(dc.o) && STABLE(dc.o) == st;
+        }
+        case MVM_SPESH_GUARD_DC_CONC_RW: {
+            MVMRegister dc;
+            if (!STABLE(arg)->container_spec->can_store(tc, arg))
+                return 0;
+            STABLE(arg)->container_spec->fetch(tc, arg, &dc);
+            return dc.o && IS_CONCRETE(dc.o) && STABLE(dc.o) == st;
+        }
+        case MVM_SPESH_GUARD_DC_TYPE_RW: {
+            MVMRegister dc;
+            if (!STABLE(arg)->container_spec->can_store(tc, arg))
+                return 0;
+            STABLE(arg)->container_spec->fetch(tc, arg, &dc);
+            return dc.o && !IS_CONCRETE(dc.o) && STABLE(dc.o) == st;
+        }
+        default:
+            return 0;
+    }
+}
+
+/* Finds a candidate's guard on an argument slot; inner selects a guard on
+ * the value inside a container rather than on the argument itself. */
+static MVMSpeshGuard * find_guard(MVMSpeshCandidate *cand, MVMuint32 slot, MVMint32 inner) {
+    MVMuint32 i;
+    for (i = 0; i < cand->num_guards; i++) {
+        MVMSpeshGuard *guard = &cand->guards[i];
+        if ((MVMuint32)guard->slot == slot &&
+                (inner ? guard->kind >= MVM_SPESH_GUARD_DC_CONC : guard->kind < MVM_SPESH_GUARD_DC_CONC))
+            return guard;
+    }
+    return NULL;
+}
+
+static MVMint32 same_guard(MVMSpeshGuard *a, MVMSpeshGuard *b) {
+    return a->kind == b->kind && a->match == b->match;
+}
+
+/* Checks if an argument passing guard a is sure to pass guard b too. The
+ * only guards on a slot that can both pass without being the same are
+ * the rw container ones and their plain counterparts. */
+static MVMint32 implies_guard(MVMSpeshGuard *a, MVMSpeshGuard *b) {
+    if (a->match != b->match)
+        return 0;
+    return a->kind == b->kind
+        || (a->kind == MVM_SPESH_GUARD_DC_CONC_RW && b->kind == MVM_SPESH_GUARD_DC_CONC)
+        || (a->kind == MVM_SPESH_GUARD_DC_TYPE_RW && b->kind == MVM_SPESH_GUARD_DC_TYPE);
+}
+static MVMint32 is_rw_guard(MVMSpeshGuard *guard) {
+    return guard->kind == MVM_SPESH_GUARD_DC_CONC_RW || guard->kind == MVM_SPESH_GUARD_DC_TYPE_RW;
+}
+
+/* Turns a list of candidate indexes into a bit set; there are never more
+ * than MVM_SPESH_MAX_SLOTS (64) candidates. */
+static MVMuint64 cands_set(MVMuint32 *cands, MVMuint32 num_cands) {
+    MVMuint64 set = 0;
+    MVMuint32 i;
+    for (i = 0; i < num_cands; i++)
+        set |= (MVMuint64)1 << cands[i];
+    return set;
+}
+
+/* Looks for a subtree already built for the same thing; returns 1 and sets
+ * node if there is one. */
+static MVMint32 find_built(TreeBuilder *tb, MVMuint64 set, MVMuint32 level, MVMint32 what,
+        MVMuint32 *node) {
+    MVMuint32 i;
+    for (i = 0; i < tb->num_built; i++) {
+        BuiltSubtree *b = &tb->built[i];
+        if (b->cands == set && b->level == level && b->what == what) {
+            *node = b->node;
+            return 1;
+        }
+    }
+    return 0;
+}
+static MVMuint32 add_built(TreeBuilder *tb, MVMuint64 set, MVMuint32 level, MVMint32 what,
+        MVMuint32 node) {
+    if (tb->num_built == tb->alloc_built) {
+        tb->alloc_built = tb->alloc_built ? 2 * tb->alloc_built : 16;
+        tb->built = MVM_realloc(tb->built, tb->alloc_built * sizeof(BuiltSubtree));
+    }
+    tb->built[tb->num_built].cands = set;
+    tb->built[tb->num_built].level = level;
+    tb->built[tb->num_built].what  = what;
+    tb->built[tb->num_built].node  = node;
+    tb->num_built++;
+    return node;
+}
+
+/* Adds a node, returning its index. */
+static MVMuint32 add_node(TreeBuilder *tb, MVMuint16 op) {
+    MVMSpeshGuardTreeNode *node;
+    if (tb->num_nodes == tb->alloc_nodes) {
+        tb->alloc_nodes = tb->alloc_nodes ? 2 * tb->alloc_nodes : 16;
+        tb->nodes = MVM_realloc(tb->nodes, tb->alloc_nodes * sizeof(MVMSpeshGuardTreeNode));
+    }
+    node = &tb->nodes[tb->num_nodes];
+    memset(node, 0, sizeof(MVMSpeshGuardTreeNode));
+    node->op = op;
+    if (tb->num_nodes - tb->callsite_start >= MVM_SPESH_GUARD_TREE_MAX_NODES)
+        tb->too_big = 1;
+    return tb->num_nodes++;
+}
+
+static MVMuint32 build_tests(TreeBuilder *tb, MVMuint32 *cands, MVMuint32 num_cands,
+    MVMuint32 level, MVMint32 inner);
+
+/* Builds the subtree that checks argument slots from level onwards, for the
+ * given candidates (which are in ascending index order). Returns the index
+ * of its first node, or 0 if there are no candidates. */
+static MVMuint32 build_level(TreeBuilder *tb, MVMuint32 *cands, MVMuint32 num_cands,
+        MVMuint32 level) {
+    MVMSpeshCandidate **all = tb->body->spesh_candidates;
+    MVMuint64 set = cands_set(cands, num_cands);
+    MVMuint32 load, first, i;
+
+    if (num_cands == 0 || tb->too_big)
+        return 0;
+    if (find_built(tb, set, level, BUILT_LEVEL, &first))
+        return first;
+
+    /* If we've checked all slots, we have a match; candidates earlier in
+     * the array take priority. */
+    if (level == tb->num_slots) {
+        MVMuint32 result = add_node(tb, MVM_SPESH_GUARD_TREE_RESULT);
+        tb->nodes[result].arg_index = cands[0];
+        return add_built(tb, set, level, BUILT_LEVEL, result);
+    }
+
+    /* If none of these candidates guard the slot, skip it. */
+    for (i = 0; i < num_cands; i++)
+        if (find_guard(all[cands[i]], tb->slots[level], 0))
+            break;
+    if (i == num_cands)
+        return add_built(tb, set, level, BUILT_LEVEL,
+            build_level(tb, cands, num_cands, level + 1));
+
+    /* Otherwise, load the argument and test it. */
+    load = add_node(tb, MVM_SPESH_GUARD_TREE_LOAD_ARG);
+    tb->nodes[load].arg_index = tb->slots[level];
+    first = build_tests(tb, cands, num_cands, level, 0);
+    tb->nodes[load].yes = first;
+    return add_built(tb, set, level, BUILT_LEVEL, load);
+}
+
+/* Builds a chain of tests on the loaded argument, one per distinct guard
+ * that the candidates have on it (or, if inner is set, on the value in it).
+ * Below each test go the candidates that are sure to pass their guard on
+ * the argument given that the test passed and those before it in the chain
+ * failed, along with those with no such guard; at the end of the chain go
+ * just the latter. Rw container guards are tested before the plain ones
+ * they imply, so that a candidate is never left out of a branch where it
+ * might still match, and the first candidate to match is always picked. */
+static MVMuint32 build_tests(TreeBuilder *tb, MVMuint32 *cands, MVMuint32 num_cands,
+        MVMuint32 level, MVMint32 inner) {
+    MVMSpeshCandidate **all = tb->body->spesh_candidates;
+    MVMuint64 set  = cands_set(cands, num_cands);
+    MVMint32  what = inner ? BUILT_INNER_TESTS : BUILT_TESTS;
+    MVMuint32 slot = tb->slots[level];
+    MVMuint32 wildcards[MVM_SPESH_MAX_SLOTS];
+    MVMuint32 num_wildcards = 0;
+    MVMuint32 first = 0, prev = 0, fallback, i, j;
+    MVMint32  rw_pass;
+
+    if (tb->too_big)
+        return 0;
+    if (find_built(tb, set, level, what, &first))
+        return first;
+
+    for (i = 0; i < num_cands; i++)
+        if (!find_guard(all[cands[i]], slot, inner))
+            wildcards[num_wildcards++] = cands[i];
+
+    /* Test rw container guards before the plain ones. */
+    for (rw_pass = 1; rw_pass >= 0; rw_pass--) {
+        for (i = 0; i < num_cands; i++) {
+            MVMSpeshGuard *guard = find_guard(all[cands[i]], slot, inner);
+            MVMuint32      branch[MVM_SPESH_MAX_SLOTS];
+            MVMuint32      num_branch = 0;
+            MVMuint32      test, yes;
+            if (!guard || is_rw_guard(guard) != rw_pass)
+                continue;
+
+            /* Only one test per distinct guard. */
+            for (j = 0; j < i; j++) {
+                MVMSpeshGuard *other = find_guard(all[cands[j]], slot, inner);
+                if (other && same_guard(other, guard))
+                    break;
+            }
+            if (j < i)
+                continue;
+
+            /* Build what follows the test passing. */
+            for (j = 0; j < num_cands; j++) {
+                MVMSpeshGuard *other = find_guard(all[cands[j]], slot, inner);
+                if (!other || implies_guard(guard, other))
+                    branch[num_branch++] = cands[j];
+            }
+            test = add_node(tb, MVM_SPESH_GUARD_TREE_TEST);
+            tb->nodes[test].kind     = guard->kind;
+            tb->nodes[test].match.st = (MVMSTable *)guard->match;
+            yes = inner
+                ? build_level(tb, branch, num_branch, level + 1)
+                : build_tests(tb, branch, num_branch, level, 1);
+            tb->nodes[test].yes = yes;
+
+            if (prev)
+                tb->nodes[prev].no = test;
+            else
+                first = test;
+            prev = test;
+        }
+    }
+
+    fallback = inner
+        ? build_level(tb, wildcards, num_wildcards, level + 1)
+        : build_tests(tb, wildcards, num_wildcards, level, 1);
+    if (!prev)
+        return add_built(tb, set, level, what, fallback);
+    tb->nodes[prev].no = fallback;
+    return add_built(tb, set, level, what, first);
+}
+
+/* Builds a chain that tries each of the candidates in turn, loading the
+ * arguments it guards on and testing each guard, and going on to the next
+ * candidate as soon as one fails. Used in place of a tree for candidates
+ * whose guards would need too many nodes to sort out in one. */
+static MVMuint32 build_chain(TreeBuilder *tb, MVMuint32 *cands, MVMuint32 num_cands) {
+    MVMSpeshCandidate **all  = tb->body->spesh_candidates;
+    MVMuint32           next = 0;
+    MVMuint32           i    = num_cands;
+    while (i--) {
+        MVMSpeshCandidate *cand = all[cands[i]];
+        MVMSpeshGuard     *sorted[4 * MVM_INTERN_ARITY_LIMIT];
+        MVMuint32          num_sorted = 0;
+        MVMuint32          cur, j, k;
+
+        /* Order the guards by slot, and within a slot test the argument
+         * before the value inside it. */
+        for (j = 0; j < cand->num_guards; j++) {
+            MVMSpeshGuard *guard = &cand->guards[j];
+            for (k = num_sorted; k > 0; k--) {
+                MVMSpeshGuard *other = sorted[k - 1];
+                if (other->slot < guard->slot || (other->slot == guard->slot
+                        && other->kind < MVM_SPESH_GUARD_DC_CONC))
+                    break;
+                sorted[k] = other;
+            }
+            sorted[k] = guard;
+            num_sorted++;
+        }
+
+        /* Build the candidate's part of the chain from its end. */
+        cur = add_node(tb, MVM_SPESH_GUARD_TREE_RESULT);
+        tb->nodes[cur].arg_index = cands[i];
+        j = num_sorted;
+        while (j--) {
+            MVMuint32 test = add_node(tb, MVM_SPESH_GUARD_TREE_TEST);
+            tb->nodes[test].kind     = sorted[j]->kind;
+            tb->nodes[test].match.st = (MVMSTable *)sorted[j]->match;
+            tb->nodes[test].yes      = cur;
+            tb->nodes[test].no       = next;
+            cur = test;
+            if (j == 0 || sorted[j - 1]->slot != sorted[j]->slot) {
+                MVMuint32 load = add_node(tb, MVM_SPESH_GUARD_TREE_LOAD_ARG);
+                tb->nodes[load].arg_index = sorted[j]->slot;
+                tb->nodes[load].yes       = cur;
+                cur = load;
+            }
+        }
+        next = cur;
+    }
+    return next;
+}
+
+/* Works out the argument slots guarded on by candidates of a callsite. */
+static void find_slots(TreeBuilder *tb, MVMuint32 *cands, MVMuint32 num_cands) {
+    MVMSpeshCandidate **all = tb->body->spesh_candidates;
+    MVMuint32 i, j, k;
+    tb->num_slots = 0;
+    for (i = 0; i < num_cands; i++) {
+        MVMSpeshCandidate *cand = all[cands[i]];
+        for (j = 0; j < cand->num_guards; j++) {
+            MVMuint32 slot = (MVMuint32)cand->guards[j].slot;
+            for (k = 0; k < tb->num_slots; k++)
+                if (tb->slots[k] >= slot)
+                    break;
+            if (k < tb->num_slots && tb->slots[k] == slot)
+                continue;
+            memmove(tb->slots + k + 1, tb->slots + k, (tb->num_slots - k) * sizeof(MVMuint32));
+            tb->slots[k] = slot;
+            tb->num_slots++;
+        }
+    }
+}
+
+/* Builds a new guard tree for the static frame's candidates, and installs
+ * it. Must be called either with the spesh install lock held, or by the GC
+ * while the world is stopped (in_gc), in which case the old tree can be
+ * freed right away. */
+void MVM_spesh_guard_tree_rebuild(MVMThreadContext *tc, MVMStaticFrameBody *body, MVMint32 in_gc) {
+    MVMSpeshCandidate **all     = body->spesh_candidates;
+    MVMuint32           num_all = body->num_spesh_candidates;
+    MVMSpeshGuardTree  *old     = body->spesh_guard_tree;
+    MVMSpeshGuardTree  *tree    = NULL;
+    TreeBuilder         tb;
+    MVMuint32           i, j, prev = 0;
+    MVMint32            have_prev = 0;
+
+    tb.body        = body;
+    tb.nodes       = NULL;
+    tb.num_nodes   = 0;
+    tb.alloc_nodes = 0;
+    tb.built       = NULL;
+    tb.num_built   = 0;
+    tb.alloc_built = 0;
+    tb.callsite_start = 0;
+    tb.too_big        = 0;
+
+    /* Build a chain of callsite nodes, each leading to the subtree for the
+     * candidates with that callsite. The first one is the root. */
+    for (i = 0; i < num_all; i++) {
+        MVMCallsite *cs = all[i]->cs;
+        MVMuint32    cands[MVM_SPESH_MAX_SLOTS];
+        MVMuint32    num_cands = 0;
+        MVMuint32    node;
+        if (all[i]->discarded)
+            continue;
+        for (j = 0; j < i; j++)
+            if (!all[j]->discarded && all[j]->cs == cs)
+                break;
+        if (j < i)
+            continue;
+        for (j = i; j < num_all; j++)
+            if (!all[j]->discarded && all[j]->cs == cs)
+                cands[num_cands++] = j;
+
+        node = add_node(&tb, MVM_SPESH_GUARD_TREE_CALLSITE);
+        tb.nodes[node].match.cs = cs;
+        if (have_prev)
+            tb.nodes[prev].no = node;
+        prev      = node;
+        have_prev = 1;
+
+        /* Build the tree for the callsite, or if that gets too big, a
+         * chain that tries the candidates in turn. */
+        find_slots(&tb, cands, num_cands);
+        tb.num_built      = 0;
+        tb.callsite_start = tb.num_nodes;
+        tb.too_big        = 0;
+        tb.nodes[node].yes = build_level(&tb, cands, num_cands, 0);
+        if (tb.too_big) {
+            tb.num_nodes       = tb.callsite_start;
+            tb.too_big         = 0;
+            tb.nodes[node].yes = build_chain(&tb, cands, num_cands);
+        }
+    }
+
+    /* Copy the nodes into a single block along with the tree. */
+    if (tb.num_nodes) {
+        size_t size = sizeof(MVMSpeshGuardTree) + tb.num_nodes * sizeof(MVMSpeshGuardTreeNode);
+        tree            = MVM_fixed_size_alloc(tc, tc->instance->fsa, size);
+        tree->nodes     = (MVMSpeshGuardTreeNode *)((char *)tree + sizeof(MVMSpeshGuardTree));
+        tree->num_nodes = tb.num_nodes;
+        memcpy(tree->nodes, tb.nodes, tb.num_nodes * sizeof(MVMSpeshGuardTreeNode));
+    }
+    MVM_free(tb.nodes);
+    MVM_free(tb.built);
+
+    /* Install it, and get rid of the old one. */
+    MVM_barrier();
+    body->spesh_guard_tree = tree;
+    if (old) {
+        size_t size = sizeof(MVMSpeshGuardTree) + old->num_nodes * sizeof(MVMSpeshGuardTreeNode);
+        if (in_gc)
+            MVM_fixed_size_free(tc, tc->instance->fsa, size, old);
+        else
+            MVM_fixed_size_free_at_safepoint(tc, tc->instance->fsa, size, old);
+    }
+}
+
+/* Runs the guard tree for a call, returning the index of the matching
+ * candidate, or -1 if there is none. */
+MVMint32 MVM_spesh_guard_tree_run(MVMThreadContext *tc, MVMSpeshGuardTree *tree,
+        MVMCallsite *cs, MVMRegister *args) {
+    MVMSpeshGuardTreeNode *nodes = tree->nodes;
+    MVMObject             *arg   = NULL;
+    MVMuint32              cur   = 0;
+    do {
+        MVMSpeshGuardTreeNode *node = &nodes[cur];
+        switch (node->op) {
+            case MVM_SPESH_GUARD_TREE_CALLSITE:
+                cur = node->match.cs == cs ? node->yes : node->no;
+                break;
+            case MVM_SPESH_GUARD_TREE_LOAD_ARG:
+                arg = args[node->arg_index].o;
+                cur = node->yes;
+                break;
+            case MVM_SPESH_GUARD_TREE_TEST:
+                cur = MVM_spesh_guard_tree_test(tc, node->kind, node->match.st, arg)
+                    ? node->yes
+                    : node->no;
+                break;
+            case MVM_SPESH_GUARD_TREE_RESULT:
+                return (MVMint32)node->arg_index;
+            default:
+                MVM_panic(1, "Unknown spesh guard tree op %d", node->op);
+        }
+    } while (cur);
+    return -1;
+}
+
+/* Marks the STables the guard tree tests against. */
+void MVM_spesh_guard_tree_gc_mark(MVMThreadContext *tc, MVMSpeshGuardTree *tree,
+        MVMGCWorklist *worklist) {
+    MVMuint32 i;
+    for (i = 0; i < tree->num_nodes; i++)
+        if (tree->nodes[i].op == MVM_SPESH_GUARD_TREE_TEST)
+            MVM_gc_worklist_add(tc, worklist, &(tree->nodes[i].match.st));
+}
+
+/* Describes the references of the guard tree for heap snapshots. */
+void MVM_spesh_guard_tree_gc_describe(MVMThreadContext *tc, MVMHeapSnapshotState *ss,
+        MVMSpeshGuardTree *tree) {
+    MVMuint32 i;
+    for (i = 0; i < tree->num_nodes; i++)
+        if (tree->nodes[i].op == MVM_SPESH_GUARD_TREE_TEST)
+            MVM_profile_heap_add_collectable_rel_const_cstr(tc, ss,
+                (MVMCollectable *)tree->nodes[i].match.st, "Spesh guard tree match");
+}
+
+/* Frees a guard tree. */
+void MVM_spesh_guard_tree_destroy(MVMThreadContext *tc, MVMSpeshGuardTree *tree) {
+    MVM_fixed_size_free(tc, tc->instance->fsa,
+        sizeof(MVMSpeshGuardTree) + tree->num_nodes * sizeof(MVMSpeshGuardTreeNode),
+        tree);
+}
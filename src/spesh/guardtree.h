@@ -0,0 +1,78 @@
+/* The guard tree is used to pick a specialization candidate for a call. It
+ * is compiled from the argument guards of all candidates of a static frame
+ * that are not discarded, and is represented as an array of nodes, each of
+ * which has an op, along with yes and no indexes saying which node to go to
+ * next. An index of zero means there is no matching candidate (node zero is
+ * the root, and so is never the target of a branch).
+ *
+ * The tree starts with a chain of callsite nodes, one per callsite shape.
+ * Once the callsite matches, the tree considers each argument slot that any
+ * candidate guards on, in order. A load node picks up the argument, and a
+ * chain of test nodes checks it against each distinct guard on that slot;
+ * candidates that don't guard the slot at all are added below every test
+ * as well as below the end of the chain. A test on a container is followed
+ * by tests on its contained value, in the same way. Finally, a result node
+ * gives the index of the first candidate (in the candidates array order)
+ * that matches, so the tree picks the same candidate as trying each in
+ * turn would.
+ *
+ * The guards on a slot exclude one another, except that a value in an rw
+ * container passing an rw guard also passes the plain guard for the same
+ * type. So rw guards are tested first, and candidates with the plain guard
+ * go below the rw test as well. Selection then costs one load and a short
+ * chain of tests per guarded argument, no matter how many candidates there
+ * are. Subtrees for the same candidates are built once and shared, and if
+ * the candidates of a callsite would still need too many nodes, they get a
+ * chain that tries each candidate in turn instead.
+ *
+ * The tree is immutable once built. When the candidates change, a new tree
+ * is built and installed, and the old one is freed at the next safepoint,
+ * so that threads can run it without taking a lock. */
+
+/* The most nodes the tree for one callsite may have; past that, a chain that
+ * tries each candidate in turn is built instead. */
+#define MVM_SPESH_GUARD_TREE_MAX_NODES  256
+
+/* Ops that a node may have. */
+#define MVM_SPESH_GUARD_TREE_CALLSITE   0   /* Check callsite is cs. */
+#define MVM_SPESH_GUARD_TREE_LOAD_ARG   1   /* Load argument arg_index; always yes. */
+#define MVM_SPESH_GUARD_TREE_TEST       2   /* Test loaded arg against guard kind and st. */
+#define MVM_SPESH_GUARD_TREE_RESULT     3   /* Matched candidate result. */
+
+/* A node in the guard tree. */
+struct MVMSpeshGuardTreeNode {
+    /* The op, and for tests the guard kind (one of MVM_SPESH_GUARD_*). */
+    MVMuint16 op;
+    MVMuint16 kind;
+
+    /* Argument index for a load; candidate index for a result. */
+    MVMuint32 arg_index;
+
+    /* Where to go on the test succeeding and failing. */
+    MVMuint32 yes;
+    MVMuint32 no;
+
+    /* The callsite or STable tested against. */
+    union {
+        MVMCallsite *cs;
+        MVMSTable   *st;
+    } match;
+};
+
+/* A guard tree. */
+struct MVMSpeshGuardTree {
+    /* The nodes, which are allocated along with the tree itself. */
+    MVMSpeshGuardTreeNode *nodes;
+    MVMuint32 num_nodes;
+};
+
+void MVM_spesh_guard_tree_rebuild(MVMThreadContext *tc, MVMStaticFrameBody *body, MVMint32 in_gc);
+MVMint32 MVM_spesh_guard_tree_run(MVMThreadContext *tc, MVMSpeshGuardTree *tree,
+    MVMCallsite *cs, MVMRegister *args);
+MVMint32 MVM_spesh_guard_tree_test(MVMThreadContext *tc, MVMuint16 kind, MVMSTable *st,
+    MVMObject *arg);
+void MVM_spesh_guard_tree_gc_mark(MVMThreadContext *tc, MVMSpeshGuardTree *tree,
+    MVMGCWorklist *worklist);
+void MVM_spesh_guard_tree_gc_describe(MVMThreadContext *tc, MVMHeapSnapshotState *ss,
+    MVMSpeshGuardTree *tree);
+void MVM_spesh_guard_tree_destroy(MVMThreadContext *tc, MVMSpeshGuardTree *tree);
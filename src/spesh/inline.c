@@ -216,7 +216,7 @@ static void merge_graph(MVMThreadContext *tc, MVMSpeshGraph *inliner,
                  MVMSpeshIns *invoke_ins) {
     MVMSpeshFacts **merged_facts;
     MVMuint16      *merged_fact_counts;
-    MVMint32        i, total_inlines, orig_deopt_addrs;
+    MVMint32        i, total_inlines, orig_deopt_addrs, orig_spesh_slots;
     MVMSpeshBB     *inlinee_first_bb = NULL, *inlinee_last_bb = NULL;
     MVMint32        active_handlers_at_invoke = 0;
 
@@ -335,6 +335,7 @@ static void merge_graph(MVMThreadContext *tc, MVMSpeshGraph *inliner,
     inliner->fact_counts = merged_fact_counts;
 
     /* Copy over spesh slots. */
+    orig_spesh_slots = inliner->num_spesh_slots;
     for (i = 0; i < inlinee->num_spesh_slots; i++)
         MVM_spesh_add_spesh_slot(tc, inliner, inlinee->spesh_slots[i]);
 
@@ -372,6 +373,32 @@ static void merge_graph(MVMThreadContext *tc, MVMSpeshGraph *inliner,
         inliner->num_deopt_addrs += inlinee->num_deopt_addrs;
     }
 
+    /* Merge the objects to materialize on deopt, if any. */
+    if (inlinee->num_materializations) {
+        MVMuint32 first_attr = inliner->num_materialized_attrs;
+        inliner->alloc_materializations = inliner->num_materializations
+            + inlinee->num_materializations;
+        inliner->materializations = MVM_realloc(inliner->materializations,
+            inliner->alloc_materializations * sizeof(MVMSpeshMaterialization));
+        for (i = 0; i < (MVMint32)inlinee->num_materializations; i++) {
+            MVMSpeshMaterialization *m = &(inliner->materializations[inliner->num_materializations++]);
+            *m = inlinee->materializations[i];
+            m->deopt_idx  += orig_deopt_addrs;
+            m->target_reg += inliner->num_locals;
+            m->st_slot    += orig_spesh_slots;
+            m->first_attr += first_attr;
+        }
+        inliner->alloc_materialized_attrs = inliner->num_materialized_attrs
+            + inlinee->num_materialized_attrs;
+        inliner->materialized_attrs = MVM_realloc(inliner->materialized_attrs,
+            inliner->alloc_materialized_attrs * sizeof(MVMSpeshMaterializedAttr));
+        for (i = 0; i < (MVMint32)inlinee->num_materialized_attrs; i++) {
+            MVMSpeshMaterializedAttr *ma = &(inliner->materialized_attrs[inliner->num_materialized_attrs++]);
+            *ma = inlinee->materialized_attrs[i];
+            ma->reg += inliner->num_locals;
+        }
+    }
+
     /* Merge inlines table, and add us an entry too. */
     total_inlines = inliner->num_inlines + inlinee->num_inlines + 1;
     inliner->inlines = inliner->num_inlines
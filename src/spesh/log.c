@@ -60,6 +60,8 @@ void MVM_spesh_log_add_logging(MVMThreadContext *tc, MVMSpeshGraph *g, MVMint32
             case MVM_OP_getattrs_o:
             case MVM_OP_getlexstatic_o:
             case MVM_OP_getlexperinvtype_o:
+            case MVM_OP_findmeth:
+            case MVM_OP_findmeth_s:
                 insert_log(tc, g, bb, ins, 0);
                 break;
             case MVM_OP_invoke_o:
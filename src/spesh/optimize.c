@@ -729,6 +729,46 @@ static void optimize_coerce(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *
     }
 }
 
+/* If we box a known value that is in the boxed constant cache, to a known
+ * type, we can load the cached box from a spesh slot instead. Returns
+ * non-zero if the box was replaced. */
+static MVMint32 optimize_box_constant(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshIns *ins) {
+    MVMSpeshFacts *value_facts = MVM_spesh_get_facts(tc, g, ins->operands[1]);
+    MVMSpeshFacts *type_facts  = MVM_spesh_get_facts(tc, g, ins->operands[2]);
+    MVMObject     *cached      = NULL;
+    if (!(value_facts->flags & MVM_SPESH_FACT_KNOWN_VALUE)
+            || !(type_facts->flags & MVM_SPESH_FACT_KNOWN_TYPE) || !type_facts->type)
+        return 0;
+    switch (ins->info->opcode) {
+        case MVM_OP_box_i:
+            cached = MVM_intcache_get(tc, type_facts->type, value_facts->value.i);
+            break;
+        case MVM_OP_box_n:
+            cached = MVM_intcache_get_num(tc, type_facts->type, value_facts->value.n);
+            break;
+        case MVM_OP_box_s:
+            cached = MVM_intcache_get_str(tc, type_facts->type, value_facts->value.s);
+            break;
+    }
+    if (cached) {
+        MVMSpeshFacts *result_facts = MVM_spesh_get_facts(tc, g, ins->operands[0]);
+        MVMint16       spesh_slot   = MVM_spesh_add_spesh_slot_try_reuse(tc, g,
+            (MVMCollectable *)cached);
+        MVM_spesh_use_facts(tc, g, value_facts);
+        MVM_spesh_use_facts(tc, g, type_facts);
+        value_facts->usages--;
+        type_facts->usages--;
+        ins->info                = MVM_op_get_op(MVM_OP_sp_getspeshslot);
+        ins->operands[1].lit_i16 = spesh_slot;
+        result_facts->flags     |= MVM_SPESH_FACT_KNOWN_VALUE | MVM_SPESH_FACT_KNOWN_TYPE |
+                                   MVM_SPESH_FACT_CONCRETE | MVM_SPESH_FACT_DECONTED;
+        result_facts->value.o    = cached;
+        result_facts->type       = STABLE(cached)->WHAT;
+        return 1;
+    }
+    return 0;
+}
+
 /* If we know the type of a significant operand, we might try to specialize by
  * representation. */
 static void optimize_repr_op(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb,
@@ -994,8 +1034,8 @@ static MVMint32 try_find_spesh_candidate(MVMThreadContext *tc, MVMCode *code, MV
     MVMint32 num_spesh      = sfb->num_spesh_candidates;
     MVMint32 i, j;
     for (i = 0; i < num_spesh; i++) {
-        MVMSpeshCandidate *cand = &sfb->spesh_candidates[i];
-        if (cand->cs == arg_info->cs) {
+        MVMSpeshCandidate *cand = sfb->spesh_candidates[i];
+        if (cand->cs == arg_info->cs && !cand->discarded) {
             /* Matching callsite, now see if we have enough information to
              * test the guards. */
             MVMint32 guard_failed = 0;
@@ -1170,7 +1210,7 @@ static void optimize_call(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb
             if (spesh_cand >= 0) {
                 /* Yes. Will we be able to inline? */
                 MVMSpeshGraph *inline_graph = MVM_spesh_inline_try_get_graph(tc, g,
-                    target_code, &target_code->body.sf->body.spesh_candidates[spesh_cand]);
+                    target_code, target_code->body.sf->body.spesh_candidates[spesh_cand]);
                 if (inline_graph) {
                     /* Yes, have inline graph, so go ahead and do it. */
 #if MVM_LOG_INLINES
@@ -1634,7 +1674,8 @@ static void optimize_bb(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshBB *bb)
         case MVM_OP_box_i:
         case MVM_OP_box_n:
         case MVM_OP_box_s:
-            optimize_repr_op(tc, g, bb, ins, 2);
+            if (!optimize_box_constant(tc, g, ins))
+                optimize_repr_op(tc, g, bb, ins, 2);
             break;
         case MVM_OP_newexception:
         case MVM_OP_bindexmessage:
@@ -1891,5 +1932,6 @@ void MVM_spesh_optimize(MVMThreadContext *tc, MVMSpeshGraph *g) {
     eliminate_dead_ins(tc, g);
     eliminate_dead_bbs(tc, g);
     eliminate_unused_log_guards(tc, g);
+    MVM_spesh_escape(tc, g);
     second_pass(tc, g, g->entry);
 }
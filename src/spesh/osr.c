@@ -1,7 +1,7 @@
 #include "moar.h"
 
-/* Locates deopt index matching OSR point. */
-static MVMint32 get_osr_deopt_index(MVMThreadContext *tc, MVMSpeshCandidate *cand) {
+/* Locates deopt index matching OSR point, or -1 if there is none. */
+static MVMint32 find_osr_deopt_index(MVMThreadContext *tc, MVMSpeshCandidate *cand) {
     /* Calculate offset. */
     MVMint32 offset = (*(tc->interp_cur_op) - *(tc->interp_bytecode_start));
 
@@ -10,9 +10,17 @@ static MVMint32 get_osr_deopt_index(MVMThreadContext *tc, MVMSpeshCandidate *can
     for (i = 0; i < cand->num_deopts; i++)
         if (cand->deopts[2 * i] == offset)
             return i;
+    return -1;
+}
+
+/* Locates deopt index matching OSR point. */
+static MVMint32 get_osr_deopt_index(MVMThreadContext *tc, MVMSpeshCandidate *cand) {
+    MVMint32 idx = find_osr_deopt_index(tc, cand);
 
     /* If we couldn't locate it, something is really very wrong. */
-    MVM_oops(tc, "Spesh: get_osr_deopt_index failed");
+    if (idx < 0)
+        MVM_oops(tc, "Spesh: get_osr_deopt_index failed");
+    return idx;
 }
 
 /* Locates deopt index matching OSR finalize point. */
@@ -30,56 +38,12 @@ static MVMint32 get_osr_deopt_finalize_index(MVMThreadContext *tc, MVMSpeshCandi
     MVM_oops(tc, "Spesh: get_osr_deopt_finalize_index failed");
 }
 
-/* Called to start OSR. Switches us over to logging runs of spesh'd code, to
- * collect extra type info. */
-void MVM_spesh_osr(MVMThreadContext *tc) {
-    MVMSpeshCandidate *specialized;
-    MVMint32 osr_index;
-
-    /* Check OSR is enabled. */
-    if (!tc->instance->spesh_osr_enabled)
-        return;
-
-    /* Ensure that we are in a position to specialize. */
-    if (!tc->cur_frame->caller)
-        return;
-    if (!tc->cur_frame->params.callsite->is_interned)
-        return;
-    if (tc->cur_frame->static_info->body.num_spesh_candidates == MVM_SPESH_LIMIT)
-        return;
-
-    /* Produce logging spesh candidate. */
-    specialized = MVM_spesh_candidate_setup(tc, tc->cur_frame->static_info,
-        tc->cur_frame->params.callsite, tc->cur_frame->params.args, 1);
-    if (specialized) {
-        /* Set up frame to point to specialized logging code. */
-        tc->cur_frame->effective_bytecode    = specialized->bytecode;
-        tc->cur_frame->effective_handlers    = specialized->handlers;
-        tc->cur_frame->effective_spesh_slots = specialized->spesh_slots;
-        tc->cur_frame->spesh_log_slots       = specialized->log_slots;
-        tc->cur_frame->spesh_cand            = specialized;
-        tc->cur_frame->spesh_log_idx         = 0;
-        specialized->log_enter_idx           = 1;
-
-        /* Work out deopt index that applies, and move interpreter into the
-         * logging version of the code. */
-        osr_index = get_osr_deopt_index(tc, specialized);
-        *(tc->interp_bytecode_start) = specialized->bytecode;
-        *(tc->interp_cur_op)         = specialized->bytecode +
-                                       specialized->deopts[2 * osr_index + 1] +
-                                       2; /* Pass over sp_osrfianlize this first time */;
-    }
-}
-
-/* Finalizes OSR. */
-void MVM_spesh_osr_finalize(MVMThreadContext *tc) {
-    /* Find deopt index using existing deopt table, for entering the updated
-     * code later. */
-    MVMSpeshCandidate *specialized = tc->cur_frame->spesh_cand;
-    MVMint32 osr_index = get_osr_deopt_finalize_index(tc, specialized);
+/* Moves the current frame, which is running either the unspecialized code or
+ * the logging version of it, into a finished specialization, resuming at the
+ * OSR point with the given deopt index. */
+static void enter_specialized(MVMThreadContext *tc, MVMSpeshCandidate *specialized,
+                              MVMint32 osr_index) {
     MVMJitCode *jc;
-    /* Finish up the specialization. */
-    MVM_spesh_candidate_specialize(tc, tc->cur_frame->static_info, specialized);
 
     /* Resize work area if needed. */
     if (specialized->num_locals > tc->cur_frame->static_info->body.num_locals) {
@@ -113,6 +77,7 @@ void MVM_spesh_osr_finalize(MVMThreadContext *tc) {
     tc->cur_frame->effective_bytecode    = specialized->bytecode;
     tc->cur_frame->effective_handlers    = specialized->handlers;
     tc->cur_frame->effective_spesh_slots = specialized->spesh_slots;
+    tc->cur_frame->spesh_cand            = specialized;
     tc->cur_frame->spesh_log_slots       = NULL;
     tc->cur_frame->spesh_log_idx         = -1;
 
@@ -147,3 +112,103 @@ void MVM_spesh_osr_finalize(MVMThreadContext *tc) {
         tc->cur_frame->static_info->body.spesh_threshold;
 }
 
+/* Called when the logging runs of an OSR candidate are over, but the
+ * specialization itself is being done by the spesh worker. Moves the frame
+ * back to the unspecialized code, so it can keep running; a later OSR point
+ * will notice the finished specialization and switch to it. */
+static void hand_off(MVMThreadContext *tc, MVMSpeshCandidate *specialized,
+                     MVMint32 osr_index) {
+    MVMStaticFrame *sf = tc->cur_frame->static_info;
+
+    tc->cur_frame->effective_bytecode    = sf->body.bytecode;
+    tc->cur_frame->effective_handlers    = sf->body.handlers;
+    tc->cur_frame->effective_spesh_slots = NULL;
+    tc->cur_frame->spesh_log_slots       = NULL;
+    tc->cur_frame->spesh_cand            = NULL;
+    tc->cur_frame->spesh_log_idx         = -1;
+    tc->cur_frame->osr_counter           = 0;
+    *(tc->interp_bytecode_start) = sf->body.bytecode;
+    *(tc->interp_cur_op)         = sf->body.bytecode + specialized->deopts[2 * osr_index];
+
+    specialized->osr_logging = 0;
+    MVM_store(&(specialized->logging_done), 1);
+    MVM_spesh_worker_enqueue(tc, sf);
+}
+
+/* Called to start OSR. Switches us over to logging runs of spesh'd code, to
+ * collect extra type info. */
+void MVM_spesh_osr(MVMThreadContext *tc) {
+    MVMSpeshCandidate *specialized;
+    MVMint32 osr_index;
+
+    /* Check OSR is enabled. */
+    if (!tc->instance->spesh_osr_enabled)
+        return;
+
+    /* Ensure that we are in a position to specialize. */
+    if (!tc->cur_frame->caller)
+        return;
+    if (!tc->cur_frame->params.callsite->is_interned)
+        return;
+
+    /* If there's already a specialization for these arguments (for example,
+     * an earlier OSR of this frame handed off to the spesh worker), then
+     * switch to it if it is finished, or check back later if it isn't. */
+    specialized = MVM_spesh_candidate_find(tc, tc->cur_frame->static_info,
+        tc->cur_frame->params.callsite, tc->cur_frame->params.args);
+    if (specialized) {
+        if (specialized->sg) {
+            tc->cur_frame->osr_counter = 0;
+        }
+        else {
+            osr_index = find_osr_deopt_index(tc, specialized);
+            if (osr_index >= 0)
+                enter_specialized(tc, specialized, osr_index);
+        }
+        return;
+    }
+    if (!MVM_spesh_candidate_has_room(tc, tc->cur_frame->static_info))
+        return;
+
+    /* Produce logging spesh candidate. */
+    specialized = MVM_spesh_candidate_setup(tc, tc->cur_frame->static_info,
+        tc->cur_frame->params.callsite, tc->cur_frame->params.args, 1);
+    if (specialized) {
+        /* Set up frame to point to specialized logging code. */
+        tc->cur_frame->effective_bytecode    = specialized->bytecode;
+        tc->cur_frame->effective_handlers    = specialized->handlers;
+        tc->cur_frame->effective_spesh_slots = specialized->spesh_slots;
+        tc->cur_frame->spesh_log_slots       = specialized->log_slots;
+        tc->cur_frame->spesh_cand            = specialized;
+        tc->cur_frame->spesh_log_idx         = 0;
+        specialized->log_enter_idx           = 1;
+
+        /* Work out deopt index that applies, and move interpreter into the
+         * logging version of the code. */
+        osr_index = get_osr_deopt_index(tc, specialized);
+        *(tc->interp_bytecode_start) = specialized->bytecode;
+        *(tc->interp_cur_op)         = specialized->bytecode +
+                                       specialized->deopts[2 * osr_index + 1] +
+                                       2; /* Pass over sp_osrfianlize this first time */;
+    }
+}
+
+/* Finalizes OSR. */
+void MVM_spesh_osr_finalize(MVMThreadContext *tc) {
+    /* Find deopt index using existing deopt table, for entering the updated
+     * code later. */
+    MVMSpeshCandidate *specialized = tc->cur_frame->spesh_cand;
+    MVMint32 osr_index = get_osr_deopt_finalize_index(tc, specialized);
+
+    /* Unless we're asked to block, leave the specialization to the worker. */
+    if (!tc->instance->spesh_blocking) {
+        hand_off(tc, specialized, osr_index);
+        return;
+    }
+
+    /* Finish up the specialization, and switch to it. */
+    MVM_store(&(specialized->logging_done), 2);
+    specialized->osr_logging = 0;
+    MVM_spesh_candidate_specialize(tc, tc->cur_frame->static_info, specialized);
+    enter_specialized(tc, specialized, osr_index);
+}
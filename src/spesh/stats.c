@@ -0,0 +1,487 @@
+#include "moar.h"
+
+/* Gets the statistics for a static frame, creating them if needed. */
+static MVMSpeshStats * get_stats(MVMThreadContext *tc, MVMStaticFrame *sf) {
+    MVMSpeshStats *ss = sf->body.spesh_stats;
+    if (!ss) {
+        uv_mutex_lock(&tc->instance->mutex_spesh_install);
+        ss = sf->body.spesh_stats;
+        if (!ss) {
+            int init_stat;
+            ss = MVM_calloc(1, sizeof(MVMSpeshStats));
+            if ((init_stat = uv_mutex_init(&ss->mutex)) < 0)
+                MVM_panic(1, "Failed to initialize spesh statistics mutex: %s",
+                    uv_strerror(init_stat));
+            MVM_barrier();
+            sf->body.spesh_stats = ss;
+        }
+        uv_mutex_unlock(&tc->instance->mutex_spesh_install);
+    }
+    return ss;
+}
+
+/* Checks if an argument matches a recorded type. */
+static MVMint32 type_matches(MVMSpeshStatsType *t, MVMObject *arg) {
+    if (!arg)
+        return t->type == NULL;
+    return t->type && STABLE(t->type) == STABLE(arg) &&
+        t->concrete == (IS_CONCRETE(arg) ? 1 : 0);
+}
+
+/* Finds the statistics for a callsite, if we have any. */
+static MVMSpeshStatsByCallsite * find_by_callsite(MVMSpeshStats *ss, MVMCallsite *cs) {
+    MVMuint32 i;
+    for (i = 0; i < ss->num_by_callsite; i++)
+        if (ss->by_callsite[i].cs == cs)
+            return &ss->by_callsite[i];
+    return NULL;
+}
+
+/* Finds the logging site observations for a set of guards, if any. */
+static MVMSpeshStatsByGuards * find_by_guards(MVMSpeshStats *ss, MVMCallsite *cs,
+        MVMSpeshGuard *guards, MVMuint32 num_guards) {
+    MVMuint32 i, j;
+    for (i = 0; i < ss->num_by_guards; i++) {
+        MVMSpeshStatsByGuards *bg = &ss->by_guards[i];
+        if (bg->cs != cs || bg->num_guards != num_guards)
+            continue;
+        for (j = 0; j < num_guards; j++)
+            if (bg->guards[j].kind != guards[j].kind || bg->guards[j].slot != guards[j].slot ||
+                    bg->guards[j].match != guards[j].match)
+                break;
+        if (j == num_guards)
+            return bg;
+    }
+    return NULL;
+}
+
+/* Halves all of the call counts, throwing away anything that drops to zero.
+ * Called once the window is full, so recent calls weigh most. */
+static void decay(MVMThreadContext *tc, MVMSpeshStats *ss) {
+    MVMuint32 i, j, keep_cs, keep_type;
+    ss->hits /= 2;
+    keep_cs = 0;
+    for (i = 0; i < ss->num_by_callsite; i++) {
+        MVMSpeshStatsByCallsite *by_cs = &ss->by_callsite[i];
+        by_cs->hits /= 2;
+        keep_type = 0;
+        for (j = 0; j < by_cs->num_by_type; j++) {
+            by_cs->by_type[j].hits /= 2;
+            if (by_cs->by_type[j].hits)
+                by_cs->by_type[keep_type++] = by_cs->by_type[j];
+            else
+                MVM_free(by_cs->by_type[j].arg_types);
+        }
+        by_cs->num_by_type = keep_type;
+        if (by_cs->hits)
+            ss->by_callsite[keep_cs++] = *by_cs;
+        else
+            MVM_free(by_cs->by_type);
+    }
+    ss->num_by_callsite = keep_cs;
+}
+
+/* Records the types of the positional object arguments of a call. */
+static void record_types(MVMThreadContext *tc, MVMStaticFrame *sf,
+        MVMSpeshStatsByCallsite *by_cs, MVMRegister *args) {
+    MVMCallsite         *cs      = by_cs->cs;
+    MVMuint16            num_pos = cs->num_pos;
+    MVMSpeshStatsByType *by_type;
+    MVMuint32            i, j;
+
+    /* See if we've seen this tuple of types before. */
+    for (i = 0; i < by_cs->num_by_type; i++) {
+        MVMSpeshStatsType *arg_types = by_cs->by_type[i].arg_types;
+        for (j = 0; j < num_pos; j++)
+            if ((cs->arg_flags[j] & MVM_CALLSITE_ARG_MASK) == MVM_CALLSITE_ARG_OBJ)
+                if (!type_matches(&arg_types[j], args[j].o))
+                    break;
+        if (j == num_pos) {
+            by_cs->by_type[i].hits++;
+            return;
+        }
+    }
+
+    /* If not, add it, provided we've space. */
+    if (by_cs->num_by_type == MVM_SPESH_STATS_MAX_TYPE_TUPLES)
+        return;
+    by_cs->by_type = MVM_realloc(by_cs->by_type,
+        (by_cs->num_by_type + 1) * sizeof(MVMSpeshStatsByType));
+    by_type            = &by_cs->by_type[by_cs->num_by_type++];
+    by_type->hits      = 1;
+    by_type->arg_types = MVM_calloc(num_pos ? num_pos : 1, sizeof(MVMSpeshStatsType));
+    for (j = 0; j < num_pos; j++) {
+        MVMObject *arg = args[j].o;
+        if ((cs->arg_flags[j] & MVM_CALLSITE_ARG_MASK) == MVM_CALLSITE_ARG_OBJ && arg) {
+            by_type->arg_types[j].type     = STABLE(arg)->WHAT;
+            by_type->arg_types[j].concrete = IS_CONCRETE(arg) ? 1 : 0;
+            MVM_gc_write_barrier(tc, (MVMCollectable *)sf,
+                (MVMCollectable *)by_type->arg_types[j].type);
+        }
+    }
+}
+
+/* Records a call to the static frame. This is done for a sample of the calls
+ * that had no candidate to run. */
+void MVM_spesh_stats_record(MVMThreadContext *tc, MVMStaticFrame *sf,
+        MVMCallsite *cs, MVMRegister *args) {
+    MVMSpeshStats           *ss = get_stats(tc, sf);
+    MVMSpeshStatsByCallsite *by_cs;
+
+    uv_mutex_lock(&ss->mutex);
+    by_cs = find_by_callsite(ss, cs);
+    if (!by_cs && ss->num_by_callsite < MVM_SPESH_STATS_MAX_CALLSITES) {
+        ss->by_callsite = MVM_realloc(ss->by_callsite,
+            (ss->num_by_callsite + 1) * sizeof(MVMSpeshStatsByCallsite));
+        by_cs              = &ss->by_callsite[ss->num_by_callsite++];
+        by_cs->cs          = cs;
+        by_cs->hits        = 0;
+        by_cs->by_type     = NULL;
+        by_cs->num_by_type = 0;
+    }
+    if (by_cs) {
+        ss->hits++;
+        by_cs->hits++;
+        record_types(tc, sf, by_cs, args);
+        if (ss->hits >= MVM_SPESH_STATS_WINDOW)
+            decay(tc, ss);
+    }
+
+    uv_mutex_unlock(&ss->mutex);
+}
+
+/* Checks if an argument position is megamorphic for a callsite: that is,
+ * many types show up there and none of them in the majority of calls. We
+ * don't guard on such positions, so a single candidate can serve them all.
+ * Expects the statistics lock to be held. */
+static MVMint32 position_megamorphic(MVMSpeshStatsByCallsite *by_cs, MVMuint32 pos) {
+    MVMSpeshStatsType distinct[MVM_SPESH_STATS_MAX_TYPE_TUPLES];
+    MVMuint32         counts[MVM_SPESH_STATS_MAX_TYPE_TUPLES];
+    MVMuint32         num_distinct = 0;
+    MVMuint32         total = 0;
+    MVMuint32         top = 0;
+    MVMuint32         i, j;
+
+    for (i = 0; i < by_cs->num_by_type; i++) {
+        MVMSpeshStatsType *t = &by_cs->by_type[i].arg_types[pos];
+        for (j = 0; j < num_distinct; j++)
+            if (distinct[j].type == t->type && distinct[j].concrete == t->concrete)
+                break;
+        if (j == num_distinct) {
+            distinct[j] = *t;
+            counts[j]   = 0;
+            num_distinct++;
+        }
+        counts[j] += by_cs->by_type[i].hits;
+        total     += by_cs->by_type[i].hits;
+    }
+    for (j = 0; j < num_distinct; j++)
+        if (counts[j] > top)
+            top = counts[j];
+
+    return num_distinct >= MVM_SPESH_STATS_MEGAMORPHIC && top * 2 <= total;
+}
+
+/* Checks if an argument position is megamorphic for a callsite. */
+MVMint32 MVM_spesh_stats_is_megamorphic(MVMThreadContext *tc, MVMStaticFrame *sf,
+        MVMCallsite *cs, MVMuint32 pos) {
+    MVMSpeshStats           *ss = sf->body.spesh_stats;
+    MVMSpeshStatsByCallsite *by_cs;
+    MVMint32                 result = 0;
+    if (!ss || pos >= cs->num_pos)
+        return 0;
+    uv_mutex_lock(&ss->mutex);
+    by_cs = find_by_callsite(ss, cs);
+    if (by_cs)
+        result = position_megamorphic(by_cs, pos);
+    uv_mutex_unlock(&ss->mutex);
+    return result;
+}
+
+/* Decides whether it's worth producing a specialization for a call with the
+ * given arguments. We want enough calls recorded to trust the statistics,
+ * and the calls that a candidate guarding on these arguments would serve
+ * must not be a tiny fraction of the callsite's calls. */
+MVMint32 MVM_spesh_stats_worth_specializing(MVMThreadContext *tc, MVMStaticFrame *sf,
+        MVMCallsite *cs, MVMRegister *args) {
+    MVMSpeshStats           *ss = sf->body.spesh_stats;
+    MVMSpeshStatsByCallsite *by_cs;
+    MVMint32                 result = 0;
+
+    if (tc->instance->spesh_nodelay)
+        return 1;
+    if (!ss)
+        return 0;
+
+    uv_mutex_lock(&ss->mutex);
+    by_cs = find_by_callsite(ss, cs);
+    if (by_cs && by_cs->hits >= MVM_SPESH_STATS_MIN_HITS) {
+        MVMuint16 num_pos  = cs->num_pos;
+        MVMuint32 matching = 0;
+        MVMuint32 i, j;
+        for (i = 0; i < by_cs->num_by_type; i++) {
+            MVMSpeshStatsType *arg_types = by_cs->by_type[i].arg_types;
+            for (j = 0; j < num_pos; j++)
+                if ((cs->arg_flags[j] & MVM_CALLSITE_ARG_MASK) == MVM_CALLSITE_ARG_OBJ)
+                    if (!type_matches(&arg_types[j], args[j].o) &&
+                            !position_megamorphic(by_cs, j))
+                        break;
+            if (j == num_pos)
+                matching += by_cs->by_type[i].hits;
+        }
+        result = matching * 100 >= by_cs->hits * MVM_SPESH_STATS_RARE_PERCENT;
+    }
+    uv_mutex_unlock(&ss->mutex);
+
+    return result;
+}
+
+/* Checks if an object is something that could be invoked, and so is worth
+ * tracking by identity in the logging site's inline cache. */
+static MVMint32 is_invocable(MVMObject *obj) {
+    return IS_CONCRETE(obj) && (REPR(obj)->ID == MVM_REPR_ID_MVMCode ||
+        STABLE(obj)->invocation_spec != NULL);
+}
+
+/* Adds an observation of an object to a logging site. */
+static void add_log_observation(MVMThreadContext *tc, MVMStaticFrame *sf,
+        MVMSpeshStatsLogSite *site, MVMObject *obj) {
+    MVMuint32 concrete = IS_CONCRETE(obj) ? 1 : 0;
+    MVMuint32 i;
+
+    site->total++;
+    for (i = 0; i < site->num_types; i++) {
+        if (STABLE(site->types[i].type) == STABLE(obj) && site->types[i].concrete == concrete) {
+            site->types[i].count++;
+            break;
+        }
+    }
+    if (i == site->num_types && site->num_types < MVM_SPESH_STATS_MAX_LOG_TYPES) {
+        site->types[i].type     = STABLE(obj)->WHAT;
+        site->types[i].concrete = concrete;
+        site->types[i].count    = 1;
+        site->num_types++;
+        MVM_gc_write_barrier(tc, (MVMCollectable *)sf, (MVMCollectable *)site->types[i].type);
+    }
+
+    /* If it's a code object, count it in the inline cache. Those that don't
+     * fit are still in the total, and so count against any dominant one. */
+    if (is_invocable(obj)) {
+        for (i = 0; i < site->num_values; i++) {
+            if (site->values[i].value == obj) {
+                site->values[i].count++;
+                break;
+            }
+        }
+        if (i == site->num_values && site->num_values < MVM_SPESH_STATS_MAX_LOG_VALUES) {
+            site->values[i].value = obj;
+            site->values[i].count = 1;
+            site->num_values++;
+            MVM_gc_write_barrier(tc, (MVMCollectable *)sf, (MVMCollectable *)obj);
+        }
+    }
+
+    /* Keep the logging site within the window too. */
+    if (site->total >= MVM_SPESH_STATS_WINDOW) {
+        MVMuint32 keep = 0;
+        site->total /= 2;
+        for (i = 0; i < site->num_types; i++) {
+            site->types[i].count /= 2;
+            if (site->types[i].count)
+                site->types[keep++] = site->types[i];
+        }
+        site->num_types = keep;
+        keep = 0;
+        for (i = 0; i < site->num_values; i++) {
+            site->values[i].count /= 2;
+            if (site->values[i].count)
+                site->values[keep++] = site->values[i];
+        }
+        site->num_values = keep;
+    }
+}
+
+/* Adds the observations made by the logging runs of a candidate to the
+ * statistics, grouped under the candidate's guards. */
+void MVM_spesh_stats_add_log(MVMThreadContext *tc, MVMStaticFrame *sf,
+        MVMSpeshCandidate *cand) {
+    MVMSpeshStats         *ss = get_stats(tc, sf);
+    MVMSpeshStatsByGuards *bg;
+    MVMuint32              i, j;
+
+    if (!cand->log_slots)
+        return;
+
+    uv_mutex_lock(&ss->mutex);
+
+    bg = find_by_guards(ss, cand->cs, cand->guards, cand->num_guards);
+    if (!bg && ss->num_by_guards < MVM_SPESH_STATS_MAX_GUARD_SETS) {
+        ss->by_guards = MVM_realloc(ss->by_guards,
+            (ss->num_by_guards + 1) * sizeof(MVMSpeshStatsByGuards));
+        bg                = &ss->by_guards[ss->num_by_guards++];
+        bg->cs            = cand->cs;
+        bg->num_guards    = cand->num_guards;
+        bg->guards        = cand->num_guards
+            ? MVM_malloc(cand->num_guards * sizeof(MVMSpeshGuard))
+            : NULL;
+        for (i = 0; i < cand->num_guards; i++) {
+            bg->guards[i] = cand->guards[i];
+            MVM_gc_write_barrier(tc, (MVMCollectable *)sf, bg->guards[i].match);
+        }
+        bg->log_sites     = NULL;
+        bg->num_log_sites = 0;
+    }
+
+    if (bg) {
+        if (bg->num_log_sites < cand->num_log_slots) {
+            bg->log_sites = MVM_realloc(bg->log_sites,
+                cand->num_log_slots * sizeof(MVMSpeshStatsLogSite));
+            memset(bg->log_sites + bg->num_log_sites, 0,
+                (cand->num_log_slots - bg->num_log_sites) * sizeof(MVMSpeshStatsLogSite));
+            bg->num_log_sites = cand->num_log_slots;
+        }
+        for (i = 0; i < cand->num_log_slots; i++) {
+            for (j = 0; j < MVM_SPESH_LOG_RUNS; j++) {
+                MVMObject *obj = (MVMObject *)cand->log_slots[i * MVM_SPESH_LOG_RUNS + j];
+                if (obj)
+                    add_log_observation(tc, sf, &bg->log_sites[i], obj);
+            }
+        }
+    }
+
+    uv_mutex_unlock(&ss->mutex);
+}
+
+/* Looks at the observations made at a logging site by all logging runs of
+ * candidates with the same guards as the graph. If one type dominates, it
+ * is written into type and concrete, and 1 is returned; if none does, the
+ * site is considered polymorphic and 0 is returned. If there are no
+ * statistics for the site, -1 is returned. */
+MVMint32 MVM_spesh_stats_log_site_dominant(MVMThreadContext *tc, MVMSpeshGraph *g,
+        MVMuint32 slot, MVMObject **type, MVMuint32 *concrete) {
+    MVMSpeshStats         *ss = g->sf->body.spesh_stats;
+    MVMSpeshStatsByGuards *bg;
+    MVMint32               result = -1;
+    if (!ss)
+        return -1;
+    uv_mutex_lock(&ss->mutex);
+    bg = find_by_guards(ss, g->cs, g->arg_guards, g->num_arg_guards);
+    if (bg && slot < bg->num_log_sites && bg->log_sites[slot].total) {
+        MVMSpeshStatsLogSite *site = &bg->log_sites[slot];
+        MVMuint32 i;
+        result = 0;
+        for (i = 0; i < site->num_types; i++) {
+            if (site->types[i].count * 100 >= site->total * MVM_SPESH_STATS_GUARD_PERCENT) {
+                *type     = site->types[i].type;
+                *concrete = site->types[i].concrete;
+                result    = 1;
+                break;
+            }
+        }
+    }
+    uv_mutex_unlock(&ss->mutex);
+    return result;
+}
+
+/* Looks at the code objects seen at a logging site by all logging runs of
+ * candidates with the same guards as the graph. If one of them dominates,
+ * so calls made with it are monomorphic, it is written into value and 1 is
+ * returned. If none does, 0 is returned, and if there are no statistics
+ * for the site, -1 is returned. */
+MVMint32 MVM_spesh_stats_log_site_dominant_value(MVMThreadContext *tc, MVMSpeshGraph *g,
+        MVMuint32 slot, MVMObject **value) {
+    MVMSpeshStats         *ss = g->sf->body.spesh_stats;
+    MVMSpeshStatsByGuards *bg;
+    MVMint32               result = -1;
+    if (!ss)
+        return -1;
+    uv_mutex_lock(&ss->mutex);
+    bg = find_by_guards(ss, g->cs, g->arg_guards, g->num_arg_guards);
+    if (bg && slot < bg->num_log_sites && bg->log_sites[slot].total) {
+        MVMSpeshStatsLogSite *site = &bg->log_sites[slot];
+        MVMuint32 i;
+        result = 0;
+        for (i = 0; i < site->num_values; i++) {
+            if (site->values[i].count * 100 >= site->total * MVM_SPESH_STATS_GUARD_PERCENT) {
+                *value = site->values[i].value;
+                result = 1;
+                break;
+            }
+        }
+    }
+    uv_mutex_unlock(&ss->mutex);
+    return result;
+}
+
+/* Marks the types and code objects held in the statistics. */
+void MVM_spesh_stats_gc_mark(MVMThreadContext *tc, MVMSpeshStats *ss, MVMGCWorklist *worklist) {
+    MVMuint32 i, j, k;
+    for (i = 0; i < ss->num_by_callsite; i++) {
+        MVMSpeshStatsByCallsite *by_cs = &ss->by_callsite[i];
+        for (j = 0; j < by_cs->num_by_type; j++)
+            for (k = 0; k < by_cs->cs->num_pos; k++)
+                MVM_gc_worklist_add(tc, worklist, &(by_cs->by_type[j].arg_types[k].type));
+    }
+    for (i = 0; i < ss->num_by_guards; i++) {
+        MVMSpeshStatsByGuards *bg = &ss->by_guards[i];
+        for (j = 0; j < bg->num_guards; j++)
+            MVM_gc_worklist_add(tc, worklist, &(bg->guards[j].match));
+        for (j = 0; j < bg->num_log_sites; j++) {
+            MVMSpeshStatsLogSite *site = &bg->log_sites[j];
+            for (k = 0; k < site->num_types; k++)
+                MVM_gc_worklist_add(tc, worklist, &(site->types[k].type));
+            for (k = 0; k < site->num_values; k++)
+                MVM_gc_worklist_add(tc, worklist, &(site->values[k].value));
+        }
+    }
+}
+
+/* Describes the references held by the statistics for heap snapshots. */
+void MVM_spesh_stats_gc_describe(MVMThreadContext *tc, MVMHeapSnapshotState *snapshot,
+        MVMSpeshStats *ss) {
+    MVMuint32 i, j, k;
+    for (i = 0; i < ss->num_by_callsite; i++) {
+        MVMSpeshStatsByCallsite *by_cs = &ss->by_callsite[i];
+        for (j = 0; j < by_cs->num_by_type; j++)
+            for (k = 0; k < by_cs->cs->num_pos; k++)
+                MVM_profile_heap_add_collectable_rel_const_cstr(tc, snapshot,
+                    (MVMCollectable *)by_cs->by_type[j].arg_types[k].type,
+                    "Spesh statistics argument type");
+    }
+    for (i = 0; i < ss->num_by_guards; i++) {
+        MVMSpeshStatsByGuards *bg = &ss->by_guards[i];
+        for (j = 0; j < bg->num_guards; j++)
+            MVM_profile_heap_add_collectable_rel_const_cstr(tc, snapshot,
+                (MVMCollectable *)bg->guards[j].match,
+                "Spesh statistics guard match");
+        for (j = 0; j < bg->num_log_sites; j++) {
+            MVMSpeshStatsLogSite *site = &bg->log_sites[j];
+            for (k = 0; k < site->num_types; k++)
+                MVM_profile_heap_add_collectable_rel_const_cstr(tc, snapshot,
+                    (MVMCollectable *)site->types[k].type,
+                    "Spesh statistics logged type");
+            for (k = 0; k < site->num_values; k++)
+                MVM_profile_heap_add_collectable_rel_const_cstr(tc, snapshot,
+                    (MVMCollectable *)site->values[k].value,
+                    "Spesh statistics logged code object");
+        }
+    }
+}
+
+/* Frees the statistics. */
+void MVM_spesh_stats_destroy(MVMThreadContext *tc, MVMSpeshStats *ss) {
+    MVMuint32 i, j;
+    for (i = 0; i < ss->num_by_callsite; i++) {
+        for (j = 0; j < ss->by_callsite[i].num_by_type; j++)
+            MVM_free(ss->by_callsite[i].by_type[j].arg_types);
+        MVM_free(ss->by_callsite[i].by_type);
+    }
+    MVM_free(ss->by_callsite);
+    for (i = 0; i < ss->num_by_guards; i++) {
+        MVM_free(ss->by_guards[i].guards);
+        MVM_free(ss->by_guards[i].log_sites);
+    }
+    MVM_free(ss->by_guards);
+    uv_mutex_destroy(&ss->mutex);
+    MVM_free(ss);
+}
@@ -0,0 +1,142 @@
+/* Number of recorded calls after which counts are halved. */
+#define MVM_SPESH_STATS_WINDOW          1024
+
+/* Only one in this many calls without a candidate to run is recorded. */
+#define MVM_SPESH_STATS_SAMPLE_INTERVAL 4
+
+/* Number of recorded calls with a callsite before we trust the statistics
+ * enough to produce a specialization for it. */
+#define MVM_SPESH_STATS_MIN_HITS        16
+
+/* Limits on how much we keep track of. */
+#define MVM_SPESH_STATS_MAX_CALLSITES   8
+#define MVM_SPESH_STATS_MAX_TYPE_TUPLES 16
+#define MVM_SPESH_STATS_MAX_GUARD_SETS  16
+#define MVM_SPESH_STATS_MAX_LOG_TYPES   4
+#define MVM_SPESH_STATS_MAX_LOG_VALUES  4
+
+/* Number of distinct types at an argument position, none of them seen in
+ * the majority of calls, that makes us consider the position megamorphic
+ * and not guard on it. */
+#define MVM_SPESH_STATS_MEGAMORPHIC     4
+
+/* Percentage of a callsite's calls below which a tuple of argument types
+ * is considered too rare to produce a specialization for. */
+#define MVM_SPESH_STATS_RARE_PERCENT    5
+
+/* Percentage of observations a type must account for at a logging site to
+ * be guarded on. */
+#define MVM_SPESH_STATS_GUARD_PERCENT   90
+
+/* Statistics about how a static frame is being used, aggregated over calls
+ * made by all threads. They are used to decide which arguments are worth
+ * guarding on when producing a specialization, whether a given set of
+ * argument types is common enough to deserve a candidate of its own, and
+ * which types seen at logging sites are stable enough to guard on. */
+struct MVMSpeshStats {
+    /* Number of calls recorded in the current window. When it reaches the
+     * window size, all of the counts are halved, so that old observations
+     * fade out and the statistics follow changes in the workload. */
+    MVMuint32 hits;
+
+    /* Statistics for each callsite shape the frame was called with. */
+    MVMSpeshStatsByCallsite *by_callsite;
+    MVMuint32 num_by_callsite;
+
+    /* Types observed at logging sites, grouped by the argument guards of
+     * the candidates whose logging runs made the observations. */
+    MVMSpeshStatsByGuards *by_guards;
+    MVMuint32 num_by_guards;
+
+    /* Lock protecting the statistics. Calls are only recorded now and then,
+     * so it's rarely contended. */
+    uv_mutex_t mutex;
+};
+
+/* Statistics for a particular callsite shape. */
+struct MVMSpeshStatsByCallsite {
+    /* The callsite. */
+    MVMCallsite *cs;
+
+    /* Number of recorded calls with this callsite. */
+    MVMuint32 hits;
+
+    /* Counts for each tuple of positional argument types seen. */
+    MVMSpeshStatsByType *by_type;
+    MVMuint32 num_by_type;
+};
+
+/* Counts for a particular tuple of positional argument types. */
+struct MVMSpeshStatsByType {
+    /* One entry per positional argument of the callsite; type is NULL for
+     * native arguments. */
+    MVMSpeshStatsType *arg_types;
+
+    /* Number of recorded calls with these types. */
+    MVMuint32 hits;
+};
+
+/* A type along with whether it was a concrete object or a type object. */
+struct MVMSpeshStatsType {
+    MVMObject *type;
+    MVMuint32  concrete;
+};
+
+/* Logging site observations for candidates with a given set of guards. */
+struct MVMSpeshStatsByGuards {
+    /* The callsite and guards of the candidates. */
+    MVMCallsite   *cs;
+    MVMSpeshGuard *guards;
+    MVMuint32      num_guards;
+
+    /* Observations per logging site, indexed by log slot. Logging sites are
+     * inserted in a fixed order determined by the original bytecode, so the
+     * indexes are the same for every candidate of the static frame. */
+    MVMSpeshStatsLogSite *log_sites;
+    MVMuint32             num_log_sites;
+};
+
+/* A type seen at a logging site, and how often. */
+struct MVMSpeshStatsTypeCount {
+    MVMObject *type;
+    MVMuint32  concrete;
+    MVMuint32  count;
+};
+
+/* A code object seen at a logging site, and how often. */
+struct MVMSpeshStatsValueCount {
+    MVMObject *value;
+    MVMuint32  count;
+};
+
+/* The types and code objects seen at a logging site. */
+struct MVMSpeshStatsLogSite {
+    MVMSpeshStatsTypeCount types[MVM_SPESH_STATS_MAX_LOG_TYPES];
+    MVMuint32 num_types;
+
+    /* An inline cache of the code objects seen at the site, so we can tell
+     * if calls made with what it produces are monomorphic, polymorphic, or
+     * (once it overflows) megamorphic. */
+    MVMSpeshStatsValueCount values[MVM_SPESH_STATS_MAX_LOG_VALUES];
+    MVMuint32 num_values;
+
+    /* Total observations, including those of types that didn't fit. */
+    MVMuint32 total;
+};
+
+void MVM_spesh_stats_record(MVMThreadContext *tc, MVMStaticFrame *sf,
+    MVMCallsite *cs, MVMRegister *args);
+MVMint32 MVM_spesh_stats_worth_specializing(MVMThreadContext *tc, MVMStaticFrame *sf,
+    MVMCallsite *cs, MVMRegister *args);
+MVMint32 MVM_spesh_stats_is_megamorphic(MVMThreadContext *tc, MVMStaticFrame *sf,
+    MVMCallsite *cs, MVMuint32 pos);
+void MVM_spesh_stats_add_log(MVMThreadContext *tc, MVMStaticFrame *sf,
+    MVMSpeshCandidate *cand);
+MVMint32 MVM_spesh_stats_log_site_dominant(MVMThreadContext *tc, MVMSpeshGraph *g,
+    MVMuint32 slot, MVMObject **type, MVMuint32 *concrete);
+MVMint32 MVM_spesh_stats_log_site_dominant_value(MVMThreadContext *tc, MVMSpeshGraph *g,
+    MVMuint32 slot, MVMObject **value);
+void MVM_spesh_stats_gc_mark(MVMThreadContext *tc, MVMSpeshStats *ss, MVMGCWorklist *worklist);
+void MVM_spesh_stats_gc_describe(MVMThreadContext *tc, MVMHeapSnapshotState *snapshot,
+    MVMSpeshStats *ss);
+void MVM_spesh_stats_destroy(MVMThreadContext *tc, MVMSpeshStats *ss);
@@ -0,0 +1,77 @@
+#include "moar.h"
+
+/* Producing a specialization involves fact discovery, optimization, code
+ * generation and JIT compilation, which together can take a good while for
+ * a large frame. Rather than have an interpreter thread do this work when it
+ * happens to make the last logged exit, we hand it to a background worker
+ * thread. The interpreter threads only push the static frame onto a queue;
+ * the worker takes items off it, specializes any candidates that have
+ * finished logging, and installs the result. The candidate stays unusable
+ * (its sg is set) until the worker is done, so interpreter threads simply
+ * keep running the unspecialized code until then. */
+
+/* Specializes all candidates of the static frame that have completed their
+ * logging runs and are waiting for specialization. A candidate is claimed
+ * by flipping its logging_done flag from 1 to 2, so that it will only be
+ * specialized once even if the frame is queued more than once. */
+void MVM_spesh_worker_specialize_ready(MVMThreadContext *tc, MVMStaticFrame *sf) {
+    MVMROOT(tc, sf, {
+        MVMuint32 i;
+        for (i = 0; i < sf->body.num_spesh_candidates; i++) {
+            MVMSpeshCandidate *cand = sf->body.spesh_candidates[i];
+            if (cand->sg && MVM_cas(&(cand->logging_done), 1, 2) == 1)
+                MVM_spesh_candidate_specialize(tc, sf, cand);
+        }
+    });
+}
+
+/* The entry point of the worker thread. Takes static frames off the queue
+ * forever; shifting from the queue marks us as blocked for GC purposes, so
+ * an idle worker never holds up a collection. */
+static void worker(MVMThreadContext *tc, MVMCallsite *callsite, MVMRegister *args) {
+    while (1) {
+        MVMObject *sf = MVM_repr_shift_o(tc, tc->instance->spesh_queue);
+        MVM_spesh_worker_specialize_ready(tc, (MVMStaticFrame *)sf);
+    }
+}
+
+/* Starts the worker thread if it isn't already running. */
+static void get_or_vivify_worker(MVMThreadContext *tc) {
+    MVMInstance *instance = tc->instance;
+
+    if (!instance->spesh_worker_thread) {
+        MVM_gc_mark_thread_blocked(tc);
+        uv_mutex_lock(&instance->mutex_spesh_worker_start);
+        MVM_gc_mark_thread_unblocked(tc);
+        if (!instance->spesh_worker_thread) {
+            MVMObject *thread, *worker_entry_point;
+
+            instance->spesh_queue = MVM_repr_alloc_init(tc,
+                instance->boot_types.BOOTQueue);
+            worker_entry_point = MVM_repr_alloc_init(tc,
+                instance->boot_types.BOOTCCode);
+            ((MVMCFunction *)worker_entry_point)->body.func = worker;
+            thread = MVM_thread_new(tc, worker_entry_point, 1);
+            MVMROOT(tc, thread, {
+                MVM_thread_run(tc, thread);
+                instance->spesh_worker_thread = ((MVMThread *)thread)->body.tc;
+            });
+        }
+        uv_mutex_unlock(&instance->mutex_spesh_worker_start);
+    }
+}
+
+/* Hands a static frame with a candidate that has finished logging over to
+ * the worker. If background specialization is disabled, does the work right
+ * away on the current thread instead. */
+void MVM_spesh_worker_enqueue(MVMThreadContext *tc, MVMStaticFrame *sf) {
+    if (tc->instance->spesh_blocking) {
+        MVM_spesh_worker_specialize_ready(tc, sf);
+    }
+    else {
+        MVMROOT(tc, sf, {
+            get_or_vivify_worker(tc);
+            MVM_repr_push_o(tc, tc->instance->spesh_queue, (MVMObject *)sf);
+        });
+    }
+}
@@ -0,0 +1,4 @@
+/* Functions for handing specialization work to the background spesh worker
+ * thread. */
+void MVM_spesh_worker_enqueue(MVMThreadContext *tc, MVMStaticFrame *sf);
+void MVM_spesh_worker_specialize_ready(MVMThreadContext *tc, MVMStaticFrame *sf);
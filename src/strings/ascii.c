@@ -4,24 +4,44 @@
  * a result of the specified type. The type must have the MVMString REPR. */
 MVMString * MVM_string_ascii_decode(MVMThreadContext *tc, const MVMObject *result_type, const char *ascii, size_t bytes) {
     MVMString *result = (MVMString *)REPR(result_type)->allocate(tc, STABLE(result_type));
-    size_t i, result_graphs;
+    size_t i, k, result_graphs;
 
-    result->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    result->body.storage.blob_32 = MVM_malloc(sizeof(MVMGrapheme32) * bytes);
+    MVMuint8 writing_32bit = 0;
+
+    result->body.storage_type   = MVM_STRING_GRAPHEME_8;
+    result->body.storage.blob_8 = MVM_malloc(sizeof(MVMGrapheme8) * bytes);
 
     result_graphs = 0;
     for (i = 0; i < bytes; i++) {
+        MVMGrapheme32 g;
         if (ascii[i] == '\r' && i + 1 < bytes && ascii[i + 1] == '\n') {
-            result->body.storage.blob_32[result_graphs++] = MVM_nfg_crlf_grapheme(tc);
+            g = MVM_nfg_crlf_grapheme(tc);
             i++;
         }
         else if (ascii[i] >= 0) {
-            result->body.storage.blob_32[result_graphs++] = ascii[i];
+            g = ascii[i];
         }
         else {
             MVM_exception_throw_adhoc(tc,
                 "Will not decode invalid ASCII (code point > 127 found)");
         }
+
+        /* Only a synthetic for \r\n can fail to fit into 8 bits. */
+        if (g < -128 && !writing_32bit) {
+            MVMGrapheme8 *old_storage = result->body.storage.blob_8;
+
+            result->body.storage.blob_32 = MVM_malloc(sizeof(MVMGrapheme32) * bytes);
+            result->body.storage_type = MVM_STRING_GRAPHEME_32;
+            writing_32bit = 1;
+
+            for (k = 0; k < result_graphs; k++)
+                result->body.storage.blob_32[k] = old_storage[k];
+            MVM_free(old_storage);
+        }
+        if (writing_32bit)
+            result->body.storage.blob_32[result_graphs++] = g;
+        else
+            result->body.storage.blob_8[result_graphs++] = g;
     }
     result->body.num_graphs = result_graphs;
 
@@ -149,6 +169,14 @@ char * MVM_string_ascii_encode_substr(MVMThreadContext *tc, MVMString *str, MVMu
     if (length < -1 || start + lengthu > strgraphs)
         MVM_exception_throw_adhoc(tc, "length out of range");
 
+    /* If the whole string is ASCII, copy it over strand by strand. */
+    if (start == 0 && lengthu == strgraphs) {
+        char *bulk = MVM_string_encode_bulk_single_byte(tc, str, output_size,
+            127, translate_newlines);
+        if (bulk)
+            return bulk;
+    }
+
     if (replacement)
         repl_bytes = (MVMuint8 *) MVM_string_ascii_encode_substr(tc, replacement,
             &repl_length, 0, -1, NULL, translate_newlines);
@@ -191,6 +191,7 @@ static MVMString * take_chars(MVMThreadContext *tc, MVMDecodeStream *ds, MVMint3
             ds->chars_head_pos += take;
         }
     }
+    MVM_string_shrink_to_8bit(tc, result);
     return result;
 }
 MVMString * MVM_string_decodestream_get_chars(MVMThreadContext *tc, MVMDecodeStream *ds, MVMint32 chars) {
@@ -403,6 +404,7 @@ static MVMString * get_all_in_buffer(MVMThreadContext *tc, MVMDecodeStream *ds)
         ds->chars_head = ds->chars_tail = NULL;
     }
 
+    MVM_string_shrink_to_8bit(tc, result);
     return result;
 }
 
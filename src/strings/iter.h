@@ -27,6 +27,23 @@ struct MVMGraphemeIter {
     MVMStringStrand *next_strand;
 };
 
+/* Gets the strands of a string, for code that wants to work on its storage a
+ * strand at a time. A flat string is treated as a single strand, which is set
+ * up in the one passed in. Returns the number of strands. */
+MVM_STATIC_INLINE MVMuint16 MVM_string_flat_strands(MVMThreadContext *tc, MVMString *s,
+        MVMStringStrand *single, MVMStringStrand **strands) {
+    if (s->body.storage_type == MVM_STRING_STRAND) {
+        *strands = s->body.storage.strands;
+        return s->body.num_strands;
+    }
+    single->blob_string = s;
+    single->start       = 0;
+    single->end         = s->body.num_graphs;
+    single->repetitions = 0;
+    *strands = single;
+    return 1;
+}
+
 /* Initializes a grapheme iterator. */
 MVM_STATIC_INLINE void MVM_string_gi_init(MVMThreadContext *tc, MVMGraphemeIter *gi, MVMString *s) {
     if (s->body.storage_type == MVM_STRING_STRAND) {
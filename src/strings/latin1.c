@@ -16,30 +16,32 @@ MVMString * MVM_string_latin1_decode(MVMThreadContext *tc, const MVMObject *resu
 
     result_graphs = 0;
     for (i = 0; i < bytes; i++) {
+        MVMGrapheme32 g;
         if (latin1[i] == '\r' && i + 1 < bytes && latin1[i + 1] == '\n') {
-            if (writing_32bit)
-                result->body.storage.blob_32[result_graphs++] = MVM_nfg_crlf_grapheme(tc);
-            else
-                result->body.storage.blob_8[result_graphs++] = MVM_nfg_crlf_grapheme(tc);
+            g = MVM_nfg_crlf_grapheme(tc);
             i++;
         }
         else {
-            if (latin1[i] > 127 && !writing_32bit) {
-                MVMGrapheme8 *old_storage = result->body.storage.blob_8;
+            g = latin1[i];
+        }
 
-                result->body.storage.blob_32 = MVM_malloc(sizeof(MVMGrapheme32) * bytes);
-                result->body.storage_type = MVM_STRING_GRAPHEME_32;
-                writing_32bit = 1;
+        /* Anything outside of the signed 8-bit range (including a synthetic
+         * for \r\n that came late) needs 32-bit storage. */
+        if ((g > 127 || g < -128) && !writing_32bit) {
+            MVMGrapheme8 *old_storage = result->body.storage.blob_8;
 
-                for (k = 0; k < i; k++)
-                    result->body.storage.blob_32[k] = old_storage[k];
-                MVM_free(old_storage);
-            }
-            if (writing_32bit)
-                result->body.storage.blob_32[result_graphs++] = latin1[i];
-            else
-                result->body.storage.blob_8[result_graphs++] = latin1[i];
+            result->body.storage.blob_32 = MVM_malloc(sizeof(MVMGrapheme32) * bytes);
+            result->body.storage_type = MVM_STRING_GRAPHEME_32;
+            writing_32bit = 1;
+
+            for (k = 0; k < result_graphs; k++)
+                result->body.storage.blob_32[k] = old_storage[k];
+            MVM_free(old_storage);
         }
+        if (writing_32bit)
+            result->body.storage.blob_32[result_graphs++] = g;
+        else
+            result->body.storage.blob_8[result_graphs++] = g;
     }
     result->body.num_graphs = result_graphs;
 
@@ -158,6 +160,15 @@ char * MVM_string_latin1_encode_substr(MVMThreadContext *tc, MVMString *str, MVM
     if (length < -1 || start + lengthu > strgraphs)
         MVM_exception_throw_adhoc(tc, "length out of range");
 
+    /* If the whole string is in the Latin-1 range, copy it over strand by
+     * strand. */
+    if (start == 0 && lengthu == strgraphs) {
+        char *bulk = MVM_string_encode_bulk_single_byte(tc, str, output_size,
+            255, translate_newlines);
+        if (bulk)
+            return bulk;
+    }
+
     if (replacement)
         repl_bytes = (MVMuint8 *) MVM_string_latin1_encode_substr(tc,
             replacement, &repl_length, 0, -1, NULL, translate_newlines);
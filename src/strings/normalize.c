@@ -77,9 +77,7 @@ void MVM_unicode_normalize_codepoints(MVMThreadContext *tc, const MVMObject *in,
     MVM_unicode_normalizer_cleanup(tc, &norm);
 
     /* Put result into array body. */
-    ((MVMArray *)out)->body.slots.u32 = (MVMuint32 *) result;
-    ((MVMArray *)out)->body.start     = 0;
-    ((MVMArray *)out)->body.elems     = result_pos;
+    MVM_array_set_malloced_slots(tc, out, result, result_pos, result_alloc);
 }
 MVMString * MVM_unicode_codepoints_c_array_to_nfg_string(MVMThreadContext *tc, MVMCodepoint * cp_v, MVMint64 cp_count) {
     MVMNormalizer  norm;
@@ -188,9 +186,7 @@ void MVM_unicode_string_to_codepoints(MVMThreadContext *tc, MVMString *s, MVMNor
     }
 
     /* Put result into array body. */
-    ((MVMArray *)out)->body.slots.u32 = (MVMuint32 *)result;
-    ((MVMArray *)out)->body.start     = 0;
-    ((MVMArray *)out)->body.elems     = result_pos;
+    MVM_array_set_malloced_slots(tc, out, result, result_pos, result_alloc);
 }
 
 /* Initialize the MVMNormalizer pointed to to perform the specified kind of
@@ -2,6 +2,11 @@
 #include "moar.h"
 #define MVM_DEBUG_STRANDS 0
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MVM_STRING_SSE2 1
+#endif
+
 #if MVM_DEBUG_STRANDS
 static void check_strand_sanity(MVMThreadContext *tc, MVMString *s) {
     MVMGraphemeIter gi;
@@ -59,6 +64,18 @@ static void turn_32bit_into_8bit_unchecked(MVMThreadContext *tc, MVMString *str)
     MVM_free(old_buf);
 }
 
+/* If a string using 32bit storage only has graphemes that fit into 8 bits,
+ * switches it to 8 bit storage, which takes a quarter of the memory. */
+void MVM_string_shrink_to_8bit(MVMThreadContext *tc, MVMString *str) {
+    MVMStringIndex i;
+    if (str->body.storage_type != MVM_STRING_GRAPHEME_32 || !str->body.num_graphs)
+        return;
+    for (i = 0; i < str->body.num_graphs; i++)
+        if (!can_fit_into_8bit(str->body.storage.blob_32[i]))
+            return;
+    turn_32bit_into_8bit_unchecked(tc, str);
+}
+
 /* Collapses a bunch of strands into a single blob string. */
 static MVMString * collapse_strands(MVMThreadContext *tc, MVMString *orig) {
     MVMString       *result;
@@ -144,6 +161,7 @@ static MVMString * re_nfg(MVMThreadContext *tc, MVMString *in) {
     out->body.storage.blob_32 = out_buffer;
     out->body.storage_type    = MVM_STRING_GRAPHEME_32;
     out->body.num_graphs      = out_pos;
+    MVM_string_shrink_to_8bit(tc, out);
     return out;
 }
 
@@ -154,7 +172,7 @@ MVMint64 MVM_string_substrings_equal_nocheck(MVMThreadContext *tc, MVMString *a,
     MVMGraphemeIter gib;
     MVMint64 i;
 
-    /* Fast paths when storage types are identical. */
+    /* Fast paths for flat strings. */
     switch (a->body.storage_type) {
     case MVM_STRING_GRAPHEME_32:
         if (b->body.storage_type == MVM_STRING_GRAPHEME_32)
@@ -162,6 +180,12 @@ MVMint64 MVM_string_substrings_equal_nocheck(MVMThreadContext *tc, MVMString *a,
                 a->body.storage.blob_32 + starta,
                 b->body.storage.blob_32 + startb,
                 length * sizeof(MVMGrapheme32));
+        if (b->body.storage_type == MVM_STRING_GRAPHEME_8) {
+            for (i = 0; i < length; i++)
+                if (a->body.storage.blob_32[starta + i] != b->body.storage.blob_8[startb + i])
+                    return 0;
+            return 1;
+        }
         break;
     case MVM_STRING_GRAPHEME_ASCII:
     case MVM_STRING_GRAPHEME_8:
@@ -171,6 +195,12 @@ MVMint64 MVM_string_substrings_equal_nocheck(MVMThreadContext *tc, MVMString *a,
                 a->body.storage.blob_8 + starta,
                 b->body.storage.blob_8 + startb,
                 length);
+        if (b->body.storage_type == MVM_STRING_GRAPHEME_32) {
+            for (i = 0; i < length; i++)
+                if (a->body.storage.blob_8[starta + i] != b->body.storage.blob_32[startb + i])
+                    return 0;
+            return 1;
+        }
         break;
     }
 
@@ -205,9 +235,136 @@ MVMGrapheme32 MVM_string_get_grapheme_at_nocheck(MVMThreadContext *tc, MVMString
     }
 }
 
+/* Random access to the graphemes of a string that is being searched. That is
+ * cheap for flat strings; for strands, we remember the strand we last looked
+ * in, so that looking near it again (as searches do) is cheap too. */
+typedef struct {
+    /* The strands of the string (a flat string is a single strand). */
+    MVMStringStrand *strands;
+    MVMStringStrand  single;
+    MVMuint16        num_strands;
+
+    /* The strand we last looked in, the position in the string that it
+     * starts at, and the number of graphemes in it (with repetitions). */
+    MVMuint16        strand;
+    MVMStringIndex   strand_pos;
+    MVMStringIndex   strand_graphs;
+} MVMGraphemeSeeker;
+MVM_STATIC_INLINE MVMStringIndex strand_graphs(const MVMStringStrand *strand) {
+    return (strand->end - strand->start) * (strand->repetitions + 1);
+}
+static void seeker_init(MVMThreadContext *tc, MVMGraphemeSeeker *gs, MVMString *s) {
+    gs->num_strands   = MVM_string_flat_strands(tc, s, &(gs->single), &(gs->strands));
+    gs->strand        = 0;
+    gs->strand_pos    = 0;
+    gs->strand_graphs = strand_graphs(&(gs->strands[0]));
+}
+MVM_STATIC_INLINE MVMGrapheme32 seeker_get(MVMThreadContext *tc, MVMGraphemeSeeker *gs, MVMStringIndex pos) {
+    MVMStringStrand *strand;
+    MVMStringIndex   offset;
+    while (pos < gs->strand_pos) {
+        gs->strand--;
+        gs->strand_graphs = strand_graphs(&(gs->strands[gs->strand]));
+        gs->strand_pos   -= gs->strand_graphs;
+    }
+    while (pos - gs->strand_pos >= gs->strand_graphs) {
+        gs->strand_pos   += gs->strand_graphs;
+        gs->strand++;
+        gs->strand_graphs = strand_graphs(&(gs->strands[gs->strand]));
+    }
+    strand = &(gs->strands[gs->strand]);
+    offset = pos - gs->strand_pos;
+    if (strand->repetitions)
+        offset %= strand->end - strand->start;
+    offset += strand->start;
+    return strand->blob_string->body.storage_type == MVM_STRING_GRAPHEME_32
+        ? strand->blob_string->body.storage.blob_32[offset]
+        : strand->blob_string->body.storage.blob_8[offset];
+}
+
+/* Copies the graphemes of a string into a new 32-bit buffer, which the
+ * caller must free. */
+static MVMGrapheme32 * flat_graphemes(MVMThreadContext *tc, MVMString *s, MVMStringIndex graphs) {
+    MVMGrapheme32 *result = MVM_malloc(graphs * sizeof(MVMGrapheme32));
+    if (s->body.storage_type == MVM_STRING_GRAPHEME_32) {
+        memcpy(result, s->body.storage.blob_32, graphs * sizeof(MVMGrapheme32));
+    }
+    else {
+        MVMGraphemeIter gi;
+        MVMStringIndex  i;
+        MVM_string_gi_init(tc, &gi, s);
+        for (i = 0; i < graphs; i++)
+            result[i] = MVM_string_gi_get_grapheme(tc, &gi);
+    }
+    return result;
+}
+
+/* Searches for a needle in a haystack with Boyer-Moore-Horspool, from the
+ * start position forwards, or (if backwards is set) from the start position
+ * backwards. Works for any storage the strings have. The shift table is
+ * indexed by the low byte of graphemes; two graphemes sharing one just get
+ * the shorter of their shifts. Returns the position of the match, or -1. */
+static MVMint64 index_bmh(MVMThreadContext *tc, MVMString *Haystack, MVMString *needle,
+                          MVMint64 start, MVMint32 backwards) {
+    MVMStringIndex     H_graphs = MVM_string_graphs_nocheck(tc, Haystack);
+    MVMStringIndex     n_graphs = MVM_string_graphs_nocheck(tc, needle);
+    MVMStringIndex     last     = n_graphs - 1;
+    MVMGrapheme32     *n        = flat_graphemes(tc, needle, n_graphs);
+    MVMStringIndex     shifts[256];
+    MVMGraphemeSeeker  H_seeker;
+    MVMint64           pos      = start;
+    MVMint64           result   = -1;
+    MVMStringIndex     i;
+
+    for (i = 0; i < 256; i++)
+        shifts[i] = n_graphs;
+    seeker_init(tc, &H_seeker, Haystack);
+
+    if (!backwards) {
+        /* Compare the last grapheme of the window first, and shift so the
+         * rightmost occurrence of it in the rest of the needle lines up. */
+        for (i = 0; i < last; i++)
+            shifts[n[i] & 0xFF] = last - i;
+        while (pos + n_graphs <= H_graphs) {
+            MVMGrapheme32 g = seeker_get(tc, &H_seeker, pos + last);
+            if (g == n[last]) {
+                i = 0;
+                while (i < last && seeker_get(tc, &H_seeker, pos + i) == n[i])
+                    i++;
+                if (i == last) {
+                    result = pos;
+                    break;
+                }
+            }
+            pos += shifts[g & 0xFF];
+        }
+    }
+    else {
+        /* The mirror image: compare the first grapheme of the window first,
+         * and shift so the leftmost occurrence of it lines up. */
+        for (i = last; i > 0; i--)
+            shifts[n[i] & 0xFF] = i;
+        while (pos >= 0) {
+            MVMGrapheme32 g = seeker_get(tc, &H_seeker, pos);
+            if (g == n[0]) {
+                i = 1;
+                while (i < n_graphs && seeker_get(tc, &H_seeker, pos + i) == n[i])
+                    i++;
+                if (i == n_graphs) {
+                    result = pos;
+                    break;
+                }
+            }
+            pos -= shifts[g & 0xFF];
+        }
+    }
+
+    MVM_free(n);
+    return result;
+}
+
 /* Returns the location of one string in another or -1  */
 MVMint64 MVM_string_index(MVMThreadContext *tc, MVMString *Haystack, MVMString *needle, MVMint64 start) {
-    size_t index           = (size_t)start;
     MVMStringIndex H_graphs = MVM_string_graphs(tc, Haystack), n_graphs = MVM_string_graphs(tc, needle);
     MVM_string_check_arg(tc, Haystack, "index search target");
     MVM_string_check_arg(tc, needle, "index search term");
@@ -268,19 +425,12 @@ MVMint64 MVM_string_index(MVMThreadContext *tc, MVMString *Haystack, MVMString *
             break;
     }
 
-    /* brute force for now. horrible, yes. halp. */
-    while (index <= H_graphs - n_graphs) {
-        if (MVM_string_substrings_equal_nocheck(tc, needle, 0, n_graphs, Haystack, index)) {
-            return (MVMint64)index;
-        }
-        index++;
-    }
-    return -1;
+    /* Otherwise, search across storage types and strands. */
+    return index_bmh(tc, Haystack, needle, start, 0);
 }
 
 /* Returns the location of one string in another or -1  */
 MVMint64 MVM_string_index_from_end(MVMThreadContext *tc, MVMString *Haystack, MVMString *needle, MVMint64 start) {
-    MVMint64 result = -1;
     size_t index;
     MVMStringIndex H_graphs, n_graphs;
 
@@ -315,14 +465,7 @@ MVMint64 MVM_string_index_from_end(MVMThreadContext *tc, MVMString *Haystack, MV
         index = H_graphs - n_graphs;
     }
 
-    /* brute force for now. horrible, yes. halp. */
-    do {
-        if (MVM_string_substrings_equal_nocheck(tc, needle, 0, n_graphs, Haystack, index)) {
-            result = (MVMint64)index;
-            break;
-        }
-    } while (index-- > 0);
-    return result;
+    return index_bmh(tc, Haystack, needle, (MVMint64)index, 1);
 }
 
 /* Returns a substring of the given string */
@@ -643,7 +786,7 @@ MVMint64 MVM_string_equal_at(MVMThreadContext *tc, MVMString *a, MVMString *b, M
 /* Ensure return value can hold numbers at least 3x higher than MVMStringIndex.
  * Theoretically if the string has all ﬃ ligatures and 1/3 the max size of
  * MVMStringIndex in length, we could have some weird results. */
-MVM_STATIC_INLINE MVMint64 string_equal_at_ignore_case_INTERNAL_loop(MVMThreadContext *tc, MVMString *Haystack, MVMString *needle_fc, MVMint64 H_start, MVMint64 H_graphs, MVMint64 n_fc_graphs) {
+MVM_STATIC_INLINE MVMint64 string_equal_at_ignore_case_INTERNAL_loop(MVMThreadContext *tc, MVMGraphemeSeeker *Haystack, const MVMGrapheme32 *needle_fc, MVMint64 H_start, MVMint64 H_graphs, MVMint64 n_fc_graphs) {
     MVMuint32 H_fc_cps;
     /* An additional needle offset which is used only when codepoints expand
      * when casefolded. The offset is the number of additional codepoints that
@@ -653,7 +796,7 @@ MVM_STATIC_INLINE MVMint64 string_equal_at_ignore_case_INTERNAL_loop(MVMThreadCo
     MVMGrapheme32 H_g, n_g;
     for (i = 0; i + H_start < H_graphs && i + n_offset < n_fc_graphs; i++) {
         const MVMCodepoint* H_result_cps;
-        H_g = MVM_string_get_grapheme_at_nocheck(tc, Haystack, H_start + i);
+        H_g = seeker_get(tc, Haystack, H_start + i);
         if (H_g >= 0 ) {
             /* For codeponits we can get the case change directly */
             H_fc_cps = MVM_unicode_get_case_change(tc, H_g, MVM_unicode_case_change_type_fold, &H_result_cps);
@@ -664,13 +807,13 @@ MVM_STATIC_INLINE MVMint64 string_equal_at_ignore_case_INTERNAL_loop(MVMThreadCo
         }
         /* If we get 0 for the number that means the cp doesn't change when casefolded */
         if (H_fc_cps == 0) {
-            n_g = MVM_string_get_grapheme_at_nocheck(tc, needle_fc, i + n_offset);
+            n_g = needle_fc[i + n_offset];
             if (H_g != n_g)
                 return -1;
         }
         else if (H_fc_cps >= 1) {
             for (j = 0; j < H_fc_cps; j++) {
-                n_g = MVM_string_get_grapheme_at_nocheck(tc, needle_fc, i + n_offset);
+                n_g = needle_fc[i + n_offset];
                 H_g = H_result_cps[j];
                 if (H_g != n_g)
                     return -1;
@@ -694,6 +837,8 @@ MVM_STATIC_INLINE MVMint64 string_equal_at_ignore_case_INTERNAL_loop(MVMThreadCo
 MVMint64 MVM_string_equal_at_ignore_case(MVMThreadContext *tc, MVMString *Haystack, MVMString *needle, MVMint64 H_offset) {
     /* Foldcase version of needle */
     MVMString *needle_fc;
+    MVMGrapheme32 *n_fc;
+    MVMGraphemeSeeker H_seeker;
     MVMStringIndex H_graphs = MVM_string_graphs(tc, Haystack);
     MVMStringIndex n_graphs = MVM_string_graphs(tc, needle);
     MVMStringIndex n_fc_graphs;
@@ -715,7 +860,10 @@ MVMint64 MVM_string_equal_at_ignore_case(MVMThreadContext *tc, MVMString *Haysta
         needle_fc = MVM_string_fc(tc, needle);
     });
     n_fc_graphs = MVM_string_graphs(tc, needle_fc);
-    H_expansion = string_equal_at_ignore_case_INTERNAL_loop(tc, Haystack, needle_fc, H_offset, H_graphs, n_fc_graphs);
+    seeker_init(tc, &H_seeker, Haystack);
+    n_fc = flat_graphemes(tc, needle_fc, n_fc_graphs);
+    H_expansion = string_equal_at_ignore_case_INTERNAL_loop(tc, &H_seeker, n_fc, H_offset, H_graphs, n_fc_graphs);
+    MVM_free(n_fc);
     if (H_expansion >= 0)
         return H_graphs + H_expansion - H_offset >= n_fc_graphs  ? 1 : 0;
     return 0;
@@ -723,6 +871,8 @@ MVMint64 MVM_string_equal_at_ignore_case(MVMThreadContext *tc, MVMString *Haysta
 MVMint64 MVM_string_index_ignore_case(MVMThreadContext *tc, MVMString *Haystack, MVMString *needle, MVMint64 start) {
     /* Foldcase version of needle */
     MVMString *needle_fc;
+    MVMGrapheme32 *n_fc;
+    MVMGraphemeSeeker H_seeker;
     MVMStringIndex n_fc_graphs;
 
     size_t index           = (size_t)start;
@@ -753,14 +903,23 @@ MVMint64 MVM_string_index_ignore_case(MVMThreadContext *tc, MVMString *Haystack,
         needle_fc = MVM_string_fc(tc, needle);
     });
     n_fc_graphs = MVM_string_graphs(tc, needle_fc);
-    /* brute force for now. horrible, yes. halp. */
-    while (index <= H_graphs) {
-        H_expansion = string_equal_at_ignore_case_INTERNAL_loop(tc, Haystack, needle_fc, index, H_graphs, n_fc_graphs);
-        if (H_expansion >= 0)
-            return H_graphs + H_expansion - index >= n_fc_graphs  ? (MVMint64)index : -1;
+
+    /* Case folding can change the number of graphemes, so we can't use the
+     * shift tables of index_bmh; we do use its random access to the Haystack
+     * and flat needle, so each step costs no more than a compare. */
+    seeker_init(tc, &H_seeker, Haystack);
+    n_fc = flat_graphemes(tc, needle_fc, n_fc_graphs);
+    while (index < H_graphs) {
+        H_expansion = string_equal_at_ignore_case_INTERNAL_loop(tc, &H_seeker, n_fc, index, H_graphs, n_fc_graphs);
+        if (H_expansion >= 0) {
+            if (H_graphs + H_expansion - index >= n_fc_graphs)
+                return_val = (MVMint64)index;
+            break;
+        }
         index++;
     }
-    return -1;
+    MVM_free(n_fc);
+    return return_val;
 }
 MVMGrapheme32 MVM_string_ord_at(MVMThreadContext *tc, MVMString *s, MVMint64 offset) {
     MVMStringIndex agraphs;
@@ -1036,6 +1195,150 @@ MVMString * MVM_string_decode(MVMThreadContext *tc,
     }
 }
 
+/* Finds the length of the run of bytes below 0x80 at the start of a buffer;
+ * for 8-bit grapheme storage, that is the run with no synthetics. We look at
+ * 16 bytes at a time with SSE2 where we have it, or at 8 bytes at a time
+ * otherwise, and then find the exact end of the run byte by byte. */
+size_t MVM_string_ascii_run_length(const MVMuint8 *bytes, size_t length) {
+    size_t i = 0;
+#ifdef MVM_STRING_SSE2
+    while (i + 16 <= length) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(bytes + i));
+        if (_mm_movemask_epi8(chunk))
+            break;
+        i += 16;
+    }
+#else
+    while (i + 8 <= length) {
+        MVMuint64 chunk;
+        memcpy(&chunk, bytes + i, sizeof(MVMuint64));
+        if (chunk & 0x8080808080808080ULL)
+            break;
+        i += 8;
+    }
+#endif
+    while (i < length && bytes[i] < 0x80)
+        i++;
+    return i;
+}
+
+/* Narrows the run of graphemes in the ASCII range at the start of a 32-bit
+ * buffer into bytes, 16 at a time with SSE2 where we have it. Returns the
+ * length of the run. */
+size_t MVM_string_narrow_ascii_run(const MVMGrapheme32 *graphemes, MVMuint8 *out, size_t length) {
+    size_t i = 0;
+#ifdef MVM_STRING_SSE2
+    const __m128i not_ascii = _mm_set1_epi32(~0x7F);
+    while (i + 16 <= length) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(graphemes + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(graphemes + i + 4));
+        __m128i c = _mm_loadu_si128((const __m128i *)(graphemes + i + 8));
+        __m128i d = _mm_loadu_si128((const __m128i *)(graphemes + i + 12));
+        __m128i all = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        __m128i ok  = _mm_cmpeq_epi32(_mm_and_si128(all, not_ascii), _mm_setzero_si128());
+        if (_mm_movemask_epi8(ok) != 0xFFFF)
+            break;
+        _mm_storeu_si128((__m128i *)(out + i),
+            _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+        i += 16;
+    }
+#endif
+    while (i < length && (MVMuint32)graphemes[i] < 0x80) {
+        out[i] = (MVMuint8)graphemes[i];
+        i++;
+    }
+    return i;
+}
+
+/* Encodes a whole string to an encoding in which the codepoints up to max_cp
+ * are each a byte of the same value (ASCII, Latin-1, and the ASCII part of
+ * others). We go over the storage strand by strand, working out the size of
+ * the result up front, so that 8-bit storage can just be copied. Returns NULL
+ * if the string holds anything else (synthetics, or codepoints beyond max_cp
+ * that need a replacement or an error), leaving the caller to take the slow
+ * path. The result is NULL terminated, but the size is the non-null part. */
+char * MVM_string_encode_bulk_single_byte(MVMThreadContext *tc, MVMString *str,
+        MVMuint64 *output_size, MVMCodepoint max_cp, MVMint32 translate_newlines) {
+    MVMStringStrand  single;
+    MVMStringStrand *strands;
+    MVMuint16        num_strands = MVM_string_flat_strands(tc, str, &single, &strands);
+    MVMuint8        *result;
+    size_t           size = 0, pos = 0;
+    MVMuint16        i;
+
+    /* Work out the size, bailing out on anything we can't simply copy. */
+    for (i = 0; i < num_strands; i++) {
+        MVMString *blob   = strands[i].blob_string;
+        size_t     length = strands[i].end - strands[i].start;
+        size_t     extra  = 0, j;
+        switch (blob->body.storage_type) {
+        case MVM_STRING_GRAPHEME_ASCII:
+        case MVM_STRING_GRAPHEME_8: {
+            const MVMuint8 *bytes = (const MVMuint8 *)blob->body.storage.blob_8 + strands[i].start;
+            if (MVM_string_ascii_run_length(bytes, length) != length)
+                return NULL;
+            if (translate_newlines)
+                for (j = 0; j < length; j++)
+                    extra += bytes[j] == '\n';
+            break;
+        }
+        case MVM_STRING_GRAPHEME_32: {
+            const MVMGrapheme32 *graphemes = blob->body.storage.blob_32 + strands[i].start;
+            for (j = 0; j < length; j++) {
+                if (graphemes[j] < 0 || graphemes[j] > max_cp)
+                    return NULL;
+                if (translate_newlines)
+                    extra += graphemes[j] == '\n';
+            }
+            break;
+        }
+        default:
+            return NULL;
+        }
+        size += (length + extra) * (strands[i].repetitions + 1);
+    }
+
+    /* Encode each strand once, then copy that for any repetitions. */
+    result = MVM_malloc(size + 1);
+    for (i = 0; i < num_strands; i++) {
+        MVMString *blob   = strands[i].blob_string;
+        size_t     length = strands[i].end - strands[i].start;
+        size_t     first  = pos, encoded, j;
+        MVMuint32  r;
+        if (blob->body.storage_type == MVM_STRING_GRAPHEME_32) {
+            const MVMGrapheme32 *graphemes = blob->body.storage.blob_32 + strands[i].start;
+            j = translate_newlines ? 0 : MVM_string_narrow_ascii_run(graphemes, result + pos, length);
+            pos += j;
+            for (; j < length; j++) {
+                if (translate_newlines && graphemes[j] == '\n')
+                    result[pos++] = '\r';
+                result[pos++] = (MVMuint8)graphemes[j];
+            }
+        }
+        else if (translate_newlines) {
+            const MVMuint8 *bytes = (const MVMuint8 *)blob->body.storage.blob_8 + strands[i].start;
+            for (j = 0; j < length; j++) {
+                if (bytes[j] == '\n')
+                    result[pos++] = '\r';
+                result[pos++] = bytes[j];
+            }
+        }
+        else if (length) {
+            memcpy(result + pos, blob->body.storage.blob_8 + strands[i].start, length);
+            pos += length;
+        }
+        encoded = pos - first;
+        for (r = 0; r < strands[i].repetitions; r++) {
+            memcpy(result + pos, result + first, encoded);
+            pos += encoded;
+        }
+    }
+    result[pos] = 0;
+    if (output_size)
+        *output_size = pos;
+    return (char *)result;
+}
+
 /* Encodes an MVMString to a C buffer, dependent on the encoding type flag */
 char * MVM_string_encode(MVMThreadContext *tc, MVMString *s, MVMint64 start,
         MVMint64 length, MVMuint64 *output_size, MVMint64 encoding_flag,
@@ -1099,10 +1402,8 @@ void MVM_string_encode_to_buf(MVMThreadContext *tc, MVMString *s, MVMString *enc
     });
 
     /* Stash the encoded data in the VMArray. */
-    ((MVMArray *)buf)->body.slots.i8 = (MVMint8 *)encoded;
-    ((MVMArray *)buf)->body.start    = 0;
-    ((MVMArray *)buf)->body.ssize    = output_size / elem_size;
-    ((MVMArray *)buf)->body.elems    = output_size / elem_size;
+    MVM_array_set_malloced_slots(tc, buf, encoded, output_size / elem_size,
+        output_size / elem_size);
 }
 
 /* Decodes a string using the data from the specified Buf. */
@@ -1188,12 +1489,45 @@ MVMObject * MVM_string_split(MVMThreadContext *tc, MVMString *separator, MVMStri
     return result;
 }
 
+/* Copies the graphemes of a string into the flat string being built by a
+ * join, at the specified position. If the result has 8 bit storage, then so
+ * must the string. Returns the position after the copied graphemes. */
+static MVMint64 join_append(MVMThreadContext *tc, MVMString *result, MVMint64 position,
+                            MVMString *s, MVMint64 graphs) {
+    MVMGraphemeIter gi;
+    MVMint64        i;
+    if (result->body.storage_type == MVM_STRING_GRAPHEME_8) {
+        memcpy(result->body.storage.blob_8 + position, s->body.storage.blob_8, graphs);
+        return position + graphs;
+    }
+    switch (s->body.storage_type) {
+    case MVM_STRING_GRAPHEME_32:
+        memcpy(
+            result->body.storage.blob_32 + position,
+            s->body.storage.blob_32,
+            graphs * sizeof(MVMGrapheme32));
+        break;
+    case MVM_STRING_GRAPHEME_ASCII:
+    case MVM_STRING_GRAPHEME_8:
+        for (i = 0; i < graphs; i++)
+            result->body.storage.blob_32[position + i] = s->body.storage.blob_8[i];
+        break;
+    default:
+        MVM_string_gi_init(tc, &gi, s);
+        for (i = 0; i < graphs; i++)
+            result->body.storage.blob_32[position + i] = MVM_string_gi_get_grapheme(tc, &gi);
+        break;
+    }
+    return position + graphs;
+}
+
 MVMString * MVM_string_join(MVMThreadContext *tc, MVMString *separator, MVMObject *input) {
     MVMString  *result;
     MVMString **pieces;
     MVMint64    elems, num_pieces, sgraphs, i, is_str_array, total_graphs;
     MVMuint16   sstrands, total_strands;
     MVMint32    concats_stable = 1;
+    MVMint32    all_8bit;
 
     MVM_string_check_arg(tc, separator, "join separator");
     if (!IS_CONCRETE(input))
@@ -1224,6 +1558,7 @@ MVMString * MVM_string_join(MVMThreadContext *tc, MVMString *separator, MVMObjec
             : 1;
     else
         sstrands = 1;
+    all_8bit      = !sgraphs || separator->body.storage_type == MVM_STRING_GRAPHEME_8;
     pieces        = MVM_malloc(elems * sizeof(MVMString *));
     num_pieces    = 0;
     total_graphs  = 0;
@@ -1257,6 +1592,8 @@ MVMString * MVM_string_join(MVMThreadContext *tc, MVMString *separator, MVMObjec
                 ? piece->body.num_strands
                 : 1;
             total_graphs += piece_graphs;
+            if (piece->body.storage_type != MVM_STRING_GRAPHEME_8)
+                all_8bit = 0;
         }
 
         /* Store piece. */
@@ -1277,11 +1614,17 @@ MVMString * MVM_string_join(MVMThreadContext *tc, MVMString *separator, MVMObjec
     }
     /*else {*/
     if (1) {
-        /* We'll produce a single, flat string. */
-        MVMint64        position = 0;
-        MVMGraphemeIter gi;
-        result->body.storage_type    = MVM_STRING_GRAPHEME_32;
-        result->body.storage.blob_32 = MVM_malloc(total_graphs * sizeof(MVMGrapheme32));
+        /* We'll produce a single, flat string; if all of the pieces and the
+         * separator have 8 bit storage, so can the result. */
+        MVMint64 position = 0;
+        if (all_8bit) {
+            result->body.storage_type    = MVM_STRING_GRAPHEME_8;
+            result->body.storage.blob_8  = MVM_malloc(total_graphs * sizeof(MVMGrapheme8));
+        }
+        else {
+            result->body.storage_type    = MVM_STRING_GRAPHEME_32;
+            result->body.storage.blob_32 = MVM_malloc(total_graphs * sizeof(MVMGrapheme32));
+        }
         for (i = 0; i < num_pieces; i++) {
             /* Get piece. */
             MVMString *piece = pieces[i];
@@ -1304,22 +1647,7 @@ MVMString * MVM_string_join(MVMThreadContext *tc, MVMString *separator, MVMObjec
                     else if (!MVM_nfg_is_concat_stable(tc, separator, piece))
                         concats_stable = 0;
 
-                    switch (separator->body.storage_type) {
-                    case MVM_STRING_GRAPHEME_32:
-                        memcpy(
-                            result->body.storage.blob_32 + position,
-                            separator->body.storage.blob_32,
-                            sgraphs * sizeof(MVMGrapheme32));
-                        position += sgraphs;
-                        break;
-                    /* XXX Can special-case 8-bit NFG and ASCII here too. */
-                    default:
-                        MVM_string_gi_init(tc, &gi, separator);
-                        while (MVM_string_gi_has_more(tc, &gi))
-                            result->body.storage.blob_32[position++] =
-                                MVM_string_gi_get_grapheme(tc, &gi);
-                        break;
-                    }
+                    position = join_append(tc, result, position, separator, sgraphs);
                 }
                 else {
                     /* Separator has no graphemes, so NFG stability check
@@ -1332,24 +1660,8 @@ MVMString * MVM_string_join(MVMThreadContext *tc, MVMString *separator, MVMObjec
             }
 
             /* Add piece. */
-            switch (piece->body.storage_type) {
-            case MVM_STRING_GRAPHEME_32: {
-                MVMint64 pgraphs = MVM_string_graphs(tc, piece);
-                memcpy(
-                    result->body.storage.blob_32 + position,
-                    piece->body.storage.blob_32,
-                    pgraphs * sizeof(MVMGrapheme32));
-                position += pgraphs;
-                break;
-            }
-            /* XXX Can special-case 8-bit NFG and ASCII here too. */
-            default:
-                MVM_string_gi_init(tc, &gi, piece);
-                while (MVM_string_gi_has_more(tc, &gi))
-                    result->body.storage.blob_32[position++] =
-                        MVM_string_gi_get_grapheme(tc, &gi);
-                break;
-            }
+            position = join_append(tc, result, position, piece,
+                MVM_string_graphs(tc, piece));
         }
     }
 
@@ -2044,70 +2356,104 @@ MVMString * MVM_string_chr(MVMThreadContext *tc, MVMCodepoint cp) {
     return s;
 }
 
+/* SipHash-1-3 state and steps, for hashing strings. */
+typedef struct {
+    MVMuint64 v0, v1, v2, v3;
+} MVMSipHashState;
+MVM_STATIC_INLINE MVMuint64 sip_rotl(MVMuint64 x, int b) {
+    return (x << b) | (x >> (64 - b));
+}
+MVM_STATIC_INLINE void sip_round(MVMSipHashState *st) {
+    st->v0 += st->v1; st->v1 = sip_rotl(st->v1, 13); st->v1 ^= st->v0; st->v0 = sip_rotl(st->v0, 32);
+    st->v2 += st->v3; st->v3 = sip_rotl(st->v3, 16); st->v3 ^= st->v2;
+    st->v0 += st->v3; st->v3 = sip_rotl(st->v3, 21); st->v3 ^= st->v0;
+    st->v2 += st->v1; st->v1 = sip_rotl(st->v1, 17); st->v1 ^= st->v2; st->v2 = sip_rotl(st->v2, 32);
+}
+MVM_STATIC_INLINE void sip_word(MVMSipHashState *st, MVMuint64 m) {
+    st->v3 ^= m;
+    sip_round(st);
+    st->v0 ^= m;
+}
+MVM_STATIC_INLINE MVMuint64 sip_pair(MVMGrapheme32 a, MVMGrapheme32 b) {
+    return (MVMuint64)(MVMuint32)a | ((MVMuint64)(MVMuint32)b << 32);
+}
+
 /* Takes a string and computes a hash code for it, storing it in the hash code
- * cache field of the string. Hashing code is derived from the Jenkins hash
- * implementation in uthash.h. */
-typedef union {
-    MVMint32 graphs[3];
-    unsigned char bytes[12];
-} MVMJenHashGraphemeView;
+ * cache field of the string. We use SipHash-1-3, keyed at random for each
+ * process so that collisions can't be planned in advance. To hash the same
+ * whatever the storage of the string, the input is its graphemes as 32-bit
+ * values, two to a 64-bit word; we read them straight from the storage, a
+ * strand at a time, carrying an odd grapheme over to the next strand. */
 void MVM_string_compute_hash_code(MVMThreadContext *tc, MVMString *s) {
-    /* The hash algorithm works in bytes. Since we can represent strings in a
-     * number of ways, and we want consistent hashing, then we'll read the
-     * strings using the grapheme iterator in groups of 3, using 32-bit ints
-     * for the graphemes no matter what the string really holds them as. Then
-     * we'll use the bytes view of that in the hashing function. */
-    MVMJenHashGraphemeView hash_block;
-    MVMGraphemeIter gi;
-    MVMuint32 graphs_remaining = MVM_string_graphs(tc, s);
-
-    /* Initialize hash state. */
-    MVMuint32 hashv = 0xfeedbeef;
-    MVMuint32 _hj_i, _hj_j;
-    _hj_i = _hj_j = 0x9e3779b9;
+    MVMuint64        k0 = tc->instance->string_hash_key[0];
+    MVMuint64        k1 = tc->instance->string_hash_key[1];
+    MVMSipHashState  st;
+    MVMStringStrand  single;
+    MVMStringStrand *strands;
+    MVMuint16        num_strands = MVM_string_flat_strands(tc, s, &single, &strands);
+    MVMuint64        graphs      = MVM_string_graphs(tc, s);
+    MVMGrapheme32    pending     = 0;
+    MVMint32         has_pending = 0;
+    MVMuint64        hash;
+    MVMuint16        i;
+
+    st.v0 = k0 ^ 0x736f6d6570736575ULL;
+    st.v1 = k1 ^ 0x646f72616e646f6dULL;
+    st.v2 = k0 ^ 0x6c7967656e657261ULL;
+    st.v3 = k1 ^ 0x7465646279746573ULL;
+
+    for (i = 0; i < num_strands; i++) {
+        MVMString     *blob   = strands[i].blob_string;
+        MVMStringIndex start  = strands[i].start;
+        MVMStringIndex length = strands[i].end - start;
+        MVMuint32      r;
+        if (!length)
+            continue;
+        for (r = 0; r <= strands[i].repetitions; r++) {
+            MVMStringIndex j = 0;
+            if (blob->body.storage_type == MVM_STRING_GRAPHEME_32) {
+                const MVMGrapheme32 *g = blob->body.storage.blob_32 + start;
+                if (has_pending) {
+                    sip_word(&st, sip_pair(pending, g[0]));
+                    has_pending = 0;
+                    j = 1;
+                }
+                for (; j + 1 < length; j += 2)
+                    sip_word(&st, sip_pair(g[j], g[j + 1]));
+                if (j < length) {
+                    pending     = g[j];
+                    has_pending = 1;
+                }
+            }
+            else {
+                const MVMGrapheme8 *g = blob->body.storage.blob_8 + start;
+                if (has_pending) {
+                    sip_word(&st, sip_pair(pending, g[0]));
+                    has_pending = 0;
+                    j = 1;
+                }
+                for (; j + 1 < length; j += 2)
+                    sip_word(&st, sip_pair(g[j], g[j + 1]));
+                if (j < length) {
+                    pending     = g[j];
+                    has_pending = 1;
+                }
+            }
+        }
+    }
 
-    /* Work through the string 3 graphemes at a time. */
-    MVM_string_gi_init(tc, &gi, s);
-    while (graphs_remaining >= 3) {
-        hash_block.graphs[0] = MVM_string_gi_get_grapheme(tc, &gi);
-        hash_block.graphs[1] = MVM_string_gi_get_grapheme(tc, &gi);
-        hash_block.graphs[2] = MVM_string_gi_get_grapheme(tc, &gi);
-        _hj_i += (hash_block.bytes[0] + ( (unsigned)hash_block.bytes[1] << 8 )
-            + ( (unsigned)hash_block.bytes[2] << 16 )
-            + ( (unsigned)hash_block.bytes[3] << 24 ) );
-        _hj_j +=    (hash_block.bytes[4] + ( (unsigned)hash_block.bytes[5] << 8 )
-            + ( (unsigned)hash_block.bytes[6] << 16 )
-            + ( (unsigned)hash_block.bytes[7] << 24 ) );
-        hashv += (hash_block.bytes[8] + ( (unsigned)hash_block.bytes[9] << 8 )
-            + ( (unsigned)hash_block.bytes[10] << 16 )
-            + ( (unsigned)hash_block.bytes[11] << 24 ) );
-
-        HASH_JEN_MIX(_hj_i, _hj_j, hashv);
-
-        graphs_remaining -= 3;
-    }
-
-    /* Mix in key length (in bytes, not graphemes). */
-    hashv += MVM_string_graphs(tc, s) * sizeof(MVMGrapheme32);
-
-    /* Now handle trailing graphemes (must be 2, 1, or 0). */
-    switch (graphs_remaining) {
-        case 2:
-            hash_block.graphs[1] = MVM_string_gi_get_grapheme(tc, &gi);
-            _hj_j += ( (unsigned)hash_block.bytes[7] << 24 ) +
-                     ( (unsigned)hash_block.bytes[6] << 16 ) +
-                     ( (unsigned)hash_block.bytes[5] << 8 ) +
-                     hash_block.bytes[4];
-        /* Fallthrough */
-        case 1:
-            hash_block.graphs[0] = MVM_string_gi_get_grapheme(tc, &gi);
-            _hj_i += ( (unsigned)hash_block.bytes[3] << 24 ) +
-                     ( (unsigned)hash_block.bytes[2] << 16 ) +
-                     ( (unsigned)hash_block.bytes[1] << 8 ) +
-                     hash_block.bytes[0];
-    }
-    HASH_JEN_MIX(_hj_i, _hj_j, hashv);
-
-    /* Store computed hash value. */
-    s->body.cached_hash_code = hashv;
+    /* The last word holds the length in bytes and any odd grapheme. */
+    sip_word(&st, ((graphs * sizeof(MVMGrapheme32)) << 56)
+        | (has_pending ? (MVMuint64)(MVMuint32)pending : 0));
+    st.v2 ^= 0xFF;
+    sip_round(&st);
+    sip_round(&st);
+    sip_round(&st);
+    hash = st.v0 ^ st.v1 ^ st.v2 ^ st.v3;
+
+    /* Store computed hash value; zero means "not computed yet", so avoid
+     * it. */
+    s->body.cached_hash_code = (MVMint32)(hash ^ (hash >> 32));
+    if (!s->body.cached_hash_code)
+        s->body.cached_hash_code = 1;
 }
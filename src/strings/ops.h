@@ -70,6 +70,9 @@ MVMString * MVM_string_tc(MVMThreadContext *tc, MVMString *s);
 MVMString * MVM_string_fc(MVMThreadContext *tc, MVMString *s);
 MVMString * MVM_string_decode(MVMThreadContext *tc, const MVMObject *type_object, char *Cbuf, MVMint64 byte_length, MVMint64 encoding_flag);
 char * MVM_string_encode(MVMThreadContext *tc, MVMString *s, MVMint64 start, MVMint64 length, MVMuint64 *output_size, MVMint64 encoding_flag, MVMString *replacement, MVMint32 translate_newlines);
+size_t MVM_string_ascii_run_length(const MVMuint8 *bytes, size_t length);
+size_t MVM_string_narrow_ascii_run(const MVMGrapheme32 *graphemes, MVMuint8 *out, size_t length);
+char * MVM_string_encode_bulk_single_byte(MVMThreadContext *tc, MVMString *str, MVMuint64 *output_size, MVMCodepoint max_cp, MVMint32 translate_newlines);
 void MVM_string_encode_to_buf(MVMThreadContext *tc, MVMString *s, MVMString *enc_name, MVMObject *buf, MVMString *replacement);
 MVMString * MVM_string_decode_from_buf(MVMThreadContext *tc, MVMObject *buf, MVMString *enc_name);
 MVMObject * MVM_string_split(MVMThreadContext *tc, MVMString *separator, MVMString *input);
@@ -95,4 +98,5 @@ MVMint64 MVM_string_find_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMString
 MVMint64 MVM_string_find_not_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMString *s, MVMint64 offset, MVMint64 count);
 MVMuint8 MVM_string_find_encoding(MVMThreadContext *tc, MVMString *name);
 MVMString * MVM_string_chr(MVMThreadContext *tc, MVMCodepoint cp);
+void MVM_string_shrink_to_8bit(MVMThreadContext *tc, MVMString *str);
 void MVM_string_compute_hash_code(MVMThreadContext *tc, MVMString *s);
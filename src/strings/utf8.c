@@ -168,6 +168,70 @@ static MVMint32 utf8_encode(MVMuint8 *bp, MVMCodepoint cp) {
 
 #define UTF8_MAXINC (32 * 1024 * 1024)
 
+/* Given a run of ASCII bytes that we want to turn into graphemes without
+ * going through the normalizer, works out how many of them are safe to take.
+ * Unless the run ends the input, its last byte may form a grapheme with what
+ * comes after it, so is left alone, as is a \r that would then be at the end
+ * of the run. */
+static size_t ascii_run_safe_length(const MVMuint8 *bytes, size_t run, MVMint32 ends_input) {
+    if (!ends_input && run > 0) {
+        run--;
+        if (run > 0 && bytes[run - 1] == '\r')
+            run--;
+    }
+    return run;
+}
+
+/* Turns a run of ASCII bytes that are known to be complete graphemes into
+ * graphemes, with \r\n becoming a single grapheme (or \n, if translating
+ * newlines). Returns the number of graphemes written. */
+static size_t ascii_run_to_graphemes(MVMThreadContext *tc, MVMGrapheme32 *out,
+        const MVMuint8 *bytes, size_t run, MVMint32 translate_newlines) {
+    size_t i, count = 0;
+    for (i = 0; i < run; i++) {
+        if (bytes[i] == '\r' && i + 1 < run && bytes[i + 1] == '\n') {
+            out[count++] = translate_newlines ? '\n' : MVM_nfg_crlf_grapheme(tc);
+            i++;
+        }
+        else {
+            out[count++] = bytes[i];
+        }
+    }
+    return count;
+}
+
+/* Decodes input that is entirely ASCII straight into 8-bit storage. Returns
+ * zero if it can't, which happens only if the \r\n synthetic doesn't fit. */
+static MVMint32 decode_all_ascii(MVMThreadContext *tc, MVMString *result, const MVMuint8 *bytes, size_t length) {
+    MVMGrapheme8 *blob;
+    size_t        i, count;
+    if (!memchr(bytes, '\r', length)) {
+        blob = MVM_malloc(length);
+        memcpy(blob, bytes, length);
+        count = length;
+    }
+    else {
+        MVMGrapheme32 crlf = MVM_nfg_crlf_grapheme(tc);
+        if (crlf < -128)
+            return 0;
+        blob  = MVM_malloc(length);
+        count = 0;
+        for (i = 0; i < length; i++) {
+            if (bytes[i] == '\r' && i + 1 < length && bytes[i + 1] == '\n') {
+                blob[count++] = crlf;
+                i++;
+            }
+            else {
+                blob[count++] = bytes[i];
+            }
+        }
+    }
+    result->body.storage.blob_8 = blob;
+    result->body.storage_type   = MVM_STRING_GRAPHEME_8;
+    result->body.num_graphs     = count;
+    return 1;
+}
+
 /* Decodes the specified number of bytes of utf8 into an NFG string, creating
  * a result of the specified type. The type must have the MVMString REPR. */
 MVMString * MVM_string_utf8_decode(MVMThreadContext *tc, const MVMObject *result_type, const char *utf8, size_t bytes) {
@@ -179,21 +243,52 @@ MVMString * MVM_string_utf8_decode(MVMThreadContext *tc, const MVMObject *result
     MVMint32 bufsize = bytes;
     MVMGrapheme32 lowest_graph  =  0x7fffffff;
     MVMGrapheme32 highest_graph = -0x7fffffff;
-    MVMGrapheme32 *buffer = MVM_malloc(sizeof(MVMGrapheme32) * bufsize);
+    MVMGrapheme32 *buffer;
     size_t orig_bytes;
     const char *orig_utf8;
     MVMint32 line;
     MVMint32 col;
     MVMint32 ready;
-
-    /* Need to normalize to NFG as we decode. */
     MVMNormalizer norm;
+
+    /* Much of what we decode is entirely ASCII, and so needs neither the
+     * DFA nor the normalizer. */
+    if (MVM_string_ascii_run_length((const MVMuint8 *)utf8, bytes) == bytes &&
+            decode_all_ascii(tc, result, (const MVMuint8 *)utf8, bytes))
+        return result;
+
+    /* Otherwise, need to normalize to NFG as we decode. */
+    buffer = MVM_malloc(sizeof(MVMGrapheme32) * bufsize);
     MVM_unicode_normalizer_init(tc, &norm, MVM_NORMALIZE_NFG);
 
     orig_bytes = bytes;
     orig_utf8 = utf8;
 
     for (; bytes; ++utf8, --bytes) {
+        /* When between codepoints with nothing held by the normalizer, take
+         * any run of ASCII that can't combine with what follows as it is. */
+        if (state == UTF8_ACCEPT && (MVMuint8)*utf8 < 0x80 && MVM_unicode_normalizer_empty(tc, &norm)) {
+            size_t run = MVM_string_ascii_run_length((const MVMuint8 *)utf8, bytes);
+            run = ascii_run_safe_length((const MVMuint8 *)utf8, run, run == bytes);
+            if (run > 0) {
+                while (count + (MVMint64)run >= bufsize) {
+                    buffer = MVM_realloc(buffer, sizeof(MVMGrapheme32) * (
+                        bufsize >= UTF8_MAXINC ? (bufsize += UTF8_MAXINC) : (bufsize *= 2)
+                    ));
+                }
+                count += ascii_run_to_graphemes(tc, buffer + count, (const MVMuint8 *)utf8, run, 0);
+                if (memchr(utf8, '\r', run)) {
+                    MVMGrapheme32 crlf = MVM_nfg_crlf_grapheme(tc);
+                    lowest_graph = crlf < lowest_graph ? crlf : lowest_graph;
+                }
+                lowest_graph = 0 < lowest_graph ? 0 : lowest_graph;
+                highest_graph = 127 > highest_graph ? 127 : highest_graph;
+                utf8  += run;
+                bytes -= run;
+                if (!bytes)
+                    break;
+            }
+        }
         switch(decode_utf8_byte(&state, &codepoint, (MVMuint8)*utf8)) {
         case UTF8_ACCEPT: { /* got a codepoint */
             MVMGrapheme32 g;
@@ -364,6 +459,40 @@ MVMuint32 MVM_string_utf8_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds
             at_start = 0;
         }
         while (pos < cur_bytes->length) {
+            /* As in MVM_string_utf8_decode, take runs of ASCII as they are
+             * when the normalizer holds nothing. */
+            if (state == UTF8_ACCEPT && (MVMuint8)bytes[pos] < 0x80 && MVM_unicode_normalizer_empty(tc, &(ds->norm))) {
+                const MVMuint8 *run_bytes = (const MVMuint8 *)bytes + pos;
+                MVMint32 remaining = cur_bytes->length - pos;
+                MVMint32 run = ascii_run_safe_length(run_bytes,
+                    MVM_string_ascii_run_length(run_bytes, remaining), 0);
+                MVMint32 i;
+                for (i = 0; i < run; i++) {
+                    MVMGrapheme32 g = run_bytes[i];
+                    if (g == '\r' && i + 1 < run && run_bytes[i + 1] == '\n') {
+                        g = ds->norm.translate_newlines ? '\n' : MVM_nfg_crlf_grapheme(tc);
+                        i++;
+                    }
+                    if (count == bufsize) {
+                        MVM_string_decodestream_add_chars(tc, ds, buffer, bufsize);
+                        buffer = MVM_malloc(bufsize * sizeof(MVMGrapheme32));
+                        count = 0;
+                    }
+                    buffer[count++] = g;
+                    total++;
+                    last_accept_bytes = cur_bytes;
+                    last_accept_pos = pos + i + 1;
+                    if (stopper_chars && *stopper_chars == total) {
+                        reached_stopper = 1;
+                        goto done;
+                    }
+                    if (MVM_string_decode_stream_maybe_sep(tc, seps, g)) {
+                        reached_stopper = 1;
+                        goto done;
+                    }
+                }
+                pos += run;
+            }
             switch(decode_utf8_byte(&state, &codepoint, bytes[pos++])) {
             case UTF8_ACCEPT: {
                 MVMint32 first = 1;
@@ -419,6 +548,110 @@ MVMuint32 MVM_string_utf8_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds
     return reached_stopper;
 }
 
+/* Encodes a whole string to UTF-8, going over its storage strand by strand
+ * and working out the size of the result up front. Runs of ASCII are copied,
+ * or narrowed from 32-bit storage. Returns NULL if the string holds any
+ * synthetics or anything that can't be encoded, leaving the caller to take
+ * the slow path, which deals with those. */
+static char * utf8_encode_bulk(MVMThreadContext *tc, MVMString *str, MVMuint64 *output_size,
+        MVMint32 translate_newlines) {
+    MVMStringStrand  single;
+    MVMStringStrand *strands;
+    MVMuint16        num_strands = MVM_string_flat_strands(tc, str, &single, &strands);
+    MVMuint8        *result;
+    size_t           size = 0, pos = 0;
+    MVMuint16        i;
+
+    /* Work out the size, bailing out on anything needing the slow path. */
+    for (i = 0; i < num_strands; i++) {
+        MVMString *blob   = strands[i].blob_string;
+        size_t     length = strands[i].end - strands[i].start;
+        size_t     bytes  = 0, j;
+        switch (blob->body.storage_type) {
+        case MVM_STRING_GRAPHEME_ASCII:
+        case MVM_STRING_GRAPHEME_8: {
+            const MVMuint8 *ascii = (const MVMuint8 *)blob->body.storage.blob_8 + strands[i].start;
+            if (MVM_string_ascii_run_length(ascii, length) != length)
+                return NULL;
+            bytes = length;
+            if (translate_newlines)
+                for (j = 0; j < length; j++)
+                    bytes += ascii[j] == '\n';
+            break;
+        }
+        case MVM_STRING_GRAPHEME_32: {
+            const MVMGrapheme32 *graphemes = blob->body.storage.blob_32 + strands[i].start;
+            for (j = 0; j < length; j++) {
+                MVMGrapheme32 g = graphemes[j];
+                if (g < 0)
+                    return NULL;
+                else if (g < 0x80)
+                    bytes += translate_newlines && g == '\n' ? 2 : 1;
+                else if (g < 0x800)
+                    bytes += 2;
+                else if (g < 0x10000 && (g < 0xD800 || g > 0xDFFF))
+                    bytes += 3;
+                else if (g >= 0x10000 && g <= 0x10FFFF)
+                    bytes += 4;
+                else
+                    return NULL;
+            }
+            break;
+        }
+        default:
+            return NULL;
+        }
+        size += bytes * (strands[i].repetitions + 1);
+    }
+
+    /* Encode each strand once, then copy that for any repetitions. */
+    result = MVM_malloc(size + 1);
+    for (i = 0; i < num_strands; i++) {
+        MVMString *blob   = strands[i].blob_string;
+        size_t     length = strands[i].end - strands[i].start;
+        size_t     first  = pos, encoded, j;
+        MVMuint32  r;
+        if (blob->body.storage_type == MVM_STRING_GRAPHEME_32) {
+            const MVMGrapheme32 *graphemes = blob->body.storage.blob_32 + strands[i].start;
+            j = 0;
+            while (j < length) {
+                if (!translate_newlines) {
+                    size_t run = MVM_string_narrow_ascii_run(graphemes + j, result + pos, length - j);
+                    j   += run;
+                    pos += run;
+                    if (j == length)
+                        break;
+                }
+                else if (graphemes[j] == '\n') {
+                    result[pos++] = '\r';
+                }
+                pos += utf8_encode(result + pos, graphemes[j++]);
+            }
+        }
+        else if (translate_newlines) {
+            const MVMuint8 *ascii = (const MVMuint8 *)blob->body.storage.blob_8 + strands[i].start;
+            for (j = 0; j < length; j++) {
+                if (ascii[j] == '\n')
+                    result[pos++] = '\r';
+                result[pos++] = ascii[j];
+            }
+        }
+        else if (length) {
+            memcpy(result + pos, blob->body.storage.blob_8 + strands[i].start, length);
+            pos += length;
+        }
+        encoded = pos - first;
+        for (r = 0; r < strands[i].repetitions; r++) {
+            memcpy(result + pos, result + first, encoded);
+            pos += encoded;
+        }
+    }
+
+    if (output_size)
+        *output_size = (MVMuint64)pos;
+    return (char *)result;
+}
+
 /* Encodes the specified string to UTF-8. */
 char * MVM_string_utf8_encode_substr(MVMThreadContext *tc,
         MVMString *str, MVMuint64 *output_size, MVMint64 start, MVMint64 length,
@@ -437,6 +670,13 @@ char * MVM_string_utf8_encode_substr(MVMThreadContext *tc,
     if (length < 0 || start + length > strgraphs)
         MVM_exception_throw_adhoc(tc, "length out of range");
 
+    /* Most strings can take the fast route. */
+    if (start == 0 && length == strgraphs) {
+        char *bulk = utf8_encode_bulk(tc, str, output_size, translate_newlines);
+        if (bulk)
+            return bulk;
+    }
+
     if (replacement)
         repl_bytes = (MVMuint8 *) MVM_string_utf8_encode_substr(tc,
             replacement, &repl_length, 0, -1, NULL, translate_newlines);
@@ -227,20 +227,40 @@ MVMString * MVM_string_windows1252_decode(MVMThreadContext *tc,
         const MVMObject *result_type, char *windows1252_c, size_t bytes) {
     MVMuint8 *windows1252 = (MVMuint8 *)windows1252_c;
     MVMString *result = (MVMString *)REPR(result_type)->allocate(tc, STABLE(result_type));
-    size_t i, result_graphs;
+    size_t i, k, result_graphs;
 
-    result->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    result->body.storage.blob_32 = MVM_malloc(sizeof(MVMGrapheme32) * bytes);
+    MVMuint8 writing_32bit = 0;
+
+    result->body.storage_type   = MVM_STRING_GRAPHEME_8;
+    result->body.storage.blob_8 = MVM_malloc(sizeof(MVMGrapheme8) * bytes);
 
     result_graphs = 0;
     for (i = 0; i < bytes; i++) {
+        MVMGrapheme32 g;
         if (windows1252[i] == '\r' && i + 1 < bytes && windows1252[i + 1] == '\n') {
-            result->body.storage.blob_32[result_graphs++] = MVM_nfg_crlf_grapheme(tc);
+            g = MVM_nfg_crlf_grapheme(tc);
             i++;
         }
         else {
-            result->body.storage.blob_32[result_graphs++] = WINDOWS1252_CHAR_TO_CP(windows1252[i]);
+            g = WINDOWS1252_CHAR_TO_CP(windows1252[i]);
         }
+
+        /* Switch to 32-bit storage at the first grapheme that won't fit. */
+        if ((g > 127 || g < -128) && !writing_32bit) {
+            MVMGrapheme8 *old_storage = result->body.storage.blob_8;
+
+            result->body.storage.blob_32 = MVM_malloc(sizeof(MVMGrapheme32) * bytes);
+            result->body.storage_type = MVM_STRING_GRAPHEME_32;
+            writing_32bit = 1;
+
+            for (k = 0; k < result_graphs; k++)
+                result->body.storage.blob_32[k] = old_storage[k];
+            MVM_free(old_storage);
+        }
+        if (writing_32bit)
+            result->body.storage.blob_32[result_graphs++] = g;
+        else
+            result->body.storage.blob_8[result_graphs++] = g;
     }
     result->body.num_graphs = result_graphs;
 
@@ -269,6 +289,15 @@ char * MVM_string_windows1252_encode_substr(MVMThreadContext *tc, MVMString *str
     if (length < -1 || start + lengthu > strgraphs)
         MVM_exception_throw_adhoc(tc, "length out of range");
 
+    /* If the whole string is in the ASCII range (which maps to itself), copy
+     * it over strand by strand. */
+    if (start == 0 && lengthu == strgraphs) {
+        char *bulk = MVM_string_encode_bulk_single_byte(tc, str, output_size,
+            127, translate_newlines);
+        if (bulk)
+            return bulk;
+    }
+
     if (replacement)
         repl_bytes = (MVMuint8 *) MVM_string_windows1252_encode_substr(tc,
             replacement, &repl_length, 0, -1, NULL, translate_newlines);
@@ -55,6 +55,8 @@ typedef struct MVMFrameHandler MVMFrameHandler;
 typedef struct MVMGen2Allocator MVMGen2Allocator;
 typedef struct MVMGen2SizeClass MVMGen2SizeClass;
 typedef struct MVMGCPassedWork MVMGCPassedWork;
+typedef struct MVMGCSweepPartition MVMGCSweepPartition;
+typedef struct MVMGCPauseStats MVMGCPauseStats;
 typedef struct MVMGCWorklist MVMGCWorklist;
 typedef struct MVMHash MVMHash;
 typedef struct MVMHashAttrStore MVMHashAttrStore;
@@ -128,7 +130,9 @@ typedef struct MVMConcBlockingQueueBody MVMConcBlockingQueueBody;
 typedef struct MVMConcBlockingQueueNode MVMConcBlockingQueueNode;
 typedef struct MVMConcBlockingQueueLocks MVMConcBlockingQueueLocks;
 typedef struct MVMObject MVMObject;
-typedef struct MVMObjectId MVMObjectId;
+typedef struct MVMObjectIdEntry MVMObjectIdEntry;
+typedef struct MVMObjectIdTable MVMObjectIdTable;
+typedef struct MVMObjectIdShard MVMObjectIdShard;
 typedef struct MVMObjectStooge MVMObjectStooge;
 typedef struct MVMOpInfo MVMOpInfo;
 typedef struct MVMOSHandle MVMOSHandle;
@@ -172,9 +176,21 @@ typedef struct MVMSpeshFacts MVMSpeshFacts;
 typedef struct MVMSpeshCode MVMSpeshCode;
 typedef struct MVMSpeshCandidate MVMSpeshCandidate;
 typedef struct MVMSpeshGuard MVMSpeshGuard;
+typedef struct MVMSpeshGuardTree MVMSpeshGuardTree;
+typedef struct MVMSpeshGuardTreeNode MVMSpeshGuardTreeNode;
 typedef struct MVMSpeshLogGuard MVMSpeshLogGuard;
 typedef struct MVMSpeshCallInfo MVMSpeshCallInfo;
 typedef struct MVMSpeshInline MVMSpeshInline;
+typedef struct MVMSpeshMaterialization MVMSpeshMaterialization;
+typedef struct MVMSpeshMaterializedAttr MVMSpeshMaterializedAttr;
+typedef struct MVMSpeshStats MVMSpeshStats;
+typedef struct MVMSpeshStatsByCallsite MVMSpeshStatsByCallsite;
+typedef struct MVMSpeshStatsByType MVMSpeshStatsByType;
+typedef struct MVMSpeshStatsType MVMSpeshStatsType;
+typedef struct MVMSpeshStatsByGuards MVMSpeshStatsByGuards;
+typedef struct MVMSpeshStatsLogSite MVMSpeshStatsLogSite;
+typedef struct MVMSpeshStatsTypeCount MVMSpeshStatsTypeCount;
+typedef struct MVMSpeshStatsValueCount MVMSpeshStatsValueCount;
 typedef struct MVMSTable MVMSTable;
 typedef struct MVMStaticFrame MVMStaticFrame;
 typedef struct MVMStaticFrameBody MVMStaticFrameBody;
@@ -236,6 +252,8 @@ typedef struct MVMProfileGC MVMProfileGC;
 typedef struct MVMProfileCallNode MVMProfileCallNode;
 typedef struct MVMProfileAllocationCount MVMProfileAllocationCount;
 typedef struct MVMProfileContinuationData MVMProfileContinuationData;
+typedef struct MVMAllocSample MVMAllocSample;
+typedef struct MVMCpuSampleNode MVMCpuSampleNode;
 typedef struct MVMHeapSnapshotCollection MVMHeapSnapshotCollection;
 typedef struct MVMHeapSnapshot MVMHeapSnapshot;
 typedef struct MVMHeapSnapshotType MVMHeapSnapshotType;